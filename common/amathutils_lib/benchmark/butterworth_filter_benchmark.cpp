@@ -0,0 +1,129 @@
+/*
+ * Copyright 2018-2019 Autoware Foundation. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Time per sample of ButterworthFilterN against one ButterworthFilter per
+// channel, sample by sample and over a whole log.
+//   rosrun amathutils_lib butterworth_filter_benchmark [samples]
+
+#include "amathutils_lib/butterworth_filter.hpp"
+#include "amathutils_lib/butterworth_filter_n.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+// best of several rounds, so a busy machine does not decide the result
+const int ROUNDS = 5;
+
+template <class F>
+double bestNsPerSample(int samples, F run)
+{
+  double best = 1e300;
+  for (int round = 0; round < ROUNDS; ++round)
+  {
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    run();
+    std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+    best = std::min(best, std::chrono::duration<double, std::nano>(t2 - t1).count() / samples);
+  }
+  return best;
+}
+
+ButterworthFilter makeFilter(int order)
+{
+  ButterworthFilter bf;
+  bf.setOrder(order);
+  bf.setCuttoffFrequency(5, 100);
+  bf.computeContinuousTimeTF(true);
+  bf.computeDiscreteTimeTF(true);
+  return bf;
+}
+
+// NC channels like steering, pedals and accelerations, filtered every cycle
+template <int NC>
+void compareOnline(int samples, int order)
+{
+  std::vector<ButterworthFilter> bf(NC, makeFilter(order));
+  std::vector<double> u(static_cast<size_t>(samples) * NC), y(u.size());
+  for (size_t i = 0; i < u.size(); ++i)
+  {
+    u[i] = std::sin(0.01 * i) + 0.1 * (std::rand() / static_cast<double>(RAND_MAX) - 0.5);
+  }
+
+  double scalar_ns = bestNsPerSample(samples, [&]() {
+    for (int i = 0; i < samples; ++i)
+    {
+      for (int c = 0; c < NC; ++c)
+      {
+        y[i * NC + c] = bf[c].filter(u[i * NC + c]);
+      }
+    }
+  });
+
+  ButterworthFilterN<NC> bf_n(bf[0].getSOS());
+  double lanes_ns = bestNsPerSample(samples, [&]() {
+    for (int i = 0; i < samples; ++i)
+    {
+      typedef typename ButterworthFilterN<NC>::Sample Sample;
+      Eigen::Map<Sample>(y.data() + i * NC) = bf_n.filter(Eigen::Map<const Sample>(u.data() + i * NC));
+    }
+  });
+
+  std::printf("online  order %d, %d channels: scalar %7.1f ns, lanes %7.1f ns, %5.1fx\n",
+              order, NC, scalar_ns, lanes_ns, scalar_ns / lanes_ns);
+}
+
+// one channel of a log, filtVector against filterBlock
+void compareOffline(int samples, int order)
+{
+  ButterworthFilter bf = makeFilter(order);
+  std::vector<double> u(samples), y(samples);
+  for (int i = 0; i < samples; ++i)
+  {
+    u[i] = std::sin(0.01 * i) + 0.1 * (std::rand() / static_cast<double>(RAND_MAX) - 0.5);
+  }
+
+  double vector_ns = bestNsPerSample(samples, [&]() { bf.filtVector(u, y, true); });
+
+  ButterworthFilterN<1> bf_n(bf.getSOS());
+  double block_ns = bestNsPerSample(samples, [&]() {
+    bf_n.reset(ButterworthFilterN<1>::Sample::Constant(u[0]));
+    bf_n.filterBlock(u.data(), y.data(), samples);
+  });
+
+  std::printf("offline order %d, 1 channel:  filtVector %7.1f ns, filterBlock %7.1f ns, %5.1fx\n",
+              order, vector_ns, block_ns, vector_ns / block_ns);
+}
+}  // namespace
+
+int main(int argc, char **argv)
+{
+  const int samples = (argc > 1) ? std::atoi(argv[1]) : 1000000;
+  srand(42);
+
+  compareOnline<2>(samples, 2);
+  compareOnline<4>(samples, 2);
+  compareOnline<4>(samples, 5);
+  compareOnline<8>(samples, 5);
+  compareOffline(samples, 2);
+  compareOffline(samples, 5);
+  return 0;
+}
@@ -0,0 +1,169 @@
+/*
+ * Copyright 2018-2019 Autoware Foundation. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Time per predict + update cycle of the fixed size filters against the
+// dynamic KalmanFilter / TimeDelayKalmanFilter on the same random model.
+//   rosrun amathutils_lib kalman_filter_benchmark [cycles]
+
+#include "amathutils_lib/kalman_filter.hpp"
+#include "amathutils_lib/kalman_filter_n.hpp"
+#include "amathutils_lib/time_delay_kalman_filter.hpp"
+#include "amathutils_lib/time_delay_kalman_filter_n.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+namespace
+{
+// best of several rounds, so a busy machine does not decide the result
+const int ROUNDS = 5;
+
+template <class F>
+double bestNsPerCycle(int cycles, F cycle)
+{
+  double best = 1e300;
+  for (int round = 0; round < ROUNDS; ++round)
+  {
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    for (int i = 0; i < cycles; ++i)
+    {
+      cycle(i);
+    }
+    std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+    best = std::min(best, std::chrono::duration<double, std::nano>(t2 - t1).count() / cycles);
+  }
+  return best;
+}
+
+template <int NX, int NY>
+void compareKalmanFilter(int cycles)
+{
+  typedef KalmanFilterN<NX, 1, NY> KFN;
+  typename KFN::StateMatrix A = KFN::StateMatrix::Identity() + 0.01 * KFN::StateMatrix::Random();
+  typename KFN::InputMatrix B = KFN::InputMatrix::Random();
+  typename KFN::OutputMatrix C = KFN::OutputMatrix::Random();
+  typename KFN::StateMatrix Q = 0.01 * KFN::StateMatrix::Identity();
+  typename KFN::OutputCovariance R = 0.1 * KFN::OutputCovariance::Identity();
+  typename KFN::StateVector x = KFN::StateVector::Zero();
+  typename KFN::StateMatrix P = KFN::StateMatrix::Identity();
+  typename KFN::InputVector u = KFN::InputVector::Constant(0.1);
+  typename KFN::OutputVector y = KFN::OutputVector::Constant(0.2);
+
+  KalmanFilter kf(x, A, B, C, Q, R, P);
+  const Eigen::MatrixXd u_dyn = u;
+  const Eigen::MatrixXd y_dyn = y;
+  double dynamic_ns = bestNsPerCycle(cycles, [&](int) {
+    kf.predict(u_dyn);
+    kf.update(y_dyn);
+  });
+
+  KFN kf_n(x, A, B, C, Q, R, P);
+  double fixed_ns = bestNsPerCycle(cycles, [&](int) {
+    kf_n.predict(u);
+    kf_n.update(y);
+  });
+
+  std::printf("KalmanFilter          nx %d ny %d:  dynamic %8.1f ns, fixed %8.1f ns, %5.1fx\n",
+              NX, NY, dynamic_ns, fixed_ns, dynamic_ns / fixed_ns);
+}
+
+template <int NX, int NY>
+void compareTimeDelayKalmanFilter(int cycles, int max_delay_step)
+{
+  typedef TimeDelayKalmanFilterN<NX> TDKFN;
+  typename TDKFN::StateMatrix A = TDKFN::StateMatrix::Identity() + 0.01 * TDKFN::StateMatrix::Random();
+  typename TDKFN::StateMatrix Q = 0.01 * TDKFN::StateMatrix::Identity();
+  typename TDKFN::StateVector x = TDKFN::StateVector::Zero();
+  typename TDKFN::StateMatrix P = TDKFN::StateMatrix::Identity();
+  Eigen::Matrix<double, NY, NX> C = Eigen::Matrix<double, NY, NX>::Identity();
+  Eigen::Matrix<double, NY, NY> R = 0.1 * Eigen::Matrix<double, NY, NY>::Identity();
+  Eigen::Matrix<double, NY, 1> y = Eigen::Matrix<double, NY, 1>::Constant(0.2);
+  // a measurement every 5th prediction with a delay of 20 steps, like 10 Hz gps behind a 50 Hz filter
+  const int update_every = 5;
+  const int delay_step = std::min(20, max_delay_step - 1);
+
+  TimeDelayKalmanFilter tdkf;
+  tdkf.init(x, P, max_delay_step);
+  const Eigen::MatrixXd A_dyn = A, Q_dyn = Q, C_dyn = C, R_dyn = R, y_dyn = y;
+  Eigen::MatrixXd x_dyn;
+  double dynamic_ns = bestNsPerCycle(cycles, [&](int i) {
+    tdkf.getLatestX(x_dyn);
+    tdkf.predictWithDelay(A_dyn * x_dyn, A_dyn, Q_dyn);
+    if (i % update_every == 0)
+    {
+      tdkf.updateWithDelay(y_dyn, C_dyn, R_dyn, delay_step);
+    }
+  });
+
+  TDKFN tdkf_n;
+  tdkf_n.init(x, P, max_delay_step);
+  typename TDKFN::StateVector x_n;
+  double fixed_ns = bestNsPerCycle(cycles, [&](int i) {
+    tdkf_n.getLatestX(x_n);
+    tdkf_n.predictWithDelay(A * x_n, A, Q);
+    if (i % update_every == 0)
+    {
+      tdkf_n.template updateWithDelay<NY>(y, C, R, delay_step);
+    }
+  });
+
+  std::printf("TimeDelayKalmanFilter nx %d delay %3d: dynamic %8.2f us, fixed %8.2f us, %5.1fx\n",
+              NX, max_delay_step, dynamic_ns * 1e-3, fixed_ns * 1e-3, dynamic_ns / fixed_ns);
+}
+
+// predict alone, its cost should only grow linearly with the delay steps kept
+template <int NX>
+void timePredictWithDelay(int cycles, int max_delay_step)
+{
+  typedef TimeDelayKalmanFilterN<NX> TDKFN;
+  typename TDKFN::StateMatrix A = TDKFN::StateMatrix::Identity() + 0.01 * TDKFN::StateMatrix::Random();
+  typename TDKFN::StateMatrix Q = 0.01 * TDKFN::StateMatrix::Identity();
+  typename TDKFN::StateVector x = TDKFN::StateVector::Zero();
+  typename TDKFN::StateMatrix P = TDKFN::StateMatrix::Identity();
+
+  TimeDelayKalmanFilter tdkf;
+  tdkf.init(x, P, max_delay_step);
+  const Eigen::MatrixXd A_dyn = A, Q_dyn = Q, x_dyn = x;
+  double dynamic_ns = bestNsPerCycle(cycles, [&](int) { tdkf.predictWithDelay(x_dyn, A_dyn, Q_dyn); });
+
+  TDKFN tdkf_n;
+  tdkf_n.init(x, P, max_delay_step);
+  double fixed_ns = bestNsPerCycle(cycles, [&](int) { tdkf_n.predictWithDelay(x, A, Q); });
+
+  std::printf("predictWithDelay      nx %d delay %3d: dynamic %8.2f us, fixed %8.2f us\n",
+              NX, max_delay_step, dynamic_ns * 1e-3, fixed_ns * 1e-3);
+}
+}  // namespace
+
+int main(int argc, char **argv)
+{
+  const int cycles = (argc > 1) ? std::atoi(argv[1]) : 100000;
+  srand(42);
+
+  compareKalmanFilter<2, 1>(cycles);
+  compareKalmanFilter<4, 2>(cycles);
+  compareKalmanFilter<6, 3>(cycles);
+
+  const int delay_cycles = std::max(cycles / 100, 10);
+  compareTimeDelayKalmanFilter<5, 3>(delay_cycles, 10);
+  compareTimeDelayKalmanFilter<5, 3>(delay_cycles, 50);
+  timePredictWithDelay<5>(delay_cycles, 10);
+  timePredictWithDelay<5>(delay_cycles, 50);
+  timePredictWithDelay<5>(delay_cycles, 200);
+  return 0;
+}
@@ -35,6 +35,13 @@ struct DifferenceAnBn
   std::vector<double> Bn;
 };
 
+// Second order section b0 + b1 z^-1 + b2 z^-2 / 1 + a1 z^-1 + a2 z^-2
+struct BiquadSection
+{
+  double b0, b1, b2;
+  double a1, a2;
+};
+
 class ButterworthFilter
 {
 public:
@@ -66,6 +73,11 @@ public:
   std::vector<double> getAn();
   std::vector<double> getBn();
 
+  // The discrete time filter as a cascade of second order sections, one first
+  // order section last for odd orders. Same transfer function as An / Bn but
+  // without the rounding of the high order polynomial coefficients.
+  std::vector<BiquadSection> getSOS();
+
   // computes continous time transfer function
   void computeContinuousTimeTF(bool sampling_freqency = false);
 
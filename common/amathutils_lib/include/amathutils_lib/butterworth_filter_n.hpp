@@ -0,0 +1,171 @@
+/*
+ * Copyright 2018-2019 Autoware Foundation. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AMATHUTILS_LIB_BUTTERWORTH_FILTER_N_HPP
+#define AMATHUTILS_LIB_BUTTERWORTH_FILTER_N_HPP
+
+#include <cstddef>
+#include <vector>
+#include <eigen3/Eigen/Core>
+
+#include "amathutils_lib/butterworth_filter.hpp"
+
+/**
+ * @file butterworth_filter_n.hpp
+ * @brief butterworth filter for NC channels in lockstep
+ *
+ * Runs the second order sections of ButterworthFilter::getSOS() in transposed
+ * direct form II. A sample holds one value per channel and every operation
+ * works on all channels at once, so the channels map onto the SIMD lanes
+ * Eigen vectorizes fixed size arrays with. The block functions take NC
+ * interleaved channels, sample after sample, and write in place if out == in.
+ */
+
+template <int NC>
+class ButterworthFilterN
+{
+public:
+  typedef Eigen::Array<double, NC, 1> Sample;
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  /**
+   * @brief No initialization constructor.
+   */
+  ButterworthFilterN() {}
+
+  /**
+   * @brief constructor with initialization
+   * @param sos second order sections, from ButterworthFilter::getSOS()
+   */
+  explicit ButterworthFilterN(const std::vector<BiquadSection> &sos) { setSections(sos); }
+
+  /**
+   * @brief set the sections and reset the filter state to zero
+   * @param sos second order sections, from ButterworthFilter::getSOS()
+   */
+  void setSections(const std::vector<BiquadSection> &sos)
+  {
+    sos_ = sos;
+    s1_.resize(NC, sos_.size());
+    s2_.resize(NC, sos_.size());
+    reset();
+  }
+
+  /**
+   * @brief reset the filter state to zero
+   */
+  void reset()
+  {
+    s1_.setZero();
+    s2_.setZero();
+  }
+
+  /**
+   * @brief reset the filter state to the steady state of a constant input
+   * @param u input the filter has settled on, per channel
+   */
+  void reset(const Sample &u)
+  {
+    Sample x = u;
+    for (size_t k = 0; k < sos_.size(); ++k)
+    {
+      const BiquadSection &s = sos_[k];
+      const Sample y = x * ((s.b0 + s.b1 + s.b2) / (1.0 + s.a1 + s.a2));
+      s1_.col(k) = y - s.b0 * x;
+      s2_.col(k) = s.b2 * x - s.a2 * y;
+      x = y;
+    }
+  }
+
+  /**
+   * @brief filter one sample of all channels
+   * @param u input sample
+   * @return filtered sample
+   */
+  Sample filter(const Sample &u)
+  {
+    Sample x = u;
+    for (size_t k = 0; k < sos_.size(); ++k)
+    {
+      const BiquadSection &s = sos_[k];
+      const Sample y = s.b0 * x + s1_.col(k);
+      s1_.col(k) = s.b1 * x - s.a1 * y + s2_.col(k);
+      s2_.col(k) = s.b2 * x - s.a2 * y;
+      x = y;
+    }
+    return x;
+  }
+
+  /**
+   * @brief filter n interleaved samples, continuing from the current state
+   * @param in n * NC values, the NC channels of each sample next to each other
+   * @param out n * NC filtered values, may be in
+   * @param n number of samples
+   */
+  void filterBlock(const double *in, double *out, const size_t n)
+  {
+    for (size_t i = 0; i < n; ++i)
+    {
+      Eigen::Map<Sample>(out + i * NC) = filter(Eigen::Map<const Sample>(in + i * NC));
+    }
+  }
+
+  /**
+   * @brief zero phase filtering of n interleaved samples, forward and then backward in out
+   * @param in n * NC values, the NC channels of each sample next to each other
+   * @param out n * NC filtered values, may be in
+   * @param n number of samples
+   * @param init_first_value start each pass from the steady state of its first sample instead of zero
+   */
+  void filtFiltBlock(const double *in, double *out, const size_t n, const bool init_first_value = true)
+  {
+    if (n == 0)
+    {
+      return;
+    }
+
+    if (init_first_value)
+    {
+      reset(Eigen::Map<const Sample>(in));
+    }
+    else
+    {
+      reset();
+    }
+    filterBlock(in, out, n);
+
+    if (init_first_value)
+    {
+      reset(Eigen::Map<const Sample>(out + (n - 1) * NC));
+    }
+    else
+    {
+      reset();
+    }
+    for (size_t i = n; i-- > 0;)
+    {
+      Eigen::Map<Sample>(out + i * NC) = filter(Eigen::Map<const Sample>(out + i * NC));
+    }
+  }
+
+private:
+  std::vector<BiquadSection> sos_;               //!< @brief second order sections, applied in order
+  Eigen::Array<double, NC, Eigen::Dynamic> s1_;  //!< @brief first delay of each section, one column per section
+  Eigen::Array<double, NC, Eigen::Dynamic> s2_;  //!< @brief second delay of each section, one column per section
+};
+
+#endif  // AMATHUTILS_LIB_BUTTERWORTH_FILTER_N_HPP
@@ -53,7 +53,7 @@ public:
   /**
    * @brief destructor
    */
-  ~KalmanFilter();
+  virtual ~KalmanFilter();
 
   /**
    * @brief initialization of kalman filter
@@ -111,20 +111,20 @@ public:
    * @brief get current kalman filter state
    * @param x kalman filter state
    */
-  void getX(Eigen::MatrixXd &x);
+  virtual void getX(Eigen::MatrixXd &x);
 
   /**
    * @brief get current kalman filter covariance
    * @param P kalman filter covariance
    */
-  void getP(Eigen::MatrixXd &P);
+  virtual void getP(Eigen::MatrixXd &P);
 
   /**
    * @brief get component of current kalman filter state
    * @param i index of kalman filter state
    * @return value of i's component of the kalman filter state x[i]
    */
-  double getXelement(unsigned int i);
+  virtual double getXelement(unsigned int i);
 
   /**
    * @brief calculate kalman filter state and covariance by prediction model with A, B, Q matrix. This is mainly for EKF with variable matrix.
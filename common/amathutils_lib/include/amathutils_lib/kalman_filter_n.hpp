@@ -0,0 +1,206 @@
+/*
+ * Copyright 2018-2019 Autoware Foundation. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AMATHUTILS_LIB_KALMAN_FILTER_N_HPP
+#define AMATHUTILS_LIB_KALMAN_FILTER_N_HPP
+
+#include <eigen3/Eigen/Core>
+#include <eigen3/Eigen/LU>
+
+/**
+ * @file kalman_filter_n.hpp
+ * @brief kalman filter with compile time dimensions
+ *
+ * Same interface and results as KalmanFilter, for the small state dimensions
+ * the filters actually use. All matrices are fixed size members, so predict
+ * and update do not allocate and the gain uses the closed form inverse for
+ * measurements up to 4 dimensions.
+ */
+
+template <int NX, int NU, int NY>
+class KalmanFilterN
+{
+public:
+  typedef Eigen::Matrix<double, NX, 1> StateVector;
+  typedef Eigen::Matrix<double, NX, NX> StateMatrix;
+  typedef Eigen::Matrix<double, NU, 1> InputVector;
+  typedef Eigen::Matrix<double, NX, NU> InputMatrix;
+  typedef Eigen::Matrix<double, NY, 1> OutputVector;
+  typedef Eigen::Matrix<double, NY, NX> OutputMatrix;
+  typedef Eigen::Matrix<double, NY, NY> OutputCovariance;
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  /**
+   * @brief No initialization constructor.
+   */
+  KalmanFilterN() : initialized_(false) {}
+
+  /**
+   * @brief constructor with initialization
+   * @param x initial state
+   * @param A coefficient matrix of x for process model
+   * @param B coefficient matrix of u for process model
+   * @param C coefficient matrix of x for measurement model
+   * @param Q covariace matrix for process model
+   * @param R covariance matrix for measurement model
+   * @param P initial covariance of estimated state
+   */
+  KalmanFilterN(const StateVector &x, const StateMatrix &A, const InputMatrix &B,
+                const OutputMatrix &C, const StateMatrix &Q, const OutputCovariance &R,
+                const StateMatrix &P)
+  {
+    init(x, A, B, C, Q, R, P);
+  }
+
+  /**
+   * @brief initialization of kalman filter
+   * @param x initial state
+   * @param A coefficient matrix of x for process model
+   * @param B coefficient matrix of u for process model
+   * @param C coefficient matrix of x for measurement model
+   * @param Q covariace matrix for process model
+   * @param R covariance matrix for measurement model
+   * @param P initial covariance of estimated state
+   */
+  bool init(const StateVector &x, const StateMatrix &A, const InputMatrix &B,
+            const OutputMatrix &C, const StateMatrix &Q, const OutputCovariance &R,
+            const StateMatrix &P)
+  {
+    x_ = x;
+    A_ = A;
+    B_ = B;
+    C_ = C;
+    Q_ = Q;
+    R_ = R;
+    P_ = P;
+    initialized_ = true;
+    return true;
+  }
+
+  /**
+   * @brief initialization of kalman filter
+   * @param x initial state
+   * @param P initial covariance of estimated state
+   */
+  bool init(const StateVector &x, const StateMatrix &P0)
+  {
+    x_ = x;
+    P_ = P0;
+    initialized_ = true;
+    return true;
+  }
+
+  void setA(const StateMatrix &A) { A_ = A; }
+  void setB(const InputMatrix &B) { B_ = B; }
+  void setC(const OutputMatrix &C) { C_ = C; }
+  void setQ(const StateMatrix &Q) { Q_ = Q; }
+  void setR(const OutputCovariance &R) { R_ = R; }
+  void getX(StateVector &x) const { x = x_; }
+  void getP(StateMatrix &P) const { P = P_; }
+  double getXelement(unsigned int i) const { return x_(i); }
+
+  /**
+   * @brief calculate kalman filter covariance with prediction model with x, A, Q matrix. This is mainly for EKF with variable matrix.
+   * @param x_next predicted state
+   * @param A coefficient matrix of x for process model
+   * @param Q covariace matrix for process model
+   * @return false before initialization
+   */
+  bool predict(const StateVector &x_next, const StateMatrix &A, const StateMatrix &Q)
+  {
+    if (!initialized_)
+    {
+      return false;
+    }
+    x_ = x_next;
+    P_ = A * P_ * A.transpose() + Q;
+    return true;
+  }
+  bool predict(const StateVector &x_next, const StateMatrix &A) { return predict(x_next, A, Q_); }
+
+  /**
+   * @brief calculate kalman filter state and covariance by prediction model with A, B, Q matrix. This is mainly for EKF with variable matrix.
+   * @param u input for model
+   * @param A coefficient matrix of x for process model
+   * @param B coefficient matrix of u for process model
+   * @param Q covariace matrix for process model
+   * @return false before initialization
+   */
+  bool predict(const InputVector &u, const StateMatrix &A, const InputMatrix &B, const StateMatrix &Q)
+  {
+    const StateVector x_next = A * x_ + B * u;
+    return predict(x_next, A, Q);
+  }
+  bool predict(const InputVector &u) { return predict(u, A_, B_, Q_); }
+
+  /**
+   * @brief calculate kalman filter state by measurement model with y_pred, C and R matrix. This is mainly for EKF with variable matrix.
+   * @param y measured values, of any dimension NM
+   * @param y_pred output values expected from measurement model
+   * @param C coefficient matrix of x for measurement model
+   * @param R covariance matrix for measurement model
+   * @return false before initialization or when the gain is not finite
+   */
+  template <int NM>
+  bool update(const Eigen::Matrix<double, NM, 1> &y, const Eigen::Matrix<double, NM, 1> &y_pred,
+              const Eigen::Matrix<double, NM, NX> &C, const Eigen::Matrix<double, NM, NM> &R)
+  {
+    if (!initialized_)
+    {
+      return false;
+    }
+    const Eigen::Matrix<double, NX, NM> PCT = P_ * C.transpose();
+    const Eigen::Matrix<double, NM, NM> S = R + C * PCT;
+    const Eigen::Matrix<double, NX, NM> K = PCT * S.inverse();
+
+    if (!K.allFinite())
+    {
+      return false;
+    }
+
+    x_ += K * (y - y_pred);
+    P_ -= K * (C * P_);
+    return true;
+  }
+
+  /**
+   * @brief calculate kalman filter state by measurement model with C and R matrix. This is mainly for EKF with variable matrix.
+   * @param y measured values, of any dimension NM
+   * @param C coefficient matrix of x for measurement model
+   * @param R covariance matrix for measurement model
+   */
+  template <int NM>
+  bool update(const Eigen::Matrix<double, NM, 1> &y, const Eigen::Matrix<double, NM, NX> &C,
+              const Eigen::Matrix<double, NM, NM> &R)
+  {
+    const Eigen::Matrix<double, NM, 1> y_pred = C * x_;
+    return update<NM>(y, y_pred, C, R);
+  }
+  bool update(const OutputVector &y) { return update<NY>(y, C_, R_); }
+
+protected:
+  StateVector x_;       //!< @brief current estimated state
+  StateMatrix A_;       //!< @brief coefficient matrix of x for process model x[k+1] = A*x[k] + B*u[k]
+  InputMatrix B_;       //!< @brief coefficient matrix of u for process model x[k+1] = A*x[k] + B*u[k]
+  OutputMatrix C_;      //!< @brief coefficient matrix of x for measurement model y[k] = C * x[k]
+  StateMatrix Q_;       //!< @brief covariace matrix for process model x[k+1] = A*x[k] + B*u[k]
+  OutputCovariance R_;  //!< @brief covariance matrix for measurement model y[k] = C * x[k]
+  StateMatrix P_;       //!< @brief covariance of estimated state
+  bool initialized_;    //!< @brief set by init(), the dynamic filter tells this from the matrix sizes
+};
+
+#endif  // AMATHUTILS_LIB_KALMAN_FILTER_N_HPP
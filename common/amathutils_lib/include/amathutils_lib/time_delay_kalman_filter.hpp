@@ -27,6 +27,11 @@
  * @brief kalman filter with delayed measurement class
  * @author Takamasa Horibe
  * @date 2019.05.01
+ *
+ * The steps of the extended state are kept in a ring of slots, step i (0 is
+ * the latest) in slot (head + i) % max_delay_step, so a prediction only writes
+ * the slot of the oldest step, which becomes the new latest one. x_ and P_ are
+ * in slot order, getX() and getP() return them newest step first.
  */
 
 class TimeDelayKalmanFilter : public KalmanFilter
@@ -57,6 +62,19 @@ public:
    */
   void getLatestP(Eigen::MatrixXd &P);
 
+  /**
+   * @brief get extended state and covariance, newest step first
+   */
+  void getX(Eigen::MatrixXd &x) override;
+  void getP(Eigen::MatrixXd &P) override;
+
+  /**
+   * @brief get component of the extended state, newest step first as in getX()
+   * @param i index of the extended state
+   * @return value of getX()(i)
+   */
+  double getXelement(unsigned int i) override;
+
   /**
    * @brief calculate kalman filter covariance by predicion model with time delay. This is mainly for EKF of nonlinear process model.
    * @param x_next predicted state by prediction model
@@ -80,6 +98,12 @@ private:
   int max_delay_step_;  //!< @brief maximum number of delay steps
   int dim_x_;           //!< @brief dimension of latest state
   int dim_x_ex_;        //!< @brief dimension of extended state with dime delay
+  int head_;            //!< @brief slot of the latest step
+
+  /**
+   * @brief slot of the step delay_step steps ago
+   */
+  int slot(const int delay_step) const;
 };
 
 #endif  // AMATHUTILS_LIB_TIME_DELAY_KALMAN_FILTER_HPP
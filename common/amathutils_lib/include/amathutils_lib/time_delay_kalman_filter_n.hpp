@@ -0,0 +1,208 @@
+/*
+ * Copyright 2018-2019 Autoware Foundation. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AMATHUTILS_LIB_TIME_DELAY_KALMAN_FILTER_N_HPP
+#define AMATHUTILS_LIB_TIME_DELAY_KALMAN_FILTER_N_HPP
+
+#include <iostream>
+#include <eigen3/Eigen/Core>
+#include <eigen3/Eigen/LU>
+
+/**
+ * @file time_delay_kalman_filter_n.hpp
+ * @brief kalman filter with delayed measurement and compile time state dimension
+ *
+ * Same interface and results as TimeDelayKalmanFilter. The per step blocks
+ * are fixed size; the extended state (NX * max_delay_step) is sized in init()
+ * and predict/update work in place from then on. Steps are kept in the same
+ * ring of slots as TimeDelayKalmanFilter, so predict only writes the slot of
+ * the new step, and the update only touches the columns of the delayed block
+ * instead of multiplying by the mostly zero extended C.
+ */
+
+template <int NX>
+class TimeDelayKalmanFilterN
+{
+public:
+  typedef Eigen::Matrix<double, NX, 1> StateVector;
+  typedef Eigen::Matrix<double, NX, NX> StateMatrix;
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  /**
+   * @brief No initialization constructor.
+   */
+  TimeDelayKalmanFilterN() : max_delay_step_(0), dim_x_ex_(0), head_(0) {}
+
+  /**
+   * @brief initialization of kalman filter
+   * @param x initial state
+   * @param P0 initial covariance of estimated state
+   * @param max_delay_step Maximum number of delay steps, which determines the dimension of the extended kalman filter
+   */
+  void init(const StateVector &x, const StateMatrix &P0, const int max_delay_step)
+  {
+    max_delay_step_ = max_delay_step;
+    dim_x_ex_ = NX * max_delay_step;
+    head_ = 0;
+
+    x_.setZero(dim_x_ex_);
+    P_.setZero(dim_x_ex_, dim_x_ex_);
+    PCT_.setZero(dim_x_ex_, NX);
+    K_.setZero(dim_x_ex_, NX);
+
+    for (int i = 0; i < max_delay_step_; ++i)
+    {
+      x_.template segment<NX>(i * NX) = x;
+      P_.template block<NX, NX>(i * NX, i * NX) = P0;
+    }
+  }
+
+  /**
+   * @brief get latest time estimated state
+   * @param x latest time estimated state
+   */
+  void getLatestX(StateVector &x) const { x = x_.template segment<NX>(head_ * NX); }
+
+  /**
+   * @brief get latest time estimation covariance
+   * @param P latest time estimation covariance
+   */
+  void getLatestP(StateMatrix &P) const { P = P_.template block<NX, NX>(head_ * NX, head_ * NX); }
+
+  /**
+   * @brief get the estimated state and covariance delay_step steps ago
+   */
+  void getDelayedX(StateVector &x, const int delay_step) const { x = x_.template segment<NX>(slot(delay_step) * NX); }
+  void getDelayedP(StateMatrix &P, const int delay_step) const
+  {
+    P = P_.template block<NX, NX>(slot(delay_step) * NX, slot(delay_step) * NX);
+  }
+
+  /**
+   * @brief get the extended state and covariance, newest step first. Reorders the slots, not for the hot path.
+   */
+  void getX(Eigen::VectorXd &x) const
+  {
+    x.resize(dim_x_ex_);
+    for (int i = 0; i < max_delay_step_; ++i)
+    {
+      x.template segment<NX>(i * NX) = x_.template segment<NX>(slot(i) * NX);
+    }
+  }
+  void getP(Eigen::MatrixXd &P) const
+  {
+    P.resize(dim_x_ex_, dim_x_ex_);
+    for (int i = 0; i < max_delay_step_; ++i)
+    {
+      for (int j = 0; j < max_delay_step_; ++j)
+      {
+        P.template block<NX, NX>(i * NX, j * NX) = P_.template block<NX, NX>(slot(i) * NX, slot(j) * NX);
+      }
+    }
+  }
+
+  /**
+   * @brief calculate kalman filter covariance by predicion model with time delay. This is mainly for EKF of nonlinear process model.
+   * @param x_next predicted state by prediction model
+   * @param A coefficient matrix of x for process model
+   * @param Q covariace matrix for process model
+   */
+  bool predictWithDelay(const StateVector &x_next, const StateMatrix &A, const StateMatrix &Q)
+  {
+    /* see TimeDelayKalmanFilter::predictWithDelay() */
+    const int prev = head_ * NX;
+    head_ = (head_ == 0) ? max_delay_step_ - 1 : head_ - 1;
+    const int curr = head_ * NX;
+
+    x_.template segment<NX>(curr) = x_next;
+
+    const StateMatrix P11 = P_.template block<NX, NX>(prev, prev);
+    if (curr != prev)
+    {
+      /* column of the new step, lazy products evaluate in place without a GEMM workspace; the row is its transpose */
+      P_.template middleCols<NX>(curr) = P_.template middleCols<NX>(prev).lazyProduct(A.transpose());
+      for (int j = 0; j < max_delay_step_; ++j)
+      {
+        if (j != head_)
+        {
+          P_.template block<NX, NX>(curr, j * NX) = P_.template block<NX, NX>(j * NX, curr).transpose();
+        }
+      }
+    }
+    P_.template block<NX, NX>(curr, curr) = A * P11 * A.transpose() + Q;
+
+    return true;
+  }
+
+  /**
+   * @brief calculate kalman filter covariance by measurement model with time delay. This is mainly for EKF of nonlinear process model.
+   * @param y measured values, NM <= NX
+   * @param C coefficient matrix of x for measurement model
+   * @param R covariance matrix for measurement model
+   * @param delay_step measurement delay
+   */
+  template <int NM>
+  bool updateWithDelay(const Eigen::Matrix<double, NM, 1> &y, const Eigen::Matrix<double, NM, NX> &C,
+                       const Eigen::Matrix<double, NM, NM> &R, const int delay_step)
+  {
+    static_assert(NM <= NX, "measurement dimension larger than the state, the workspaces hold NX columns");
+    if (delay_step >= max_delay_step_)
+    {
+      std::cerr << "delay step is larger than max_delay_step. ignore update." << std::endl;
+      return false;
+    }
+
+    /* C_ex is zero except for C at the delayed block, so P * C_ex' only needs those columns */
+    const int offset = slot(delay_step) * NX;
+    auto PCT = PCT_.template leftCols<NM>();
+    auto K = K_.template leftCols<NM>();
+    PCT = P_.template middleCols<NX>(offset).lazyProduct(C.transpose());
+
+    Eigen::Matrix<double, NM, NM> S = R + C * PCT.template middleRows<NX>(offset);
+    /* an asymmetric S would feed back into P through the PCT' form below and grow */
+    S = 0.5 * (S + S.transpose()).eval();
+    const Eigen::Matrix<double, NM, NM> S_inv = S.inverse();
+    K = PCT.lazyProduct(S_inv);
+    if (!K.allFinite())
+    {
+      return false;
+    }
+
+    const Eigen::Matrix<double, NM, 1> innovation = y - C * x_.template segment<NX>(offset);
+    x_ += K.lazyProduct(innovation);
+    /* C_ex * P is PCT' for the symmetric P */
+    P_ -= K.lazyProduct(PCT.transpose());
+    return true;
+  }
+
+private:
+  int max_delay_step_;  //!< @brief maximum number of delay steps
+  int dim_x_ex_;        //!< @brief dimension of extended state with dime delay
+  int head_;            //!< @brief slot of the latest step, step i is in slot (head_ + i) % max_delay_step_
+  Eigen::VectorXd x_;   //!< @brief extended state, by slot
+  Eigen::MatrixXd P_;   //!< @brief covariance of the extended state, by slot
+  Eigen::Matrix<double, Eigen::Dynamic, NX> PCT_;  //!< @brief update workspace P * C_ex'
+  Eigen::Matrix<double, Eigen::Dynamic, NX> K_;    //!< @brief update workspace, kalman gain
+
+  int slot(const int step) const
+  {
+    const int s = head_ + step;
+    return s >= max_delay_step_ ? s - max_delay_step_ : s;
+  }
+};
+
+#endif  // AMATHUTILS_LIB_TIME_DELAY_KALMAN_FILTER_N_HPP
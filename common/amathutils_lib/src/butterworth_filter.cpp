@@ -25,6 +25,7 @@
 #include <vector>
 
 #include "amathutils_lib/butterworth_filter.hpp"
+#include "amathutils_lib/butterworth_filter_n.hpp"
 
 void ButterworthFilter::Buttord(double Wp, double Ws, double Ap, double As)
 {
@@ -298,6 +299,59 @@ std::vector<double> ButterworthFilter::getBn()
   return mBn;
 }
 
+std::vector<BiquadSection> ButterworthFilter::getSOS()
+{
+  /*
+   * The discrete poles are in the order of the phase angles, so pole i and
+   * pole N-1-i are a conjugate pair and the middle one of an odd order is real.
+   * All zeros are at -1. Each section gets unity DC gain and the first one
+   * carries the DC gain of the whole filter.
+   * */
+  std::vector<BiquadSection> sos;
+  const int n_pairs = mOrder / 2;
+
+  for (int i = 0; i < n_pairs; i++)
+  {
+    const std::complex<double> &p = mDiscreteTimeRoots[i];
+    BiquadSection s;
+    s.a1 = -2.0 * p.real();
+    s.a2 = std::norm(p);
+    const double g = (1.0 + s.a1 + s.a2) / 4.0;
+    s.b0 = g;
+    s.b1 = 2.0 * g;
+    s.b2 = g;
+    sos.push_back(s);
+  }
+
+  if (mOrder % 2 == 1)
+  {
+    BiquadSection s;
+    s.a1 = -mDiscreteTimeRoots[n_pairs].real();
+    s.a2 = 0.0;
+    const double g = (1.0 + s.a1) / 2.0;
+    s.b0 = g;
+    s.b1 = g;
+    s.b2 = 0.0;
+    sos.push_back(s);
+  }
+
+  double sum_b = 0.0, sum_a = 0.0;
+  for (int i = 0; i < mOrder + 1; i++)
+  {
+    sum_b += mBn[i];
+    sum_a += mAn[i];
+  }
+  if (!sos.empty())
+  {
+    const double dc_gain = sum_b / sum_a;
+    sos[0].b0 *= dc_gain;
+    sos[0].b1 *= dc_gain;
+    sos[0].b2 *= dc_gain;
+  }
+
+  return sos;
+}
+
 void ButterworthFilter::PrintFilter_Specs()
 {
   /*
@@ -432,19 +486,8 @@ void ButterworthFilter::filtFiltVector(const std::vector<double> &t,
                                        std::vector<double> &u,
                                        bool init_first_value)
 {
-  std::vector<double> u_rev(u);
-
-  // forward filtering
-  filtVector(t, u, init_first_value);
-
-  // backward filtering
-  std::reverse(u_rev.begin(), u_rev.end());
-  filtVector(t, u_rev, init_first_value);
-  std::reverse(u_rev.begin(), u_rev.end());
-
-  // merge
-  for (unsigned int i = 0; i < u.size(); ++i)
-  {
-    u[i] = (u[i] + u_rev[i]) * 0.5;
-  }
+  // forward over t into u, then backward over u in place
+  ButterworthFilterN<1> sos_filter(getSOS());
+  u.resize(t.size());
+  sos_filter.filtFiltBlock(t.data(), u.data(), t.size(), init_first_value);
 }
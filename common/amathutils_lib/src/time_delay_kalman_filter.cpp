@@ -16,7 +16,7 @@
 
 #include "amathutils_lib/time_delay_kalman_filter.hpp"
 
-TimeDelayKalmanFilter::TimeDelayKalmanFilter() {}
+TimeDelayKalmanFilter::TimeDelayKalmanFilter() : max_delay_step_(0), dim_x_(0), dim_x_ex_(0), head_(0) {}
 
 void TimeDelayKalmanFilter::init(const Eigen::MatrixXd &x, const Eigen::MatrixXd &P0,
                                  const int max_delay_step)
@@ -24,6 +24,7 @@ void TimeDelayKalmanFilter::init(const Eigen::MatrixXd &x, const Eigen::MatrixXd
   max_delay_step_ = max_delay_step;
   dim_x_ = x.rows();
   dim_x_ex_ = dim_x_ * max_delay_step;
+  head_ = 0;
 
   x_ = Eigen::MatrixXd::Zero(dim_x_ex_, 1);
   P_ = Eigen::MatrixXd::Zero(dim_x_ex_, dim_x_ex_);
@@ -35,8 +36,43 @@ void TimeDelayKalmanFilter::init(const Eigen::MatrixXd &x, const Eigen::MatrixXd
   }
 }
 
-void TimeDelayKalmanFilter::getLatestX(Eigen::MatrixXd &x) { x = x_.block(0, 0, dim_x_, 1); }
-void TimeDelayKalmanFilter::getLatestP(Eigen::MatrixXd &P) { P = P_.block(0, 0, dim_x_, dim_x_); }
+int TimeDelayKalmanFilter::slot(const int delay_step) const
+{
+  const int s = head_ + delay_step;
+  return s >= max_delay_step_ ? s - max_delay_step_ : s;
+}
+
+void TimeDelayKalmanFilter::getLatestX(Eigen::MatrixXd &x) { x = x_.block(head_ * dim_x_, 0, dim_x_, 1); }
+void TimeDelayKalmanFilter::getLatestP(Eigen::MatrixXd &P)
+{
+  P = P_.block(head_ * dim_x_, head_ * dim_x_, dim_x_, dim_x_);
+}
+
+void TimeDelayKalmanFilter::getX(Eigen::MatrixXd &x)
+{
+  x.resize(dim_x_ex_, 1);
+  for (int i = 0; i < max_delay_step_; ++i)
+  {
+    x.block(i * dim_x_, 0, dim_x_, 1) = x_.block(slot(i) * dim_x_, 0, dim_x_, 1);
+  }
+}
+
+void TimeDelayKalmanFilter::getP(Eigen::MatrixXd &P)
+{
+  P.resize(dim_x_ex_, dim_x_ex_);
+  for (int i = 0; i < max_delay_step_; ++i)
+  {
+    for (int j = 0; j < max_delay_step_; ++j)
+    {
+      P.block(i * dim_x_, j * dim_x_, dim_x_, dim_x_) = P_.block(slot(i) * dim_x_, slot(j) * dim_x_, dim_x_, dim_x_);
+    }
+  }
+}
+
+double TimeDelayKalmanFilter::getXelement(unsigned int i)
+{
+  return x_(slot(i / dim_x_) * dim_x_ + i % dim_x_);
+}
 
 bool TimeDelayKalmanFilter::predictWithDelay(const Eigen::MatrixXd &x_next, const Eigen::MatrixXd &A,
                                              const Eigen::MatrixXd &Q)
@@ -53,23 +89,33 @@ bool TimeDelayKalmanFilter::predictWithDelay(const Eigen::MatrixXd &x_next, cons
  *     [A*P11*A'*+Q  A*P11  A*P12]
  * P = [     P11*A'    P11    P12]
  *     [     P21*A'    P21    P22]
+ *
+ * The lower right part is the old P shifted by one step. With the steps in a
+ * ring of slots it stays where it is: the oldest slot becomes the latest step
+ * and only its row and column are written, O(dim_x^2 * max_delay_step)
+ * instead of copying the whole extended covariance.
  */
 
-  const int d_dim_x = dim_x_ex_ - dim_x_;
+  const int prev = head_ * dim_x_;
+  head_ = (head_ == 0) ? max_delay_step_ - 1 : head_ - 1;
+  const int curr = head_ * dim_x_;
 
-  /* slide states in the time direction */
-  Eigen::MatrixXd x_tmp = Eigen::MatrixXd::Zero(dim_x_ex_, 1);
-  x_tmp.block(0, 0, dim_x_, 1) = x_next;
-  x_tmp.block(dim_x_, 0, d_dim_x, 1) = x_.block(0, 0, d_dim_x, 1);
-  x_ = x_tmp;
+  x_.block(curr, 0, dim_x_, 1) = x_next;
 
-  /* update P with delayed measurement A matrix structure */
-  Eigen::MatrixXd P_tmp = Eigen::MatrixXd::Zero(dim_x_ex_, dim_x_ex_);
-  P_tmp.block(0, 0, dim_x_, dim_x_) = A * P_.block(0, 0, dim_x_, dim_x_) * A.transpose() + Q;
-  P_tmp.block(0, dim_x_, dim_x_, d_dim_x) = A * P_.block(0, 0, dim_x_, d_dim_x);
-  P_tmp.block(dim_x_, 0, d_dim_x, dim_x_) = P_.block(0, 0, d_dim_x, dim_x_) * A.transpose();
-  P_tmp.block(dim_x_, dim_x_, d_dim_x, d_dim_x) = P_.block(0, 0, d_dim_x, d_dim_x);
-  P_ = P_tmp;
+  const Eigen::MatrixXd P11 = P_.block(prev, prev, dim_x_, dim_x_);
+  if (curr != prev)
+  {
+    /* column of the new step, the row is its transpose as P is symmetric */
+    P_.block(0, curr, dim_x_ex_, dim_x_).noalias() = P_.block(0, prev, dim_x_ex_, dim_x_) * A.transpose();
+    for (int j = 0; j < max_delay_step_; ++j)
+    {
+      if (j != head_)
+      {
+        P_.block(curr, j * dim_x_, dim_x_, dim_x_) = P_.block(j * dim_x_, curr, dim_x_, dim_x_).transpose();
+      }
+    }
+  }
+  P_.block(curr, curr, dim_x_, dim_x_) = A * P11 * A.transpose() + Q;
 
   return true;
 }
@@ -87,7 +133,7 @@ bool TimeDelayKalmanFilter::updateWithDelay(const Eigen::MatrixXd &y, const Eige
 
   /* set measurement matrix */
   Eigen::MatrixXd C_ex = Eigen::MatrixXd::Zero(dim_y, dim_x_ex_);
-  C_ex.block(0, dim_x_ * delay_step, dim_y, dim_x_) = C;
+  C_ex.block(0, dim_x_ * slot(delay_step), dim_y, dim_x_) = C;
 
   /* update */
   if (!update(y, C_ex, R))
@@ -16,6 +16,7 @@
  * Authors: Ali Boyali, Simon Thompson
  */
 
+#include <algorithm>
 #include <cmath>
 #include <complex>
 #include <iostream>
@@ -26,6 +27,7 @@
 #include <gtest/gtest.h>
 
 #include "amathutils_lib/butterworth_filter.hpp"
+#include "amathutils_lib/butterworth_filter_n.hpp"
 
 class TestSuite :
   public ::testing::Test
@@ -166,6 +168,114 @@ TEST_F(TestSuite, FilterTest)
   }
 }
 
+TEST_F(TestSuite, SectionsMatchTransferFunction)
+{
+  // orders 2 to 6, the odd ones end in a first order section
+  for (int order = 2; order <= 6; order++)
+  {
+    ButterworthFilter bf;
+    bf.setOrder(order);
+    bf.setCuttoffFrequency(5, 100);
+    bf.computeContinuousTimeTF(true);
+    bf.computeDiscreteTimeTF(true);
+
+    std::vector<BiquadSection> sos = bf.getSOS();
+    ASSERT_EQ(static_cast<size_t>((order + 1) / 2), sos.size());
+
+    std::vector<double> step(200, 1.0);
+    std::vector<double> expected(step.size());
+    bf.initializeForFiltering();
+    bf.filtVector(step, expected, false);
+
+    ButterworthFilterN<1> bf_n(sos);
+    std::vector<double> actual(step.size());
+    bf_n.filterBlock(step.data(), actual.data(), step.size());
+
+    for (size_t i = 0; i < step.size(); i++)
+    {
+      ASSERT_NEAR(expected[i], actual[i], 1.0E-9) << "order " << order << ", sample " << i;
+    }
+    ASSERT_NEAR(1.0, actual.back(), 1.0E-3) << "unity dc gain expected, order " << order;
+  }
+}
+
+TEST_F(TestSuite, MultiChannelFilter)
+{
+  ButterworthFilter bf;
+  bf.setOrder(3);
+  bf.setCuttoffFrequency(5, 100);
+  bf.computeContinuousTimeTF(true);
+  bf.computeDiscreteTimeTF(true);
+
+  // four channels of different signals, each must come out as if filtered alone
+  const int n = 300;
+  std::vector<double> interleaved(n * 4);
+  for (int i = 0; i < n; i++)
+  {
+    interleaved[i * 4 + 0] = std::sin(0.1 * i);
+    interleaved[i * 4 + 1] = (i % 20 < 10) ? 1.0 : -1.0;
+    interleaved[i * 4 + 2] = 0.01 * i;
+    interleaved[i * 4 + 3] = std::cos(1.3 * i);
+  }
+
+  ButterworthFilterN<4> bf_4(bf.getSOS());
+  std::vector<double> filtered(interleaved.size());
+  bf_4.filterBlock(interleaved.data(), filtered.data(), n);
+
+  for (int c = 0; c < 4; c++)
+  {
+    ButterworthFilterN<1> bf_1(bf.getSOS());
+    for (int i = 0; i < n; i++)
+    {
+      ButterworthFilterN<1>::Sample u;
+      u << interleaved[i * 4 + c];
+      ASSERT_NEAR(bf_1.filter(u)(0), filtered[i * 4 + c], 1.0E-12) << "channel " << c << ", sample " << i;
+    }
+  }
+
+  // in place gives the same
+  bf_4.reset();
+  bf_4.filterBlock(interleaved.data(), interleaved.data(), n);
+  for (int i = 0; i < n * 4; i++)
+  {
+    ASSERT_EQ(filtered[i], interleaved[i]);
+  }
+}
+
+TEST_F(TestSuite, FiltFiltZeroPhase)
+{
+  ButterworthFilter bf;
+  bf.setOrder(2);
+  bf.setCuttoffFrequency(5, 100);
+  bf.computeContinuousTimeTF(true);
+  bf.computeDiscreteTimeTF(true);
+
+  // a 1 Hz sine at 100 Hz passes with no delay, a single pass lags it
+  const int n = 1000;
+  std::vector<double> u(n);
+  for (int i = 0; i < n; i++)
+  {
+    u[i] = std::sin(2.0 * M_PI * i / 100.0);
+  }
+  std::vector<double> u_filtfilt;
+  bf.filtFiltVector(u, u_filtfilt);
+
+  double max_err = 0.0;
+  for (int i = 200; i < n - 200; i++)
+  {
+    max_err = std::max(max_err, std::fabs(u_filtfilt[i] - u[i]));
+  }
+  ASSERT_LT(max_err, 0.01);
+
+  // steady state starts keep a constant constant
+  std::vector<double> constant(100, 2.5);
+  bf.filtFiltVector(constant, u_filtfilt);
+  for (int i = 0; i < 100; i++)
+  {
+    ASSERT_NEAR(2.5, u_filtfilt[i], 1.0E-9);
+  }
+}
+
 int main(int argc, char **argv)
 {
     testing::InitGoogleTest(&argc, argv);
@@ -20,6 +20,8 @@
 
 #include "amathutils_lib/kalman_filter.hpp"
 #include "amathutils_lib/time_delay_kalman_filter.hpp"
+#include "amathutils_lib/kalman_filter_n.hpp"
+#include "amathutils_lib/time_delay_kalman_filter_n.hpp"
 
 class KalmanFilterTestSuite :
   public ::testing::Test
@@ -157,6 +159,208 @@ TEST_F(KalmanFilterTestSuite, delayedMeasurement)
   ASSERT_EQ(false, tdkf.updateWithDelay(y, C, R, delay_step));
 }
 
+TEST_F(KalmanFilterTestSuite, fixedSizeUpdateCase)
+{
+  typedef KalmanFilterN<3, 1, 3> KF3;
+  KF3 kf;
+  KF3::StateVector x = KF3::StateVector::Zero();
+  KF3::OutputVector y = KF3::OutputVector::Zero();
+  KF3::StateMatrix P = KF3::StateMatrix::Identity();
+  KF3::OutputMatrix C = KF3::OutputMatrix::Identity();
+  KF3::OutputCovariance R = KF3::OutputCovariance::Identity();
+  KF3::OutputVector y_pred = y;
+
+  ASSERT_EQ(false, kf.update(y)) << "uninitialized, false expected";
+  ASSERT_EQ(false, kf.update<3>(y, C, R)) << "uninitialized, false expected";
+  ASSERT_EQ(false, kf.update<3>(y, y_pred, C, R)) << "uninitialized, false expected";
+
+  KF3::OutputCovariance R0 = KF3::OutputCovariance::Zero();
+  kf.init(x, KF3::StateMatrix::Zero());
+  ASSERT_EQ(false, kf.update<3>(y, y_pred, C, R0)) << "R0 inverse problem, false expected";
+
+  kf.init(x, P);
+  y << 1.0, 1.0, 1.0;
+  y_pred << 0.0, 0.0, 0.0;
+  kf.update<3>(y, y_pred, C, R);
+  KF3::StateVector X_expected(0.5, 0.5, 0.5);
+  KF3::StateVector X_actual;
+  kf.getX(X_actual);
+  ASSERT_TRUE((X_actual - X_expected).norm() < 1.0E-6) << "X_actual^T : "
+    << X_actual.transpose() << ", X_expected^T : " << X_expected.transpose();
+}
+
+TEST_F(KalmanFilterTestSuite, fixedSizeMatchesDynamic)
+{
+  typedef KalmanFilterN<4, 2, 2> KF4;
+  srand(1);
+  KF4::StateMatrix A = KF4::StateMatrix::Identity() + 0.1 * KF4::StateMatrix::Random();
+  KF4::InputMatrix B = KF4::InputMatrix::Random();
+  KF4::OutputMatrix C = KF4::OutputMatrix::Random();
+  KF4::StateMatrix Q = 0.01 * KF4::StateMatrix::Identity();
+  KF4::OutputCovariance R = 0.1 * KF4::OutputCovariance::Identity();
+  KF4::StateVector x = KF4::StateVector::Random();
+  KF4::StateMatrix P = KF4::StateMatrix::Identity();
+
+  KalmanFilter kf(x, A, B, C, Q, R, P);
+  KF4 kf_n(x, A, B, C, Q, R, P);
+
+  for (int i = 0; i < 100; ++i)
+  {
+    KF4::InputVector u = KF4::InputVector::Random();
+    KF4::OutputVector y = KF4::OutputVector::Random();
+    Eigen::Matrix<double, 1, 4> C1 = Eigen::Matrix<double, 1, 4>::Random();
+    Eigen::Matrix<double, 1, 1> y1 = Eigen::Matrix<double, 1, 1>::Random();
+    Eigen::Matrix<double, 1, 1> R1 = Eigen::Matrix<double, 1, 1>::Constant(0.2);
+
+    ASSERT_EQ(true, kf.predict(u));
+    ASSERT_EQ(true, kf.update(y));
+    ASSERT_EQ(true, kf.update(y1, C1, R1));
+    Eigen::internal::set_is_malloc_allowed(false);
+    bool ok = kf_n.predict(u) && kf_n.update(y) && kf_n.update<1>(y1, C1, R1);
+    Eigen::internal::set_is_malloc_allowed(true);
+    ASSERT_EQ(true, ok);
+  }
+
+  Eigen::MatrixXd X, P_dyn;
+  kf.getX(X);
+  kf.getP(P_dyn);
+  KF4::StateVector X_n;
+  KF4::StateMatrix P_n;
+  kf_n.getX(X_n);
+  kf_n.getP(P_n);
+  ASSERT_TRUE((X - X_n).norm() < 1.0E-9) << "X^T : " << X.transpose() << ", X_n^T : " << X_n.transpose();
+  ASSERT_TRUE((P_dyn - P_n).norm() < 1.0E-9) << "P : " << P_dyn << ", P_n : " << P_n;
+}
+
+TEST_F(KalmanFilterTestSuite, fixedSizeDelayedMeasurementMatchesDynamic)
+{
+  typedef TimeDelayKalmanFilterN<3> TDKF3;
+  TimeDelayKalmanFilter tdkf;
+  TDKF3 tdkf_n;
+  TDKF3::StateVector x = TDKF3::StateVector::Zero();
+  TDKF3::StateMatrix P = TDKF3::StateMatrix::Identity();
+  TDKF3::StateMatrix A = TDKF3::StateMatrix::Identity();
+  A(0, 1) = 0.1;
+  A(1, 2) = 0.1;
+  TDKF3::StateMatrix Q = 0.01 * TDKF3::StateMatrix::Identity();
+  Eigen::Matrix<double, 2, 3> C = Eigen::Matrix<double, 2, 3>::Zero();
+  C(0, 0) = 1.0;
+  C(1, 2) = 1.0;
+  Eigen::Matrix2d R = 0.1 * Eigen::Matrix2d::Identity();
+  int max_delay_step = 5;
+
+  tdkf.init(x, P, max_delay_step);
+  tdkf_n.init(x, P, max_delay_step);
+
+  // long enough for rounding asymmetry in P to show if it were amplified
+  srand(2);
+  for (int i = 0; i < 1000; ++i)
+  {
+    TDKF3::StateVector x_curr;
+    tdkf_n.getLatestX(x_curr);
+    TDKF3::StateVector x_next = A * x_curr + 0.01 * TDKF3::StateVector::Random();
+    Eigen::Vector2d y = Eigen::Vector2d::Random();
+    int delay_step = i % max_delay_step;
+
+    ASSERT_EQ(true, tdkf.predictWithDelay(x_next, A, Q));
+    ASSERT_EQ(true, tdkf.updateWithDelay(y, C, R, delay_step));
+    Eigen::internal::set_is_malloc_allowed(false);
+    bool ok = tdkf_n.predictWithDelay(x_next, A, Q) && tdkf_n.updateWithDelay<2>(y, C, R, delay_step);
+    Eigen::internal::set_is_malloc_allowed(true);
+    ASSERT_EQ(true, ok);
+  }
+  Eigen::Vector2d y = Eigen::Vector2d::Zero();
+  ASSERT_EQ(false, tdkf_n.updateWithDelay<2>(y, C, R, max_delay_step)) << "delay too long, false expected";
+
+  Eigen::MatrixXd X, P_dyn;
+  Eigen::VectorXd X_n;
+  Eigen::MatrixXd P_n;
+  tdkf.getX(X);
+  tdkf.getP(P_dyn);
+  tdkf_n.getX(X_n);
+  tdkf_n.getP(P_n);
+  ASSERT_TRUE((X - X_n).norm() < 1.0E-9) << "X^T : " << X.transpose() << ", X_n^T : " << X_n.transpose();
+  ASSERT_TRUE((P_dyn - P_n).norm() < 1.0E-9);
+
+  // the accessors of the base class see the same newest first order
+  KalmanFilter &kf_base = tdkf;
+  Eigen::MatrixXd X_base, P_base;
+  kf_base.getX(X_base);
+  kf_base.getP(P_base);
+  ASSERT_TRUE((X - X_base).norm() < 1.0E-9);
+  ASSERT_TRUE((P_dyn - P_base).norm() < 1.0E-9);
+  for (int i = 0; i < X.rows(); ++i)
+  {
+    ASSERT_DOUBLE_EQ(X(i, 0), kf_base.getXelement(i));
+  }
+}
+
+TEST_F(KalmanFilterTestSuite, delayedCovarianceShift)
+{
+  typedef TimeDelayKalmanFilterN<2> TDKF2;
+  TimeDelayKalmanFilter tdkf;
+  TDKF2 tdkf_n;
+  TDKF2::StateVector x = TDKF2::StateVector::Zero();
+  TDKF2::StateMatrix P = TDKF2::StateMatrix::Identity();
+  TDKF2::StateMatrix A = TDKF2::StateMatrix::Identity() * 2.0;
+  TDKF2::StateMatrix Q = TDKF2::StateMatrix::Identity();
+  int max_delay_step = 4;
+
+  tdkf.init(x, P, max_delay_step);
+  tdkf_n.init(x, P, max_delay_step);
+
+  // wrap around the ring more than once, the blocks follow the steps
+  for (int i = 0; i < 2 * max_delay_step + 2; ++i)
+  {
+    TDKF2::StateVector x_next = TDKF2::StateVector::Constant(i);
+    tdkf.predictWithDelay(x_next, A, Q);
+    tdkf_n.predictWithDelay(x_next, A, Q);
+  }
+
+  /*
+   * from P = I, each prediction gives P11 = 4 * P11 + 1 and P1j = 2 * P1(j-1)
+   * for the steps before it, per element of the diagonal blocks.
+   */
+  Eigen::Matrix4d P_scalar = Eigen::Matrix4d::Identity();
+  for (int i = 0; i < 2 * max_delay_step + 2; ++i)
+  {
+    Eigen::Matrix4d A_ex = Eigen::Matrix4d::Zero();
+    A_ex(0, 0) = 2.0;
+    A_ex.bottomLeftCorner(3, 3) = Eigen::Matrix3d::Identity();
+    P_scalar = A_ex * P_scalar * A_ex.transpose();
+    P_scalar(0, 0) += 1.0;
+  }
+  Eigen::MatrixXd P_expected = Eigen::MatrixXd::Zero(8, 8);
+  Eigen::VectorXd X_expected(8);
+  for (int i = 0; i < max_delay_step; ++i)
+  {
+    X_expected.segment(i * 2, 2) = Eigen::Vector2d::Constant(2 * max_delay_step + 1 - i);
+    for (int j = 0; j < max_delay_step; ++j)
+    {
+      P_expected.block(i * 2, j * 2, 2, 2) = P_scalar(i, j) * Eigen::Matrix2d::Identity();
+    }
+  }
+
+  Eigen::MatrixXd X, P_dyn;
+  Eigen::VectorXd X_n;
+  Eigen::MatrixXd P_n;
+  tdkf.getX(X);
+  tdkf.getP(P_dyn);
+  tdkf_n.getX(X_n);
+  tdkf_n.getP(P_n);
+  ASSERT_TRUE((X - X_expected).norm() < 1.0E-9) << "X^T : " << X.transpose();
+  ASSERT_TRUE((X_n - X_expected).norm() < 1.0E-9) << "X_n^T : " << X_n.transpose();
+  ASSERT_TRUE((P_dyn - P_expected).norm() < 1.0E-9) << "P : " << P_dyn << ", P_expected : " << P_expected;
+  ASSERT_TRUE((P_n - P_expected).norm() < 1.0E-9) << "P_n : " << P_n << ", P_expected : " << P_expected;
+
+  TDKF2::StateVector x_delayed;
+  TDKF2::StateMatrix P_delayed;
+  tdkf_n.getDelayedX(x_delayed, 2);
+  tdkf_n.getDelayedP(P_delayed, 2);
+  ASSERT_TRUE((x_delayed - X_expected.segment(4, 2)).norm() < 1.0E-9);
+  ASSERT_TRUE((P_delayed - P_expected.block(4, 4, 2, 2)).norm() < 1.0E-9);
+}
+
 int main(int argc, char **argv)
 {
   testing::InitGoogleTest(&argc, argv);
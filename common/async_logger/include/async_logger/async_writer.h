@@ -0,0 +1,91 @@
+/*
+    Formula Student Driverless Project (FSD-Project).
+    Copyright (c) 2019:
+     - chentairan <killasipilin@gmail.com>
+
+    FSD-Project is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FSD-Project is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FSD-Project.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef ASYNC_LOGGER_ASYNC_WRITER_H
+#define ASYNC_LOGGER_ASYNC_WRITER_H
+
+#include "async_logger/column_log.h"
+#include "async_logger/log_row.h"
+#include "async_logger/spsc_queue.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace async_logger {
+
+enum class LogFormat {
+  CSV,     // one text line per row
+  COLUMN   // chunked columnar binary, see column_log.h
+};
+
+/*
+  Row writer for the recording nodes. The node thread only copies the row into
+  a lock-free queue, a background thread formats the rows and writes them in
+  batches without flushing every line, so a slow disk never stalls the caller.
+  When the queue is full the row is dropped and counted instead of blocking.
+*/
+class AsyncWriter {
+
+ public:
+  // Constructor
+  explicit AsyncWriter(size_t queue_capacity = 4096);
+  ~AsyncWriter();
+
+  AsyncWriter(const AsyncWriter &) = delete;
+  AsyncWriter &operator=(const AsyncWriter &) = delete;
+
+  // Getters
+  bool isOpen() const;
+  uint64_t getQueuedRows() const;
+  uint64_t getDroppedRows() const;
+  uint64_t getWrittenRows() const;
+
+  // Methods
+  // Create the file, write the header and start the writer thread,
+  // header holds the comma separated column names starting with the frame
+  bool open(const std::string &filename, const std::string &header, LogFormat format = LogFormat::CSV);
+  // Write out every queued row, stop the writer thread and close the file
+  void close();
+  // Never blocks, false if the row was dropped
+  bool push(const LogRow &row);
+
+ private:
+  SpscQueue<LogRow> queue;
+  FILE *file;
+  std::unique_ptr<ColumnLogWriter> column_writer;
+  std::thread writer_thread;
+  std::atomic<bool> running;
+
+  std::atomic<uint64_t> pushed_rows;
+  std::atomic<uint64_t> dropped_rows;
+  std::atomic<uint64_t> written_rows;
+
+  bool isFileOpen() const;
+  void writeRow(const LogRow &row, std::string &batch);
+  void writeBatch(std::string &batch);
+  void flushFile();
+  void writerLoop();
+};
+}
+
+#endif //ASYNC_LOGGER_ASYNC_WRITER_H
@@ -0,0 +1,235 @@
+/*
+    Formula Student Driverless Project (FSD-Project).
+    Copyright (c) 2019:
+     - chentairan <killasipilin@gmail.com>
+
+    FSD-Project is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FSD-Project is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FSD-Project.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef ASYNC_LOGGER_COLUMN_LOG_H
+#define ASYNC_LOGGER_COLUMN_LOG_H
+
+#include "async_logger/log_row.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace async_logger {
+
+/*
+  Chunked columnar binary log, native (little endian) byte order:
+    ColumnLogHeader
+    ColumnDesc[header.num_columns]
+    { ChunkHeader, payload padded to 8 bytes } per chunk
+    ChunkIndexEntry[trailer.num_chunks]
+    ColumnLogTrailer
+  The payload of a chunk stores every column as num_rows fixed-width 8 byte
+  values, one column after the other. Column 0 is the int64 frame counter, the
+  others are doubles. Uncompressed chunks are read straight from a memory
+  mapping. The chunk index gives the time range of every chunk, so a reader can
+  seek to a timestamp without touching the rest of the file. A file without
+  trailer (the logger did not shut down) is recovered by walking the chunks.
+*/
+const char COLUMN_LOG_MAGIC[8] = {'Z', 'Y', 'C', 'O', 'L', 'O', 'G', '\0'};
+const char COLUMN_LOG_INDEX_MAGIC[8] = {'Z', 'Y', 'C', 'O', 'L', 'I', 'D', 'X'};
+const uint32_t COLUMN_LOG_VERSION = 1;
+
+const uint32_t COLUMN_TYPE_INT64 = 0;
+const uint32_t COLUMN_TYPE_FLOAT64 = 1;
+
+// chunk codec id of uncompressed chunks
+const uint32_t CHUNK_CODEC_NONE = 0;
+
+struct ColumnLogHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t num_columns;
+  uint32_t chunk_rows;
+  int32_t time_column;  // -1 if the log has no time column
+};
+
+struct ColumnDesc {
+  char name[24];
+  uint32_t type;
+  uint32_t reserved;
+};
+
+struct ChunkHeader {
+  uint32_t num_rows;
+  uint32_t codec;
+  uint64_t raw_bytes;
+  uint64_t stored_bytes;
+  uint64_t first_row;
+  double time_begin;
+  double time_end;
+};
+
+struct ChunkIndexEntry {
+  uint64_t offset;  // of the ChunkHeader
+  uint64_t first_row;
+  uint32_t num_rows;
+  uint32_t codec;
+  double time_begin;
+  double time_end;
+};
+
+struct ColumnLogTrailer {
+  uint64_t index_offset;
+  uint64_t num_chunks;
+  uint64_t num_rows;
+  char magic[8];
+};
+
+static_assert(sizeof(ColumnLogHeader) == 24, "unexpected ColumnLogHeader layout");
+static_assert(sizeof(ColumnDesc) == 32, "unexpected ColumnDesc layout");
+static_assert(sizeof(ChunkHeader) == 48, "unexpected ChunkHeader layout");
+static_assert(sizeof(ChunkIndexEntry) == 40, "unexpected ChunkIndexEntry layout");
+static_assert(sizeof(ColumnLogTrailer) == 32, "unexpected ColumnLogTrailer layout");
+
+/*
+  Compression hook for chunk payloads, e.g. an LZ4 block codec. The writer
+  keeps a chunk uncompressed when compress() fails or does not save space,
+  the reader needs a codec with the same id to decode compressed chunks.
+*/
+class ChunkCodec {
+
+ public:
+  virtual ~ChunkCodec() {}
+
+  // Stored in the chunk header, must not be CHUNK_CODEC_NONE
+  virtual uint32_t getId() const = 0;
+  virtual bool compress(const char *src, size_t size, std::vector<char> &dst) = 0;
+  // dst holds raw_size bytes
+  virtual bool decompress(const char *src, size_t size, char *dst, size_t raw_size) = 0;
+};
+
+class ColumnLogWriter {
+
+ public:
+  // Constructor
+  ColumnLogWriter();
+  ~ColumnLogWriter();
+  ColumnLogWriter(const ColumnLogWriter &) = delete;
+  ColumnLogWriter &operator=(const ColumnLogWriter &) = delete;
+
+  // Getters
+  bool isOpen() const { return file != nullptr; }
+  uint64_t getRowNum() const { return row_num; }
+
+  // Setters
+  void setCodec(const std::shared_ptr<ChunkCodec> &codec_ptr);
+
+  // Methods
+  // column_names[0] is the frame column, time_column indexes column_names
+  bool open(const std::string &filename, const std::vector<std::string> &column_names,
+            int time_column, uint32_t chunk_rows = 256);
+  // Missing values are written as 0, extra values are ignored
+  bool append(const LogRow &row);
+  // Write the buffered rows as a chunk
+  bool flushChunk();
+  // Write the buffered rows as a chunk and hand the file buffer to the OS
+  bool flush();
+  // Write the last chunk and the chunk index
+  bool close();
+
+ private:
+  FILE *file;
+  std::shared_ptr<ChunkCodec> codec;
+
+  uint32_t num_columns;
+  uint32_t chunk_rows;
+  int time_column;
+  uint64_t file_offset;
+  uint64_t row_num;
+
+  // column major, chunk_rows values per column
+  std::vector<char> chunk_buffer;
+  std::vector<char> compressed_buffer;
+  uint32_t chunk_size;
+  double chunk_time_begin;
+  double chunk_time_end;
+
+  std::vector<ChunkIndexEntry> chunk_index;
+
+  bool writeBytes(const void *data, size_t size);
+};
+
+class ColumnLogReader {
+
+ public:
+  // Constructor
+  ColumnLogReader();
+  ~ColumnLogReader();
+  ColumnLogReader(const ColumnLogReader &) = delete;
+  ColumnLogReader &operator=(const ColumnLogReader &) = delete;
+
+  // Getters
+  bool isOpen() const { return map_addr != nullptr; }
+  uint64_t getRowNum() const { return row_num; }
+  int getColumnNum() const { return static_cast<int>(column_names.size()); }
+  size_t getChunkNum() const { return chunk_index.size(); }
+  const std::string &getColumnName(int column) const { return column_names.at(column); }
+  int findColumn(const std::string &name) const;
+  double getTimeBegin() const;
+  double getTimeEnd() const;
+  size_t fileBytes() const { return map_length; }
+  const std::string &getError() const { return error; }
+
+  // Setters
+  void setCodec(const std::shared_ptr<ChunkCodec> &codec_ptr);
+
+  // Methods
+  // True if the file starts with the column log magic
+  static bool isColumnLog(const std::string &filename);
+  bool open(const std::string &filename);
+  void close();
+  // First row recorded at or after time, getRowNum() if there is none
+  uint64_t findRow(double time);
+  // Frame in row.frame, the other columns in row.values
+  bool readRow(uint64_t row, LogRow &out);
+  // Drop the mapped pages of the chunks before row, keeps a sequential reader's memory bounded
+  void releaseRows(uint64_t row);
+
+ private:
+  void *map_addr;
+  size_t map_length;
+
+  std::vector<std::string> column_names;
+  std::vector<uint32_t> column_types;
+  int time_column;
+  uint64_t row_num;
+  std::vector<ChunkIndexEntry> chunk_index;
+
+  std::shared_ptr<ChunkCodec> codec;
+  // last decompressed chunk
+  int64_t cached_chunk;
+  std::vector<char> cached_payload;
+
+  std::string error;
+
+  bool loadIndex(size_t data_offset);
+  bool recoverIndex(size_t data_offset);
+  // A well formed ChunkHeader at offset whose payload ends before end
+  bool isValidChunk(size_t offset, size_t end, uint64_t first_row) const;
+  size_t findChunk(uint64_t row) const;
+  const char *getChunkPayload(size_t chunk);
+  double getValue(const char *payload, size_t chunk, int column, uint32_t row) const;
+};
+}
+
+#endif //ASYNC_LOGGER_COLUMN_LOG_H
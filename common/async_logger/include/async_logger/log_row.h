@@ -0,0 +1,37 @@
+/*
+    Formula Student Driverless Project (FSD-Project).
+    Copyright (c) 2019:
+     - chentairan <killasipilin@gmail.com>
+
+    FSD-Project is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FSD-Project is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FSD-Project.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef ASYNC_LOGGER_LOG_ROW_H
+#define ASYNC_LOGGER_LOG_ROW_H
+
+#include <cstdint>
+
+namespace async_logger {
+
+const int MAX_LOG_COLUMNS = 16;
+
+// One log row: the frame counter followed by up to MAX_LOG_COLUMNS values
+struct LogRow {
+  int64_t frame;
+  int size;
+  double values[MAX_LOG_COLUMNS];
+};
+}
+
+#endif //ASYNC_LOGGER_LOG_ROW_H
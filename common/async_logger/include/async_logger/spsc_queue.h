@@ -0,0 +1,96 @@
+/*
+    Formula Student Driverless Project (FSD-Project).
+    Copyright (c) 2019:
+     - chentairan <killasipilin@gmail.com>
+
+    FSD-Project is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FSD-Project is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FSD-Project.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef ASYNC_LOGGER_SPSC_QUEUE_H
+#define ASYNC_LOGGER_SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace async_logger {
+
+/*
+  Bounded lock-free queue for exactly one producer and one consumer thread.
+  push() and pop() never block and never allocate, the storage is allocated
+  once in the constructor.
+*/
+template <typename T>
+class SpscQueue {
+
+ public:
+  // Constructor, capacity is rounded up to a power of two
+  explicit SpscQueue(size_t capacity) : head_(0), tail_(0) {
+    size_t size = 1;
+    while (size < capacity) {
+      size <<= 1;
+    }
+    buffer_.resize(size);
+    mask_ = size - 1;
+  }
+
+  SpscQueue(const SpscQueue &) = delete;
+  SpscQueue &operator=(const SpscQueue &) = delete;
+
+  // Getters
+  size_t capacity() const { return buffer_.size(); }
+  size_t size() const {
+    // head first: the tail loaded after it can only be further ahead, never behind
+    const size_t head = head_.load(std::memory_order_acquire);
+    return tail_.load(std::memory_order_acquire) - head;
+  }
+  bool empty() const { return size() == 0; }
+
+  // Methods
+  // Producer side, false if the queue is full
+  bool push(const T &item) {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) == buffer_.size()) {
+      return false;
+    }
+    buffer_[tail & mask_] = item;
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side, false if the queue is empty
+  bool pop(T &item) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    item = buffer_[head & mask_];
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+ private:
+  std::vector<T> buffer_;
+  size_t mask_;
+
+  // keep the indices on separate cache lines, each is written by one thread only
+  char pad0_[64];
+  std::atomic<size_t> head_;  // next slot to pop, written by the consumer
+  char pad1_[64];
+  std::atomic<size_t> tail_;  // next slot to push, written by the producer
+  char pad2_[64];
+};
+}
+
+#endif //ASYNC_LOGGER_SPSC_QUEUE_H
@@ -0,0 +1,201 @@
+/*
+    Formula Student Driverless Project (FSD-Project).
+    Copyright (c) 2019:
+     - chentairan <killasipilin@gmail.com>
+
+    FSD-Project is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FSD-Project is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FSD-Project.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "async_logger/async_writer.h"
+
+#include <chrono>
+#include <cinttypes>
+#include <sstream>
+#include <vector>
+
+namespace async_logger {
+
+namespace {
+// bytes formatted before a batch is handed to fwrite
+const size_t BATCH_BYTES = 64 * 1024;
+// stdio buffer of the record file, written to disk when full
+const size_t FILE_BUFFER_BYTES = 1024 * 1024;
+// sleep of the writer thread while the queue is empty
+const std::chrono::milliseconds IDLE_SLEEP(2);
+// upper bound of the data lost when the process dies
+const std::chrono::seconds FLUSH_PERIOD(1);
+
+// same text as std::to_string(double)
+size_t formatRow(const LogRow &row, char *out, size_t out_size) {
+  int len = snprintf(out, out_size, "%" PRId64, row.frame);
+  size_t pos = len > 0 ? len : 0;
+  for (int i = 0; i < row.size && i < MAX_LOG_COLUMNS && pos < out_size; i++) {
+    len = snprintf(out + pos, out_size - pos, ",%f", row.values[i]);
+    pos += len > 0 ? len : 0;
+  }
+  if (pos >= out_size) {
+    pos = out_size - 1;
+  }
+  out[pos++] = '\n';
+  return pos;
+}
+}
+
+// Constructor
+AsyncWriter::AsyncWriter(size_t queue_capacity) : queue(queue_capacity), file(nullptr), running(false),
+    pushed_rows(0), dropped_rows(0), written_rows(0) {
+}
+
+AsyncWriter::~AsyncWriter() {
+  close();
+}
+
+// Getters
+bool AsyncWriter::isOpen() const { return isFileOpen(); }
+uint64_t AsyncWriter::getQueuedRows() const { return queue.size(); }
+uint64_t AsyncWriter::getDroppedRows() const { return dropped_rows.load(std::memory_order_relaxed); }
+uint64_t AsyncWriter::getWrittenRows() const { return written_rows.load(std::memory_order_relaxed); }
+
+// Methods
+bool AsyncWriter::open(const std::string &filename, const std::string &header, LogFormat format) {
+  close();
+  if (format == LogFormat::COLUMN) {
+    std::vector<std::string> column_names;
+    std::stringstream ss(header);
+    std::string name;
+    while (std::getline(ss, name, ',')) {
+      column_names.push_back(name);
+    }
+    int time_column = -1;
+    for (size_t i = 0; i < column_names.size(); i++) {
+      if (column_names[i] == "time") {
+        time_column = i;
+      }
+    }
+    column_writer.reset(new ColumnLogWriter);
+    if (!column_writer->open(filename, column_names, time_column)) {
+      column_writer.reset();
+      return false;
+    }
+  } else {
+    file = fopen(filename.c_str(), "w");
+    if (file == nullptr) {
+      return false;
+    }
+    setvbuf(file, nullptr, _IOFBF, FILE_BUFFER_BYTES);
+    fputs(header.c_str(), file);
+    fputc('\n', file);
+  }
+
+  pushed_rows = 0;
+  dropped_rows = 0;
+  written_rows = 0;
+  running = true;
+  writer_thread = std::thread(&AsyncWriter::writerLoop, this);
+  return true;
+}
+
+void AsyncWriter::close() {
+  if (!isFileOpen()) {
+    return;
+  }
+  running = false;
+  if (writer_thread.joinable()) {
+    writer_thread.join();
+  }
+  if (column_writer) {
+    column_writer->close();
+    column_writer.reset();
+  }
+  if (file != nullptr) {
+    fclose(file);
+    file = nullptr;
+  }
+}
+
+bool AsyncWriter::push(const LogRow &row) {
+  if (!running.load(std::memory_order_relaxed) || !queue.push(row)) {
+    dropped_rows.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  pushed_rows.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+bool AsyncWriter::isFileOpen() const {
+  return file != nullptr || column_writer;
+}
+
+void AsyncWriter::writeRow(const LogRow &row, std::string &batch) {
+  if (column_writer) {
+    // the column writer buffers a whole chunk by itself
+    column_writer->append(row);
+    return;
+  }
+  char line[1024];
+  batch.append(line, formatRow(row, line, sizeof(line)));
+  if (batch.size() >= BATCH_BYTES) {
+    writeBatch(batch);
+  }
+}
+
+void AsyncWriter::writeBatch(std::string &batch) {
+  if (!batch.empty()) {
+    fwrite(batch.data(), 1, batch.size(), file);
+    batch.clear();
+  }
+}
+
+void AsyncWriter::flushFile() {
+  if (file != nullptr) {
+    fflush(file);
+  }
+  if (column_writer) {
+    // a partial chunk is fine, the reader handles chunks of any size
+    column_writer->flush();
+  }
+}
+
+void AsyncWriter::writerLoop() {
+  std::string batch;
+  batch.reserve(BATCH_BYTES + 1024);
+  LogRow row;
+  std::chrono::steady_clock::time_point last_flush = std::chrono::steady_clock::now();
+
+  while (true) {
+    // read the flag before draining, so rows pushed before close() are never lost
+    bool stop = !running.load(std::memory_order_acquire);
+    uint64_t rows = 0;
+    while (queue.pop(row)) {
+      writeRow(row, batch);
+      rows++;
+    }
+    writeBatch(batch);
+    written_rows.fetch_add(rows, std::memory_order_relaxed);
+
+    if (stop) {
+      break;
+    }
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (now - last_flush >= FLUSH_PERIOD) {
+      flushFile();
+      last_flush = now;
+    }
+    if (rows == 0) {
+      std::this_thread::sleep_for(IDLE_SLEEP);
+    }
+  }
+  flushFile();
+}
+}
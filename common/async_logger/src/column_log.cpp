@@ -0,0 +1,498 @@
+/*
+    Formula Student Driverless Project (FSD-Project).
+    Copyright (c) 2019:
+     - chentairan <killasipilin@gmail.com>
+
+    FSD-Project is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FSD-Project is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FSD-Project.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "async_logger/column_log.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace async_logger {
+
+namespace {
+size_t alignTo8(size_t size) {
+  return (size + 7) & ~static_cast<size_t>(7);
+}
+}
+
+// Constructor
+ColumnLogWriter::ColumnLogWriter() :
+    file(nullptr),
+    num_columns(0),
+    chunk_rows(0),
+    time_column(-1),
+    file_offset(0),
+    row_num(0),
+    chunk_size(0),
+    chunk_time_begin(0),
+    chunk_time_end(0) {
+}
+
+ColumnLogWriter::~ColumnLogWriter() {
+  close();
+}
+
+// Setters
+void ColumnLogWriter::setCodec(const std::shared_ptr<ChunkCodec> &codec_ptr) {
+  codec = codec_ptr;
+}
+
+// Methods
+bool ColumnLogWriter::open(const std::string &filename, const std::vector<std::string> &column_names,
+                           int time_column_id, uint32_t rows_per_chunk) {
+  close();
+  if (column_names.empty() || column_names.size() > MAX_LOG_COLUMNS + 1 || rows_per_chunk == 0) {
+    return false;
+  }
+  file = fopen(filename.c_str(), "wb");
+  if (file == nullptr) {
+    return false;
+  }
+  num_columns = column_names.size();
+  chunk_rows = rows_per_chunk;
+  time_column = (time_column_id > 0 && time_column_id < static_cast<int>(num_columns)) ? time_column_id : -1;
+  file_offset = 0;
+  row_num = 0;
+  chunk_size = 0;
+  chunk_index.clear();
+  chunk_buffer.assign(static_cast<size_t>(num_columns) * chunk_rows * sizeof(double), 0);
+
+  ColumnLogHeader header;
+  std::memcpy(header.magic, COLUMN_LOG_MAGIC, sizeof(header.magic));
+  header.version = COLUMN_LOG_VERSION;
+  header.num_columns = num_columns;
+  header.chunk_rows = chunk_rows;
+  header.time_column = time_column;
+  bool ok = writeBytes(&header, sizeof(header));
+  for (uint32_t i = 0; i < num_columns; i++) {
+    ColumnDesc desc;
+    std::memset(&desc, 0, sizeof(desc));
+    std::strncpy(desc.name, column_names[i].c_str(), sizeof(desc.name) - 1);
+    desc.type = (i == 0) ? COLUMN_TYPE_INT64 : COLUMN_TYPE_FLOAT64;
+    ok = writeBytes(&desc, sizeof(desc)) && ok;
+  }
+  if (!ok) {
+    fclose(file);
+    file = nullptr;
+  }
+  return ok;
+}
+
+bool ColumnLogWriter::append(const LogRow &row) {
+  if (file == nullptr) {
+    return false;
+  }
+  char *base = chunk_buffer.data();
+  std::memcpy(base + chunk_size * sizeof(int64_t), &row.frame, sizeof(int64_t));
+  for (uint32_t c = 1; c < num_columns; c++) {
+    double value = (static_cast<int>(c) <= row.size) ? row.values[c - 1] : 0.0;
+    std::memcpy(base + (static_cast<size_t>(c) * chunk_rows + chunk_size) * sizeof(double), &value, sizeof(double));
+  }
+  if (time_column > 0) {
+    double time = (time_column <= row.size) ? row.values[time_column - 1] : 0.0;
+    if (chunk_size == 0) {
+      chunk_time_begin = time;
+    }
+    chunk_time_end = time;
+  }
+  chunk_size += 1;
+  row_num += 1;
+  if (chunk_size == chunk_rows) {
+    return flushChunk();
+  }
+  return true;
+}
+
+bool ColumnLogWriter::flushChunk() {
+  if (file == nullptr || chunk_size == 0) {
+    return true;
+  }
+  // pack the columns of a partial chunk next to each other
+  char *base = chunk_buffer.data();
+  const size_t column_bytes = static_cast<size_t>(chunk_size) * sizeof(double);
+  if (chunk_size < chunk_rows) {
+    for (uint32_t c = 1; c < num_columns; c++) {
+      std::memmove(base + c * column_bytes, base + static_cast<size_t>(c) * chunk_rows * sizeof(double), column_bytes);
+    }
+  }
+  const size_t raw_bytes = column_bytes * num_columns;
+
+  ChunkHeader header;
+  header.num_rows = chunk_size;
+  header.codec = CHUNK_CODEC_NONE;
+  header.raw_bytes = raw_bytes;
+  header.stored_bytes = raw_bytes;
+  header.first_row = row_num - chunk_size;
+  header.time_begin = chunk_time_begin;
+  header.time_end = chunk_time_end;
+
+  const char *payload = base;
+  if (codec && codec->getId() != CHUNK_CODEC_NONE) {
+    compressed_buffer.clear();
+    if (codec->compress(base, raw_bytes, compressed_buffer) && compressed_buffer.size() < raw_bytes) {
+      header.codec = codec->getId();
+      header.stored_bytes = compressed_buffer.size();
+      payload = compressed_buffer.data();
+    }
+  }
+
+  ChunkIndexEntry entry;
+  entry.offset = file_offset;
+  entry.first_row = header.first_row;
+  entry.num_rows = header.num_rows;
+  entry.codec = header.codec;
+  entry.time_begin = header.time_begin;
+  entry.time_end = header.time_end;
+  chunk_index.push_back(entry);
+
+  static const char padding[8] = {0};
+  bool ok = writeBytes(&header, sizeof(header)) &&
+            writeBytes(payload, header.stored_bytes) &&
+            writeBytes(padding, alignTo8(header.stored_bytes) - header.stored_bytes);
+  chunk_size = 0;
+  return ok;
+}
+
+bool ColumnLogWriter::flush() {
+  if (file == nullptr) {
+    return true;
+  }
+  bool ok = flushChunk();
+  return (fflush(file) == 0) && ok;
+}
+
+bool ColumnLogWriter::close() {
+  if (file == nullptr) {
+    return true;
+  }
+  bool ok = flushChunk();
+  ColumnLogTrailer trailer;
+  trailer.index_offset = file_offset;
+  trailer.num_chunks = chunk_index.size();
+  trailer.num_rows = row_num;
+  std::memcpy(trailer.magic, COLUMN_LOG_INDEX_MAGIC, sizeof(trailer.magic));
+  ok = (chunk_index.empty() || writeBytes(chunk_index.data(), chunk_index.size() * sizeof(ChunkIndexEntry))) && ok;
+  ok = writeBytes(&trailer, sizeof(trailer)) && ok;
+  ok = (fclose(file) == 0) && ok;
+  file = nullptr;
+  return ok;
+}
+
+bool ColumnLogWriter::writeBytes(const void *data, size_t size) {
+  if (size == 0) {
+    return true;
+  }
+  size_t written = fwrite(data, 1, size, file);
+  file_offset += written;
+  return written == size;
+}
+
+// Constructor
+ColumnLogReader::ColumnLogReader() :
+    map_addr(nullptr),
+    map_length(0),
+    time_column(-1),
+    row_num(0),
+    cached_chunk(-1) {
+}
+
+ColumnLogReader::~ColumnLogReader() {
+  close();
+}
+
+// Getters
+int ColumnLogReader::findColumn(const std::string &name) const {
+  for (size_t i = 0; i < column_names.size(); i++) {
+    if (column_names[i] == name) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+double ColumnLogReader::getTimeBegin() const {
+  return chunk_index.empty() ? 0.0 : chunk_index.front().time_begin;
+}
+
+double ColumnLogReader::getTimeEnd() const {
+  return chunk_index.empty() ? 0.0 : chunk_index.back().time_end;
+}
+
+// Setters
+void ColumnLogReader::setCodec(const std::shared_ptr<ChunkCodec> &codec_ptr) {
+  codec = codec_ptr;
+  cached_chunk = -1;
+}
+
+// Methods
+bool ColumnLogReader::isColumnLog(const std::string &filename) {
+  char magic[sizeof(COLUMN_LOG_MAGIC)] = {0};
+  FILE *file = fopen(filename.c_str(), "rb");
+  if (file == nullptr) {
+    return false;
+  }
+  bool ok = fread(magic, sizeof(magic), 1, file) == 1 && std::memcmp(magic, COLUMN_LOG_MAGIC, sizeof(magic)) == 0;
+  fclose(file);
+  return ok;
+}
+
+bool ColumnLogReader::open(const std::string &filename) {
+  close();
+  error.clear();
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    error = "cannot open " + filename + ": " + std::strerror(errno);
+    return false;
+  }
+  struct stat st;
+  if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(ColumnLogHeader))) {
+    ::close(fd);
+    error = filename + ": truncated header";
+    return false;
+  }
+  map_length = st.st_size;
+  map_addr = ::mmap(nullptr, map_length, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (map_addr == MAP_FAILED) {
+    map_addr = nullptr;
+    map_length = 0;
+    error = filename + ": mmap failed: " + std::strerror(errno);
+    return false;
+  }
+
+  const char *base = static_cast<const char *>(map_addr);
+  const ColumnLogHeader *header = reinterpret_cast<const ColumnLogHeader *>(base);
+  size_t data_offset = sizeof(ColumnLogHeader) + static_cast<size_t>(header->num_columns) * sizeof(ColumnDesc);
+  bool ok = false;
+  if (std::memcmp(header->magic, COLUMN_LOG_MAGIC, sizeof(header->magic)) != 0) {
+    error = "not a column log";
+  } else if (header->version != COLUMN_LOG_VERSION) {
+    error = "unsupported version " + std::to_string(header->version);
+  } else if (header->num_columns == 0 || header->num_columns > MAX_LOG_COLUMNS + 1 || data_offset > map_length) {
+    error = "bad column number " + std::to_string(header->num_columns);
+  } else if (header->time_column >= static_cast<int32_t>(header->num_columns)) {
+    error = "bad time column " + std::to_string(header->time_column);
+  } else {
+    const ColumnDesc *desc = reinterpret_cast<const ColumnDesc *>(base + sizeof(ColumnLogHeader));
+    for (uint32_t i = 0; i < header->num_columns; i++) {
+      column_names.push_back(std::string(desc[i].name, strnlen(desc[i].name, sizeof(desc[i].name))));
+      column_types.push_back(desc[i].type);
+    }
+    // column 0 is the frame column, the writer stores -1 for no time column
+    time_column = header->time_column > 0 ? header->time_column : -1;
+    ok = loadIndex(data_offset) || recoverIndex(data_offset);
+  }
+  if (!ok) {
+    error = filename + ": " + error;
+    std::string message = error;
+    close();
+    error = message;
+  }
+  return ok;
+}
+
+void ColumnLogReader::close() {
+  if (map_addr != nullptr) {
+    ::munmap(map_addr, map_length);
+  }
+  map_addr = nullptr;
+  map_length = 0;
+  column_names.clear();
+  column_types.clear();
+  time_column = -1;
+  row_num = 0;
+  chunk_index.clear();
+  cached_chunk = -1;
+  cached_payload.clear();
+}
+
+uint64_t ColumnLogReader::findRow(double time) {
+  if (time_column < 0 || chunk_index.empty()) {
+    return 0;
+  }
+  // first chunk that ends at or after time, then bisect its time column
+  std::vector<ChunkIndexEntry>::const_iterator it = std::lower_bound(
+      chunk_index.begin(), chunk_index.end(), time,
+      [](const ChunkIndexEntry &entry, double t) { return entry.time_end < t; });
+  if (it == chunk_index.end()) {
+    return row_num;
+  }
+  size_t chunk = it - chunk_index.begin();
+  const char *payload = getChunkPayload(chunk);
+  if (payload == nullptr) {
+    return it->first_row;
+  }
+  uint32_t lower = 0;
+  uint32_t upper = it->num_rows;
+  while (lower < upper) {
+    uint32_t mid = lower + (upper - lower) / 2;
+    if (getValue(payload, chunk, time_column, mid) < time) {
+      lower = mid + 1;
+    } else {
+      upper = mid;
+    }
+  }
+  return it->first_row + lower;
+}
+
+bool ColumnLogReader::readRow(uint64_t row, LogRow &out) {
+  if (row >= row_num) {
+    return false;
+  }
+  size_t chunk = findChunk(row);
+  const char *payload = getChunkPayload(chunk);
+  if (payload == nullptr) {
+    return false;
+  }
+  uint32_t r = static_cast<uint32_t>(row - chunk_index[chunk].first_row);
+  out.frame = static_cast<int64_t>(getValue(payload, chunk, 0, r));
+  out.size = getColumnNum() - 1;
+  for (int c = 1; c < getColumnNum(); c++) {
+    out.values[c - 1] = getValue(payload, chunk, c, r);
+  }
+  return true;
+}
+
+void ColumnLogReader::releaseRows(uint64_t row) {
+  if (chunk_index.empty() || row >= row_num) {
+    return;
+  }
+  // header and index are copied at open, the pages are only needed for the chunk payloads
+  const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+  const size_t release_bytes = chunk_index[findChunk(row)].offset / page * page;
+  if (release_bytes > 0) {
+    ::madvise(map_addr, release_bytes, MADV_DONTNEED);
+  }
+}
+
+bool ColumnLogReader::loadIndex(size_t data_offset) {
+  if (map_length < data_offset + sizeof(ColumnLogTrailer)) {
+    return false;
+  }
+  const char *base = static_cast<const char *>(map_addr);
+  const ColumnLogTrailer *trailer = reinterpret_cast<const ColumnLogTrailer *>(base + map_length - sizeof(ColumnLogTrailer));
+  if (std::memcmp(trailer->magic, COLUMN_LOG_INDEX_MAGIC, sizeof(trailer->magic)) != 0 ||
+      trailer->index_offset < data_offset ||
+      trailer->index_offset > map_length - sizeof(ColumnLogTrailer) ||
+      trailer->num_chunks > (map_length - sizeof(ColumnLogTrailer) - trailer->index_offset) / sizeof(ChunkIndexEntry)) {
+    return false;
+  }
+  // readRow() trusts the index, so every entry has to point at a chunk inside the data section
+  const ChunkIndexEntry *entries = reinterpret_cast<const ChunkIndexEntry *>(base + trailer->index_offset);
+  uint64_t first_row = 0;
+  for (uint64_t i = 0; i < trailer->num_chunks; i++) {
+    const ChunkIndexEntry &entry = entries[i];
+    if (entry.offset < data_offset || entry.offset > trailer->index_offset ||
+        !isValidChunk(entry.offset, trailer->index_offset, first_row)) {
+      return false;
+    }
+    const ChunkHeader *header = reinterpret_cast<const ChunkHeader *>(base + entry.offset);
+    if (entry.first_row != header->first_row || entry.num_rows != header->num_rows || entry.codec != header->codec) {
+      return false;
+    }
+    first_row += entry.num_rows;
+  }
+  if (first_row != trailer->num_rows) {
+    return false;
+  }
+  chunk_index.assign(entries, entries + trailer->num_chunks);
+  row_num = trailer->num_rows;
+  return true;
+}
+
+bool ColumnLogReader::recoverIndex(size_t data_offset) {
+  const char *base = static_cast<const char *>(map_addr);
+  chunk_index.clear();
+  row_num = 0;
+  size_t offset = data_offset;
+  while (isValidChunk(offset, map_length, row_num)) {
+    const ChunkHeader *header = reinterpret_cast<const ChunkHeader *>(base + offset);
+    ChunkIndexEntry entry;
+    entry.offset = offset;
+    entry.first_row = header->first_row;
+    entry.num_rows = header->num_rows;
+    entry.codec = header->codec;
+    entry.time_begin = header->time_begin;
+    entry.time_end = header->time_end;
+    chunk_index.push_back(entry);
+    row_num += header->num_rows;
+    offset += sizeof(ChunkHeader) + alignTo8(header->stored_bytes);
+  }
+  return true;
+}
+
+bool ColumnLogReader::isValidChunk(size_t offset, size_t end, uint64_t first_row) const {
+  if (end > map_length || offset > end || end - offset < sizeof(ChunkHeader)) {
+    return false;
+  }
+  const ChunkHeader *header = reinterpret_cast<const ChunkHeader *>(static_cast<const char *>(map_addr) + offset);
+  return header->num_rows != 0 && header->first_row == first_row &&
+         header->raw_bytes == static_cast<uint64_t>(header->num_rows) * column_names.size() * sizeof(double) &&
+         header->stored_bytes <= end - offset - sizeof(ChunkHeader) &&
+         (header->codec != CHUNK_CODEC_NONE || header->stored_bytes == header->raw_bytes);
+}
+
+size_t ColumnLogReader::findChunk(uint64_t row) const {
+  std::vector<ChunkIndexEntry>::const_iterator it = std::upper_bound(
+      chunk_index.begin(), chunk_index.end(), row,
+      [](uint64_t r, const ChunkIndexEntry &entry) { return r < entry.first_row; });
+  return (it - chunk_index.begin()) - 1;
+}
+
+const char *ColumnLogReader::getChunkPayload(size_t chunk) {
+  const ChunkIndexEntry &entry = chunk_index[chunk];
+  const char *base = static_cast<const char *>(map_addr);
+  const ChunkHeader *header = reinterpret_cast<const ChunkHeader *>(base + entry.offset);
+  const char *stored = base + entry.offset + sizeof(ChunkHeader);
+  if (entry.codec == CHUNK_CODEC_NONE) {
+    return stored;
+  }
+  if (cached_chunk == static_cast<int64_t>(chunk)) {
+    return cached_payload.data();
+  }
+  if (!codec || codec->getId() != entry.codec) {
+    error = "no codec for chunk codec id " + std::to_string(entry.codec);
+    return nullptr;
+  }
+  cached_payload.resize(header->raw_bytes);
+  if (!codec->decompress(stored, header->stored_bytes, cached_payload.data(), header->raw_bytes)) {
+    error = "failed to decompress chunk " + std::to_string(chunk);
+    cached_chunk = -1;
+    return nullptr;
+  }
+  cached_chunk = chunk;
+  return cached_payload.data();
+}
+
+double ColumnLogReader::getValue(const char *payload, size_t chunk, int column, uint32_t row) const {
+  const char *p = payload + (static_cast<size_t>(column) * chunk_index[chunk].num_rows + row) * sizeof(double);
+  if (column_types[column] == COLUMN_TYPE_INT64) {
+    int64_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return static_cast<double>(value);
+  }
+  double value;
+  std::memcpy(&value, p, sizeof(value));
+  return value;
+}
+}
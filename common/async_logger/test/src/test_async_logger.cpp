@@ -0,0 +1,325 @@
+/*
+    Formula Student Driverless Project (FSD-Project).
+    Copyright (c) 2019:
+     - chentairan <killasipilin@gmail.com>
+
+    FSD-Project is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FSD-Project is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FSD-Project.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <gtest/gtest.h>
+#include <ros/ros.h>
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+#include "async_logger/async_writer.h"
+#include "async_logger/column_log.h"
+#include "async_logger/spsc_queue.h"
+
+namespace async_logger {
+
+TEST(SpscQueue, pushAndPop) {
+  SpscQueue<int> queue(3);
+  ASSERT_EQ(4u, queue.capacity());
+  ASSERT_TRUE(queue.empty());
+
+  for (int i = 0; i < 4; i++) {
+    ASSERT_TRUE(queue.push(i));
+  }
+  ASSERT_FALSE(queue.push(4));
+  ASSERT_EQ(4u, queue.size());
+
+  int item;
+  for (int i = 0; i < 4; i++) {
+    ASSERT_TRUE(queue.pop(item));
+    ASSERT_EQ(i, item);
+  }
+  ASSERT_FALSE(queue.pop(item));
+}
+
+TEST(SpscQueue, twoThreads) {
+  const int num = 1000000;
+  SpscQueue<int> queue(1024);
+  std::thread producer([&queue, num]() {
+    for (int i = 0; i < num; i++) {
+      while (!queue.push(i)) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  int item;
+  for (int i = 0; i < num; i++) {
+    while (!queue.pop(item)) {
+      std::this_thread::yield();
+    }
+    ASSERT_EQ(i, item);
+  }
+  producer.join();
+  ASSERT_TRUE(queue.empty());
+}
+
+TEST(AsyncWriter, writeRows) {
+  const std::string filename = "/tmp/test_async_logger.csv";
+  const int num = 1000;
+  {
+    AsyncWriter writer(2048);
+    ASSERT_TRUE(writer.open(filename, "frame,x,y"));
+    for (int i = 0; i < num; i++) {
+      LogRow row;
+      row.frame = i;
+      row.size = 2;
+      row.values[0] = i * 0.5;
+      row.values[1] = -1.0;
+      ASSERT_TRUE(writer.push(row));
+    }
+    writer.close();
+    ASSERT_EQ(static_cast<uint64_t>(num), writer.getWrittenRows());
+    ASSERT_EQ(0u, writer.getDroppedRows());
+  }
+
+  std::ifstream file(filename);
+  std::string line;
+  std::getline(file, line);
+  ASSERT_EQ("frame,x,y", line);
+  int count = 0;
+  while (std::getline(file, line)) {
+    std::string expected = std::to_string(count) + "," + std::to_string(count * 0.5) + "," + std::to_string(-1.0);
+    ASSERT_EQ(expected, line);
+    count++;
+  }
+  ASSERT_EQ(num, count);
+  std::remove(filename.c_str());
+}
+
+TEST(AsyncWriter, dropWhenClosed) {
+  AsyncWriter writer;
+  LogRow row;
+  row.frame = 0;
+  row.size = 0;
+  ASSERT_FALSE(writer.isOpen());
+  ASSERT_FALSE(writer.push(row));
+  ASSERT_EQ(1u, writer.getDroppedRows());
+}
+// byte run-length codec, enough to exercise the compression hook
+class RunLengthCodec : public ChunkCodec {
+ public:
+  uint32_t getId() const override { return 7; }
+  bool compress(const char *src, size_t size, std::vector<char> &dst) override {
+    for (size_t i = 0; i < size;) {
+      size_t n = 1;
+      while (i + n < size && n < 255 && src[i + n] == src[i]) {
+        n++;
+      }
+      dst.push_back(static_cast<char>(n));
+      dst.push_back(src[i]);
+      i += n;
+    }
+    return true;
+  }
+  bool decompress(const char *src, size_t size, char *dst, size_t raw_size) override {
+    size_t pos = 0;
+    for (size_t i = 0; i + 1 < size; i += 2) {
+      size_t n = static_cast<unsigned char>(src[i]);
+      if (pos + n > raw_size) {
+        return false;
+      }
+      std::memset(dst + pos, src[i + 1], n);
+      pos += n;
+    }
+    return pos == raw_size;
+  }
+};
+
+LogRow makeRow(int frame) {
+  LogRow row;
+  row.frame = frame;
+  row.size = 3;
+  row.values[0] = 100.0 + 0.025 * frame;  // time
+  row.values[1] = frame * 0.5;
+  row.values[2] = 1.0;
+  return row;
+}
+
+void writeColumnLog(const std::string &filename, int num, const std::shared_ptr<ChunkCodec> &codec) {
+  ColumnLogWriter writer;
+  writer.setCodec(codec);
+  ASSERT_TRUE(writer.open(filename, {"frame", "time", "x", "y"}, 1, 64));
+  for (int i = 0; i < num; i++) {
+    ASSERT_TRUE(writer.append(makeRow(i)));
+  }
+  ASSERT_TRUE(writer.close());
+}
+
+TEST(ColumnLog, writeAndRead) {
+  const std::string filename = "/tmp/test_column_log.bin";
+  const int num = 1000;
+  writeColumnLog(filename, num, nullptr);
+
+  ASSERT_TRUE(ColumnLogReader::isColumnLog(filename));
+  ColumnLogReader reader;
+  ASSERT_TRUE(reader.open(filename)) << reader.getError();
+  ASSERT_EQ(static_cast<uint64_t>(num), reader.getRowNum());
+  ASSERT_EQ(4, reader.getColumnNum());
+  ASSERT_EQ(16u, reader.getChunkNum());
+  ASSERT_EQ(2, reader.findColumn("x"));
+  ASSERT_DOUBLE_EQ(100.0, reader.getTimeBegin());
+  ASSERT_DOUBLE_EQ(100.0 + 0.025 * (num - 1), reader.getTimeEnd());
+
+  LogRow row;
+  for (int i = 0; i < num; i += 37) {
+    ASSERT_TRUE(reader.readRow(i, row));
+    ASSERT_EQ(i, row.frame);
+    ASSERT_EQ(3, row.size);
+    ASSERT_DOUBLE_EQ(makeRow(i).values[0], row.values[0]);
+    ASSERT_DOUBLE_EQ(i * 0.5, row.values[1]);
+  }
+  ASSERT_FALSE(reader.readRow(num, row));
+
+  ASSERT_EQ(0u, reader.findRow(0.0));
+  ASSERT_EQ(400u, reader.findRow(110.0));
+  ASSERT_EQ(401u, reader.findRow(110.001));
+  ASSERT_EQ(static_cast<uint64_t>(num), reader.findRow(1000.0));
+  std::remove(filename.c_str());
+}
+
+TEST(ColumnLog, recoverWithoutIndex) {
+  const std::string filename = "/tmp/test_column_log_recover.bin";
+  writeColumnLog(filename, 1000, nullptr);
+  // drop the index and the trailer as if the logger had been killed
+  FILE *file = fopen(filename.c_str(), "rb");
+  fseek(file, -static_cast<long>(sizeof(ColumnLogTrailer)), SEEK_END);
+  ColumnLogTrailer trailer;
+  ASSERT_EQ(1u, fread(&trailer, sizeof(trailer), 1, file));
+  fclose(file);
+  ASSERT_EQ(0, truncate(filename.c_str(), trailer.index_offset));
+
+  ColumnLogReader reader;
+  ASSERT_TRUE(reader.open(filename)) << reader.getError();
+  ASSERT_EQ(1000u, reader.getRowNum());
+  ASSERT_EQ(600u, reader.findRow(115.0));
+  std::remove(filename.c_str());
+}
+
+TEST(ColumnLog, corruptIndex) {
+  const std::string filename = "/tmp/test_column_log_corrupt.bin";
+  writeColumnLog(filename, 1000, nullptr);
+  FILE *file = fopen(filename.c_str(), "r+b");
+  fseek(file, -static_cast<long>(sizeof(ColumnLogTrailer)), SEEK_END);
+  ColumnLogTrailer trailer;
+  ASSERT_EQ(1u, fread(&trailer, sizeof(trailer), 1, file));
+  // an index entry pointing past the end of the file
+  ChunkIndexEntry entry;
+  fseek(file, trailer.index_offset + 3 * sizeof(ChunkIndexEntry), SEEK_SET);
+  ASSERT_EQ(1u, fread(&entry, sizeof(entry), 1, file));
+  entry.offset = 1ull << 40;
+  fseek(file, trailer.index_offset + 3 * sizeof(ChunkIndexEntry), SEEK_SET);
+  ASSERT_EQ(1u, fwrite(&entry, sizeof(entry), 1, file));
+  fclose(file);
+
+  // the reader falls back to walking the chunks
+  ColumnLogReader reader;
+  ASSERT_TRUE(reader.open(filename)) << reader.getError();
+  ASSERT_EQ(1000u, reader.getRowNum());
+  LogRow row;
+  ASSERT_TRUE(reader.readRow(3 * 64 + 5, row));
+  ASSERT_EQ(3 * 64 + 5, row.frame);
+  reader.close();
+
+  // an index offset past the trailer
+  file = fopen(filename.c_str(), "r+b");
+  trailer.index_offset = ~0ull - 8;
+  fseek(file, -static_cast<long>(sizeof(ColumnLogTrailer)), SEEK_END);
+  ASSERT_EQ(1u, fwrite(&trailer, sizeof(trailer), 1, file));
+  fclose(file);
+  ASSERT_TRUE(reader.open(filename)) << reader.getError();
+  ASSERT_EQ(1000u, reader.getRowNum());
+  std::remove(filename.c_str());
+}
+
+TEST(ColumnLog, badTimeColumn) {
+  const std::string filename = "/tmp/test_column_log_time_column.bin";
+  writeColumnLog(filename, 300, nullptr);
+  ColumnLogHeader header;
+  FILE *file = fopen(filename.c_str(), "r+b");
+  ASSERT_EQ(1u, fread(&header, sizeof(header), 1, file));
+
+  // past the column table
+  header.time_column = header.num_columns;
+  fseek(file, 0, SEEK_SET);
+  ASSERT_EQ(1u, fwrite(&header, sizeof(header), 1, file));
+  fflush(file);
+  ColumnLogReader reader;
+  ASSERT_FALSE(reader.open(filename));
+
+  // the frame column is no time column
+  header.time_column = 0;
+  fseek(file, 0, SEEK_SET);
+  ASSERT_EQ(1u, fwrite(&header, sizeof(header), 1, file));
+  fclose(file);
+  ASSERT_TRUE(reader.open(filename)) << reader.getError();
+  ASSERT_EQ(300u, reader.getRowNum());
+  ASSERT_EQ(0u, reader.findRow(105.0));
+  std::remove(filename.c_str());
+}
+
+TEST(ColumnLog, compressedChunks) {
+  const std::string filename = "/tmp/test_column_log_codec.bin";
+  std::shared_ptr<ChunkCodec> codec = std::make_shared<RunLengthCodec>();
+  writeColumnLog(filename, 500, codec);
+
+  ColumnLogReader reader;
+  ASSERT_TRUE(reader.open(filename));
+  LogRow row;
+  ASSERT_FALSE(reader.readRow(10, row));
+
+  reader.setCodec(codec);
+  for (int i = 0; i < 500; i++) {
+    ASSERT_TRUE(reader.readRow(i, row));
+    ASSERT_EQ(i, row.frame);
+    ASSERT_DOUBLE_EQ(1.0, row.values[2]);
+  }
+  ASSERT_EQ(200u, reader.findRow(105.0));
+  std::remove(filename.c_str());
+}
+
+TEST(AsyncWriter, writeColumnLog) {
+  const std::string filename = "/tmp/test_async_logger.bin";
+  {
+    AsyncWriter writer;
+    ASSERT_TRUE(writer.open(filename, "frame,time,x,y", LogFormat::COLUMN));
+    for (int i = 0; i < 300; i++) {
+      ASSERT_TRUE(writer.push(makeRow(i)));
+    }
+  }
+  ColumnLogReader reader;
+  ASSERT_TRUE(reader.open(filename));
+  ASSERT_EQ(300u, reader.getRowNum());
+  ASSERT_EQ("time", reader.getColumnName(1));
+  ASSERT_EQ(40u, reader.findRow(101.0));
+  std::remove(filename.c_str());
+}
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  ros::init(argc, argv, "TestNode");
+  return RUN_ALL_TESTS();
+}
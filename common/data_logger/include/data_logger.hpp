@@ -8,6 +8,7 @@
 #include "std_msgs/String.h"
 
 #include "tf/transform_datatypes.h"
+#include "async_logger/async_writer.h"
 #include <sstream>
 #include <string>
 #include <fstream>
@@ -17,6 +18,7 @@
 namespace ns_data_logger {
 struct Para{
   std::string log_filename;
+  std::string log_format;
   bool use_trigger;
 };
 class DataLogger {
@@ -45,7 +47,7 @@ class DataLogger {
 
   Para para;
 
-  std::fstream record_file;
+  async_logger::AsyncWriter record_file;
   int frame;
   double begin_time;
   double last_time;
@@ -5,7 +5,7 @@
 namespace ns_data_logger {
 // Constructor
 DataLogger::DataLogger(ros::NodeHandle &nh) : nh_(nh) {
-
+  open_file_flag = false;
 };
 
 // Setters
@@ -26,7 +26,6 @@ void DataLogger::setParameters(Para msg){
 }
 
 void DataLogger::openRecordFile(){
-  record_file.open(para.log_filename, std::ios::out);
   std::string header;
   // if(para.record_mode == 0){
   //   // record for path tracking
@@ -36,7 +35,12 @@ void DataLogger::openRecordFile(){
   //   header = "frame,time,x,y,heading,v_x,v_y,yaw_rate,a_x,distance,pedal_acc,pedal_brake";
   // }
   header = "frame,time,x,y,heading,v_x,v_y,yaw_rate,steer_angle,pedal_acc,pedal_brake,lon_acc";
-  record_file << header << std::endl;
+  // "column" writes the chunked binary log that data_replayer can seek in
+  async_logger::LogFormat format = (para.log_format == "column") ? async_logger::LogFormat::COLUMN
+                                                                 : async_logger::LogFormat::CSV;
+  if (!record_file.open(para.log_filename, header, format)){
+    ROS_WARN("[Data Logger] Failed to create record file %s.", para.log_filename.c_str());
+  }
   frame = 0;
   begin_time = ros::Time::now().toSec();
   last_time = begin_time;
@@ -45,44 +49,36 @@ void DataLogger::openRecordFile(){
 }
 
 void DataLogger::write2File() {
-  using namespace std;  
-
-  string frame_s = to_string(frame);
-  ros::Time timestamp = cur_pose.header.stamp;
-  string time = to_string(timestamp.toSec());
-  string x = to_string(cur_pose.pose.pose.position.x);
-  string y = to_string(cur_pose.pose.pose.position.y);
-  
   tf::Quaternion quat;
   tf::quaternionMsgToTF(cur_pose.pose.pose.orientation, quat);
   double roll, pitch, yaw;
   tf::Matrix3x3(quat).getRPY(roll, pitch, yaw);
 
-  string heading = to_string(yaw);
-  string v_x = to_string(cur_pose.twist.twist.linear.x);
-  string v_y = to_string(cur_pose.twist.twist.linear.y);
-  string yaw_rate = to_string(cur_pose.twist.twist.angular.z);
+  // frame,time,x,y,heading,v_x,v_y,yaw_rate,steer_angle,pedal_acc,pedal_brake,lon_acc
+  async_logger::LogRow row;
+  row.frame = frame;
+  row.size = 0;
+  row.values[row.size++] = cur_pose.header.stamp.toSec();
+  row.values[row.size++] = cur_pose.pose.pose.position.x;
+  row.values[row.size++] = cur_pose.pose.pose.position.y;
+  row.values[row.size++] = yaw;
+  row.values[row.size++] = cur_pose.twist.twist.linear.x;
+  row.values[row.size++] = cur_pose.twist.twist.linear.y;
+  row.values[row.size++] = cur_pose.twist.twist.angular.z;
+  row.values[row.size++] = chassis_state.real_steer_angle;
+  row.values[row.size++] = chassis_state.real_acc_pedal;
+  row.values[row.size++] = chassis_state.real_brake_pedal;
+  row.values[row.size++] = chassis_state.vehicle_lon_acceleration;
+  // formatting and disk writes happen on the writer thread, a full queue drops the row
+  record_file.push(row);
 
-  string steer_angle = to_string(chassis_state.real_steer_angle);
-  string pedal_acc = to_string(chassis_state.real_acc_pedal);
-  string pedal_brake = to_string(chassis_state.real_brake_pedal);
-  string lon_acc  = to_string(chassis_state.vehicle_lon_acceleration);
-  
-  // if (para.record_mode == 0){// record for path tracking 
-  record_file << frame_s + "," + time + "," + x + "," + y + "," 
-        + heading + "," + v_x  + "," + v_y  + "," + yaw_rate + ","
-        + steer_angle + "," + pedal_acc + "," + pedal_brake + ","
-        + lon_acc << endl;
-  // }
-  // else{ // record for virtual platoon test
-  //   record_file << frame + "," + time + "," + x + "," + y + "," 
-  //     + heading + "," + v_x  + "," + v_y  + "," + yaw_rate << endl;
-  // }
   frame += 1;
   if (frame%50 == 0){
     double T = ros::Time::now().toSec() - last_time;
     double duration = ros::Time::now().toSec() - begin_time;
-    ROS_INFO("[Data Logger] Record frame number: %d, spent time: %f, frequence: %f.", frame, duration, 50.0/T);
+    ROS_INFO("[Data Logger] Record frame number: %d, spent time: %f, frequence: %f, queued: %lu, dropped: %lu.",
+             frame, duration, 50.0/T, (unsigned long)record_file.getQueuedRows(),
+             (unsigned long)record_file.getDroppedRows());
     last_time = ros::Time::now().toSec();
   }
   }
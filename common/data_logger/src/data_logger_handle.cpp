@@ -50,6 +50,7 @@ void DataLoggerHandle::loadParameters() {
     ROS_WARN_STREAM("Did not load node_rate. Standard value is: " << node_rate_);
   }
   nodeHandle_.param<std::string>("log_filename",para_.log_filename," ");
+  nodeHandle_.param<std::string>("log_format",para_.log_format,"csv");
   nodeHandle_.param<bool>("use_trigger",para_.use_trigger,false);
   //nodeHandle_.param("config_name",variable_name,value);
 }
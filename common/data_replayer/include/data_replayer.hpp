@@ -6,11 +6,18 @@
 #include "common_msgs/VirtualVehicleState.h"
 #include "std_msgs/String.h"
 #include <libwaypoint_follower/libwaypoint_follower.h>
+#include "log_stream.hpp"
+#include "replay_clock.hpp"
 
 namespace ns_data_replayer {
 struct Para{
   std::string log_filename;
   double init_distance;
+  double start_time;
+  bool streaming;
+  double speed_factor;
+  bool batch_mode;
+  bool interpolate;
 };
 class DataReplayer {
   
@@ -20,7 +27,13 @@ class DataReplayer {
   DataReplayer(ros::NodeHandle &nh);
 
   // Getters
-  common_msgs::VirtualVehicleState getVirtualVehicleState(); 
+  // False while no frame has been replayed yet, nothing should be published then
+  bool getVirtualVehicleState(common_msgs::VirtualVehicleState &state);
+  // Batch mode: next frame regardless of the clock, false if none is buffered
+  bool getNextFrame(common_msgs::VirtualVehicleState &state);
+  // Batch mode: up to max_frames next frames appended to states, the rest stays buffered for the next call
+  int getNextFrames(int max_frames, std::vector<common_msgs::VirtualVehicleState> &states);
+  bool isReplayEnd() const;
 
   // Setters
   void setParameters(Para msg);
@@ -49,6 +62,27 @@ class DataReplayer {
 
 
   std::vector<common_msgs::VirtualVehicleState> virtual_vehicle_state_logger;
+
+  // column logs, and csv logs in streaming mode, are read by a prefetch thread
+  LogStream log_stream;
+  std::string log_filename;
+  int log_columns[11];
+  double getProgress() const;
+  void printProgress();
+  bool openLogStream(std::string filename, double start_offset);
+
+  // frames around the replayed log time, replay follows the recorded time column
+  ReplayClock replay_clock;
+  async_logger::LogRow prev_frame;
+  async_logger::LogRow next_frame;
+  bool prev_frame_flag;
+  bool next_frame_flag;
+  double getFrameValue(const async_logger::LogRow &r, int column) const;
+  void advanceFrame(const async_logger::LogRow &r);
+  bool stepStream(double now, common_msgs::VirtualVehicleState &s);
+  void interpolateFrame(double alpha, async_logger::LogRow &r) const;
+  void makeVirtualVehicleState(const async_logger::LogRow &r, double distance,
+                               common_msgs::VirtualVehicleState &s) const;
 };
 }
 
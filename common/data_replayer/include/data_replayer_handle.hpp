@@ -34,6 +34,9 @@ class DataReplayerHandle {
   std::string replay_trigger_topic_name_;
 
   int node_rate_;
+  // frames published per tick in batch mode, also the publisher queue size
+  int batch_frames_per_tick_;
+  std::vector<common_msgs::VirtualVehicleState> batch_states_;
 
   DataReplayer data_replayer_;
   Para para_;
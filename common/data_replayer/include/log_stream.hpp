@@ -0,0 +1,103 @@
+/*
+    Formula Student Driverless Project (FSD-Project).
+    Copyright (c) 2019:
+     - chentairan <killasipilin@gmail.com>
+
+    FSD-Project is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FSD-Project is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FSD-Project.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOG_STREAM_HPP
+#define LOG_STREAM_HPP
+
+#include <async_logger/column_log.h>
+#include <async_logger/log_row.h>
+#include <async_logger/spsc_queue.h>
+
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ns_data_replayer {
+
+/*
+  Reads a data_logger log (csv or column log) on a background thread and keeps
+  a bounded window of upcoming frames, so memory use and the time to the first
+  frame do not depend on the log length. The node thread takes frames with
+  pop(), an empty window while the log is not finished is an underrun.
+*/
+class LogStream {
+
+ public:
+  // Constructor
+  explicit LogStream(size_t window_frames = 256);
+  ~LogStream();
+  LogStream(const LogStream &) = delete;
+  LogStream &operator=(const LogStream &) = delete;
+
+  // Getters
+  bool isOpen() const { return reader_thread.joinable(); }
+  // The log is read to the end and every frame is taken
+  bool isFinished() const;
+  const std::vector<std::string> &getColumnNames() const { return column_names; }
+  // Column index in LogRow::values, -1 if missing
+  int findValueColumn(const std::string &name) const;
+  // Share of the log replayed, from 0 to 1
+  double getProgress() const;
+  size_t getBufferedFrames() const { return window.size(); }
+  uint64_t getUnderruns() const { return underruns; }
+  const std::string &getError() const { return error; }
+
+  // Methods
+  // Start streaming at start_offset seconds after the first frame
+  bool open(const std::string &filename, double start_offset = 0.0);
+  void close();
+  // Never blocks, false if no frame is buffered
+  bool pop(async_logger::LogRow &row);
+  // Block until a frame is buffered or the log is finished, false on timeout [s] or an empty log
+  bool waitForFrame(double timeout) const;
+
+ private:
+  async_logger::SpscQueue<async_logger::LogRow> window;
+  std::thread reader_thread;
+  std::atomic<bool> running;
+  std::atomic<bool> finished;
+  uint64_t underruns;
+  std::string error;
+
+  std::vector<std::string> column_names;
+  int time_column;  // index in LogRow::values
+  double start_offset;
+
+  // column log source
+  async_logger::ColumnLogReader column_log;
+  uint64_t next_row;
+  uint64_t first_row;
+  std::atomic<uint64_t> popped_rows;
+
+  // csv source
+  FILE *csv_file;
+  std::vector<char> csv_buffer;
+  uint64_t csv_bytes;
+  std::atomic<uint64_t> csv_read_bytes;
+
+  bool openCsv(const std::string &filename);
+  bool readNext(async_logger::LogRow &row);
+  bool readCsvRow(async_logger::LogRow &row);
+  void readerLoop();
+};
+}
+
+#endif //LOG_STREAM_HPP
@@ -0,0 +1,60 @@
+/*
+    Formula Student Driverless Project (FSD-Project).
+    Copyright (c) 2019:
+     - chentairan <killasipilin@gmail.com>
+
+    FSD-Project is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FSD-Project is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FSD-Project.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef REPLAY_CLOCK_HPP
+#define REPLAY_CLOCK_HPP
+
+namespace ns_data_replayer {
+
+const double MIN_SPEED_FACTOR = 0.5;
+const double MAX_SPEED_FACTOR = 20.0;
+
+/*
+  Maps the node clock to the recorded log time: log_time advances speed_factor
+  seconds per second of node time, counted from the start() call.
+*/
+class ReplayClock {
+
+ public:
+  // Constructor
+  ReplayClock();
+
+  // Getters
+  bool isStarted() const { return started; }
+  double getSpeedFactor() const { return speed_factor; }
+  // Log time to replay at node time now
+  double getLogTime(double now) const;
+
+  // Setters
+  // Clamped to [MIN_SPEED_FACTOR, MAX_SPEED_FACTOR], false if it had to be clamped
+  bool setSpeedFactor(double speed);
+
+  // Methods
+  void start(double now, double log_time);
+  void reset();
+
+ private:
+  double speed_factor;
+  double begin_now;
+  double begin_log_time;
+  bool started;
+};
+}
+
+#endif //REPLAY_CLOCK_HPP
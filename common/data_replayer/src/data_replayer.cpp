@@ -1,46 +1,57 @@
 #include <ros/ros.h>
 #include "data_replayer.hpp"
 #include <sstream>
+#include <algorithm>
+#include <cmath>
 
 namespace ns_data_replayer {
+
+namespace {
+// data_logger columns used for replay, in the order of log_columns
+const char *LOG_COLUMN_NAMES[11] = {"time", "x", "y", "heading", "v_x", "v_y", "yaw_rate",
+                                    "steer_angle", "pedal_acc", "pedal_brake", "lon_acc"};
+const int TIME_COLUMN = 0;
+const int X_COLUMN = 1;
+const int Y_COLUMN = 2;
+const int HEADING_COLUMN = 3;
+// [s] openLogStream waits this long for the prefetch thread to read the first frame
+const double FIRST_FRAME_TIMEOUT = 1.0;
+}
+
 // Constructor
 DataReplayer::DataReplayer(ros::NodeHandle &nh) : nh_(nh) {
   line_num = -1;
   dis = 0;
+  dis_flag = false;
   send_frame_id = 0;
   begin_time = 0;
   replay_percent = 1;
+  prev_frame_flag = false;
+  next_frame_flag = false;
 };
 
 // Getters
-common_msgs::VirtualVehicleState DataReplayer::getVirtualVehicleState() { 
+bool DataReplayer::getVirtualVehicleState(common_msgs::VirtualVehicleState &state) { 
 
-    // Print replay rate
-    if (replay_percent == floor(10.0 * send_frame_id / line_num)){
-    std::string s = "[=";
-    for (int i = 0; i < 10; i++){
-      if( i < replay_percent){
-        if( i == replay_percent - 1){
-          s =  s + ">";
-        }
-        else{
-          s = s + "=";
-        }
-      }
-      else{
-        s = s + "*";
-      }
-    }
-    s = s + "]";
-    ROS_INFO_STREAM("[Data Replayer] Replay rate: " << s << " " << 100.0 * send_frame_id/line_num << "%%.");
-    replay_percent += 1;
-  }
+  // Print replay rate
+  printProgress();
 
   // Return virtual vehicle state 
   virtual_vehicle_state.header.stamp = ros::Time::now();
-  if(send_frame_id == virtual_vehicle_state_logger.size() - 1){
+  if (log_stream.isOpen()){
+    if (!stepStream(virtual_vehicle_state.header.stamp.toSec(), virtual_vehicle_state)){
+      return false;
+    }
+    state = virtual_vehicle_state;
+    return true;
+  }
+  if (virtual_vehicle_state_logger.empty()){
+    return false;
+  }
+  if(static_cast<uint64_t>(send_frame_id) + 1 >= virtual_vehicle_state_logger.size()){
     ROS_WARN("Data replay end.");
-    return virtual_vehicle_state;
+    state = virtual_vehicle_state;
+    return true;
   }
   virtual_vehicle_state = virtual_vehicle_state_logger[send_frame_id];
   if (send_frame_id == 0){
@@ -49,17 +60,61 @@ common_msgs::VirtualVehicleState DataReplayer::getVirtualVehicleState() {
   double run_duration = ros::Time::now().toSec() - begin_time;
   send_frame_id += 1;
 
-  return virtual_vehicle_state; 
+  state = virtual_vehicle_state;
+  return true; 
+}
+
+bool DataReplayer::getNextFrame(common_msgs::VirtualVehicleState &state) {
+  async_logger::LogRow row;
+  if (!log_stream.isOpen() || !log_stream.pop(row)){
+    return false;
+  }
+  printProgress();
+  advanceFrame(row);
+  makeVirtualVehicleState(row, dis, state);
+  // stamped with the recorded time, so offline evaluation sees the logged timing
+  state.header.stamp = (log_columns[TIME_COLUMN] >= 0) ? ros::Time(getFrameValue(row, TIME_COLUMN))
+                                                       : ros::Time::now();
+  return true;
+}
+
+int DataReplayer::getNextFrames(int max_frames, std::vector<common_msgs::VirtualVehicleState> &states) {
+  int frames = 0;
+  common_msgs::VirtualVehicleState state;
+  while (frames < max_frames && getNextFrame(state)){
+    states.push_back(state);
+    frames++;
+  }
+  return frames;
+}
+
+bool DataReplayer::isReplayEnd() const {
+  if (log_stream.isOpen()){
+    return log_stream.isFinished();
+  }
+  return static_cast<uint64_t>(send_frame_id) + 1 >= virtual_vehicle_state_logger.size();
 }
 
 // Setters
 void DataReplayer::setParameters(Para msg) {
   para = msg;
+  if (!replay_clock.setSpeedFactor(para.speed_factor)){
+    ROS_WARN("[Data Replayer] Speed factor %f out of [%.1f, %.1f], using %f.", para.speed_factor,
+             MIN_SPEED_FACTOR, MAX_SPEED_FACTOR, replay_clock.getSpeedFactor());
+  }
 }
 
 
 // Methods
 void DataReplayer::loadLogFile(std::string filename){
+  log_filename = filename;
+  if (para.streaming || async_logger::ColumnLogReader::isColumnLog(filename)){
+    openLogStream(filename, para.start_time);
+    return;
+  }
+  if (para.batch_mode || para.speed_factor != 1.0){
+    ROS_WARN("[Data Replayer] Speed factor and batch mode need streaming replay, one frame per tick is sent.");
+  }
   log_file.open(filename.c_str(),std::ios::in);
   ROS_INFO("open file [%s]",filename.c_str());
   char linestr[500] = {0};
@@ -128,6 +183,174 @@ void DataReplayer::loadLogFile(std::string filename){
   ROS_INFO("Total frame number of the data: %d.",line_num);
 }
 
+double DataReplayer::getProgress() const {
+  if (log_stream.isOpen()){
+    return log_stream.getProgress();
+  }
+  return line_num > 0 ? 1.0 * send_frame_id / line_num : 1.0;
+}
+
+void DataReplayer::printProgress() {
+  double progress = getProgress();
+  if (replay_percent <= floor(10.0 * progress)){
+    std::string s = "[=";
+    for (int i = 0; i < 10; i++){
+      if( i < replay_percent){
+        if( i == replay_percent - 1){
+          s =  s + ">";
+        }
+        else{
+          s = s + "=";
+        }
+      }
+      else{
+        s = s + "*";
+      }
+    }
+    s = s + "]";
+    ROS_INFO_STREAM("[Data Replayer] Replay rate: " << s << " " << 100.0 * progress << "%%.");
+    replay_percent = floor(10.0 * progress) + 1;
+  }
+}
+
+bool DataReplayer::openLogStream(std::string filename, double start_offset){
+  ROS_INFO("stream log file [%s] from %f s",filename.c_str(), start_offset);
+  if (!log_stream.open(filename, start_offset)){
+    ROS_ERROR("Failed to load log file %s", log_stream.getError().c_str());
+    return false;
+  }
+  for (int i = 0; i < 11; i++){
+    log_columns[i] = log_stream.findValueColumn(LOG_COLUMN_NAMES[i]);
+    if (log_columns[i] < 0){
+      ROS_WARN("[Data Replayer] Column %s missing in the log, replayed as 0.", LOG_COLUMN_NAMES[i]);
+    }
+  }
+  if (log_columns[TIME_COLUMN] < 0){
+    ROS_WARN("[Data Replayer] No time column, one frame is replayed per tick.");
+  }
+  // the first tick replays a frame instead of finding the prefetch window still empty
+  if (!log_stream.waitForFrame(FIRST_FRAME_TIMEOUT)){
+    ROS_WARN("[Data Replayer] No frame read after %.1f s, replay starts once the first frame arrives.",
+             FIRST_FRAME_TIMEOUT);
+  }
+  dis = 0;
+  prev_frame_flag = false;
+  next_frame_flag = false;
+  replay_clock.reset();
+  return true;
+}
+
+double DataReplayer::getFrameValue(const async_logger::LogRow &r, int column) const {
+  return (log_columns[column] >= 0 && log_columns[column] < r.size) ? r.values[log_columns[column]] : 0.0;
+}
+
+void DataReplayer::advanceFrame(const async_logger::LogRow &r){
+  geometry_msgs::Point p;
+  p.x = getFrameValue(r, X_COLUMN);
+  p.y = getFrameValue(r, Y_COLUMN);
+  p.z = 0;
+  // the distance is accumulated while replaying, as loadLogFile does for csv logs
+  if (!prev_frame_flag){
+    dis = 0;
+  }else{
+    dis += getPlaneDistance(p,last_loc);
+  }
+  last_loc = p;
+  prev_frame = r;
+  prev_frame_flag = true;
+}
+
+bool DataReplayer::stepStream(double now, common_msgs::VirtualVehicleState &s){
+  if (!prev_frame_flag){
+    if (!log_stream.pop(prev_frame)){
+      if (log_stream.isFinished()){
+        ROS_WARN("Data replay end.");
+      }
+      return false;
+    }
+    advanceFrame(prev_frame);
+    replay_clock.start(now, getFrameValue(prev_frame, TIME_COLUMN));
+  }
+  else if (log_columns[TIME_COLUMN] < 0){
+    // without recorded time every tick replays the next frame
+    async_logger::LogRow row;
+    if (log_stream.pop(row)){
+      advanceFrame(row);
+    }
+  }
+  else{
+    // take every frame recorded up to the replayed log time
+    double log_time = replay_clock.getLogTime(now);
+    while (next_frame_flag || log_stream.pop(next_frame)){
+      next_frame_flag = true;
+      if (getFrameValue(next_frame, TIME_COLUMN) > log_time){
+        break;
+      }
+      advanceFrame(next_frame);
+      next_frame_flag = false;
+    }
+    if (!next_frame_flag){
+      if (log_stream.isFinished()){
+        ROS_WARN("Data replay end.");
+      }
+      else{
+        ROS_WARN_THROTTLE(1.0, "[Data Replayer] Prefetch window empty, holding the last frame (%lu underruns).",
+                          (unsigned long)log_stream.getUnderruns());
+      }
+    }
+    else if (para.interpolate){
+      double t0 = getFrameValue(prev_frame, TIME_COLUMN);
+      double t1 = getFrameValue(next_frame, TIME_COLUMN);
+      double alpha = (t1 > t0) ? (log_time - t0) / (t1 - t0) : 0.0;
+      alpha = std::max(0.0, std::min(1.0, alpha));
+      async_logger::LogRow r;
+      interpolateFrame(alpha, r);
+      double distance = dis + std::hypot(getFrameValue(r, X_COLUMN) - last_loc.x,
+                                         getFrameValue(r, Y_COLUMN) - last_loc.y);
+      makeVirtualVehicleState(r, distance, s);
+      s.header.stamp = ros::Time(now);
+      return true;
+    }
+  }
+  makeVirtualVehicleState(prev_frame, dis, s);
+  s.header.stamp = ros::Time(now);
+  return true;
+}
+
+void DataReplayer::interpolateFrame(double alpha, async_logger::LogRow &r) const {
+  r = prev_frame;
+  for (int i = 0; i < r.size && i < next_frame.size; i++){
+    r.values[i] = prev_frame.values[i] + alpha * (next_frame.values[i] - prev_frame.values[i]);
+  }
+  // heading is interpolated along the shorter arc
+  int h = log_columns[HEADING_COLUMN];
+  if (h >= 0 && h < r.size && h < next_frame.size){
+    double d_heading = std::remainder(next_frame.values[h] - prev_frame.values[h], 2.0 * M_PI);
+    r.values[h] = prev_frame.values[h] + alpha * d_heading;
+  }
+}
+
+void DataReplayer::makeVirtualVehicleState(const async_logger::LogRow &r, double distance,
+                                           common_msgs::VirtualVehicleState &s) const {
+  double v[11];
+  for (int i = 0; i < 11; i++){
+    v[i] = getFrameValue(r, i);
+  }
+
+  s = common_msgs::VirtualVehicleState();
+  s.utmpose.pose.pose.position.x = v[X_COLUMN];
+  s.utmpose.pose.pose.position.y = v[Y_COLUMN];
+  s.utmpose.pose.pose.position.z = 0;
+  s.utmpose.pose.pose.orientation = tf::createQuaternionMsgFromYaw(v[HEADING_COLUMN]);
+  s.utmpose.twist.twist.linear.x = v[4];
+  s.utmpose.twist.twist.linear.y = v[5];
+  s.utmpose.twist.twist.angular.z = v[6];
+  s.chassis_state.real_steer_angle = v[7];
+  s.chassis_state.real_acc_pedal = v[8];
+  s.chassis_state.real_brake_pedal = v[9];
+  s.distance = distance + para.init_distance;
+}
+
 void DataReplayer::runAlgorithm() {
 
 }
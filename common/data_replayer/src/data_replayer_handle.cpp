@@ -1,6 +1,7 @@
 #include <ros/ros.h>
 #include "data_replayer_handle.hpp"
 #include "register.h"
+#include <algorithm>
 #include <chrono>
 
 namespace ns_data_replayer {
@@ -42,6 +43,15 @@ void DataReplayerHandle::loadParameters() {
   //nodeHandle_.param("config_name",variable_name,value);
   nodeHandle_.param<std::string>("log_filename",para_.log_filename," ");
   nodeHandle_.param<double>("init_distance",para_.init_distance,5);
+  nodeHandle_.param<double>("start_time",para_.start_time,0);
+  nodeHandle_.param<bool>("streaming",para_.streaming,true);
+  nodeHandle_.param<double>("speed_factor",para_.speed_factor,1.0);
+  nodeHandle_.param<bool>("batch_mode",para_.batch_mode,false);
+  if (!nodeHandle_.param("batch_frames_per_tick", batch_frames_per_tick_, 256)) {
+    ROS_WARN_STREAM("Did not load batch_frames_per_tick. Standard value is: " << batch_frames_per_tick_);
+  }
+  batch_frames_per_tick_ = std::max(batch_frames_per_tick_, 1);
+  nodeHandle_.param<bool>("interpolate",para_.interpolate,true);
 }
 
 void DataReplayerHandle::subscribeToTopics() {
@@ -52,7 +62,8 @@ void DataReplayerHandle::subscribeToTopics() {
 
 void DataReplayerHandle::publishToTopics() {
   ROS_INFO("publish to topics");
-  virtualVehicleStatePublisher_ = nodeHandle_.advertise<common_msgs::VirtualVehicleState>(virtual_vehicle_state_topic_name_, 1);
+  virtualVehicleStatePublisher_ = nodeHandle_.advertise<common_msgs::VirtualVehicleState>(
+      virtual_vehicle_state_topic_name_, para_.batch_mode ? batch_frames_per_tick_ : 1);
 }
 
 void DataReplayerHandle::run() {
@@ -70,7 +81,27 @@ void DataReplayerHandle::run() {
 }
 
 void DataReplayerHandle::sendMsg() {
-  virtualVehicleStatePublisher_.publish(data_replayer_.getVirtualVehicleState());
+  common_msgs::VirtualVehicleState state;
+  if (!para_.batch_mode) {
+    if (data_replayer_.getVirtualVehicleState(state)) {
+      virtualVehicleStatePublisher_.publish(state);
+    }
+    return;
+  }
+  // as fast as possible: everything the prefetch window holds, stamped with the recorded time
+  // frames past the cap stay in the prefetch window and go out on the next tick
+  batch_states_.clear();
+  int frames = data_replayer_.getNextFrames(batch_frames_per_tick_, batch_states_);
+  for (const common_msgs::VirtualVehicleState &batch_state : batch_states_) {
+    virtualVehicleStatePublisher_.publish(batch_state);
+  }
+  if (frames == batch_frames_per_tick_) {
+    ROS_WARN_THROTTLE(1.0, "[Data Replayer] %d frames per tick cap reached, the rest is published on the next tick. "
+                      "Raise batch_frames_per_tick or node_rate for a faster replay.", batch_frames_per_tick_);
+  }
+  if (data_replayer_.isReplayEnd()) {
+    ROS_WARN_THROTTLE(1.0, "Data replay end.");
+  }
 }
 
 void DataReplayerHandle::replayTriggerCallback(const common_msgs::Trigger &msg){
@@ -0,0 +1,273 @@
+/*
+    Formula Student Driverless Project (FSD-Project).
+    Copyright (c) 2019:
+     - chentairan <killasipilin@gmail.com>
+
+    FSD-Project is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FSD-Project is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FSD-Project.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "log_stream.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <sys/stat.h>
+
+namespace ns_data_replayer {
+
+namespace {
+// sleep of the reader thread while the window is full
+const std::chrono::milliseconds FULL_SLEEP(5);
+// poll period of waitForFrame
+const std::chrono::milliseconds WAIT_SLEEP(1);
+// mapped pages behind the reader are dropped every RELEASE_ROWS rows
+const uint64_t RELEASE_ROWS = 1024;
+const size_t CSV_LINE_BYTES = 1024;
+}
+
+// Constructor
+LogStream::LogStream(size_t window_frames) :
+    window(window_frames),
+    running(false),
+    finished(false),
+    underruns(0),
+    time_column(-1),
+    start_offset(0),
+    next_row(0),
+    first_row(0),
+    popped_rows(0),
+    csv_file(nullptr),
+    csv_buffer(CSV_LINE_BYTES),
+    csv_bytes(0),
+    csv_read_bytes(0) {
+}
+
+LogStream::~LogStream() {
+  close();
+}
+
+// Getters
+bool LogStream::isFinished() const {
+  return finished.load(std::memory_order_acquire) && window.empty();
+}
+
+int LogStream::findValueColumn(const std::string &name) const {
+  // column 0 is the frame, it is not part of LogRow::values
+  for (size_t i = 1; i < column_names.size(); i++) {
+    if (column_names[i] == name) {
+      return static_cast<int>(i) - 1;
+    }
+  }
+  return -1;
+}
+
+double LogStream::getProgress() const {
+  if (column_log.isOpen()) {
+    uint64_t rows = column_log.getRowNum();
+    return rows > 0 ? static_cast<double>(first_row + popped_rows.load()) / rows : 1.0;
+  }
+  return csv_bytes > 0 ? static_cast<double>(csv_read_bytes.load()) / csv_bytes : 1.0;
+}
+
+// Methods
+bool LogStream::open(const std::string &filename, double offset) {
+  close();
+  error.clear();
+  column_names.clear();
+  start_offset = offset;
+  underruns = 0;
+  popped_rows = 0;
+  finished = false;
+
+  if (async_logger::ColumnLogReader::isColumnLog(filename)) {
+    if (!column_log.open(filename)) {
+      error = column_log.getError();
+      return false;
+    }
+    for (int i = 0; i < column_log.getColumnNum(); i++) {
+      column_names.push_back(column_log.getColumnName(i));
+    }
+    time_column = findValueColumn("time");
+    // column logs seek with the chunk time index instead of reading up to the start
+    first_row = 0;
+    if (start_offset > 0 && time_column >= 0) {
+      first_row = column_log.findRow(column_log.getTimeBegin() + start_offset);
+    }
+    next_row = first_row;
+  } else if (!openCsv(filename)) {
+    return false;
+  }
+
+  running = true;
+  reader_thread = std::thread(&LogStream::readerLoop, this);
+  return true;
+}
+
+void LogStream::close() {
+  running = false;
+  if (reader_thread.joinable()) {
+    reader_thread.join();
+  }
+  async_logger::LogRow row;
+  while (window.pop(row)) {
+  }
+  column_log.close();
+  if (csv_file != nullptr) {
+    fclose(csv_file);
+    csv_file = nullptr;
+  }
+  csv_bytes = 0;
+  csv_read_bytes = 0;
+  next_row = 0;
+  first_row = 0;
+}
+
+bool LogStream::pop(async_logger::LogRow &row) {
+  if (window.pop(row)) {
+    popped_rows.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+  if (!finished.load(std::memory_order_acquire)) {
+    underruns += 1;
+  }
+  return false;
+}
+
+bool LogStream::waitForFrame(double timeout) const {
+  std::chrono::steady_clock::time_point deadline =
+      std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                             std::chrono::duration<double>(timeout));
+  while (window.empty()) {
+    if (finished.load(std::memory_order_acquire)) {
+      // the reader may have pushed its last frame just before finishing
+      return !window.empty();
+    }
+    if (std::chrono::steady_clock::now() >= deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(WAIT_SLEEP);
+  }
+  return true;
+}
+
+bool LogStream::openCsv(const std::string &filename) {
+  csv_file = fopen(filename.c_str(), "r");
+  if (csv_file == nullptr) {
+    error = "cannot open " + filename + ": " + std::strerror(errno);
+    return false;
+  }
+  struct stat st;
+  csv_bytes = (::stat(filename.c_str(), &st) == 0) ? st.st_size : 0;
+
+  // header line: frame,time,x,y,...
+  if (fgets(csv_buffer.data(), csv_buffer.size(), csv_file) == nullptr) {
+    error = filename + ": empty log";
+    fclose(csv_file);
+    csv_file = nullptr;
+    return false;
+  }
+  csv_read_bytes = std::strlen(csv_buffer.data());
+  std::stringstream ss(csv_buffer.data());
+  std::string name;
+  while (std::getline(ss, name, ',')) {
+    while (!name.empty() && (name.back() == '\n' || name.back() == '\r')) {
+      name.pop_back();
+    }
+    column_names.push_back(name);
+  }
+  time_column = findValueColumn("time");
+  // the first data row is dropped, as the in-memory csv replay in DataReplayer::loadLogFile does
+  async_logger::LogRow row;
+  readCsvRow(row);
+  return true;
+}
+
+bool LogStream::readNext(async_logger::LogRow &row) {
+  if (column_log.isOpen()) {
+    if (next_row >= column_log.getRowNum() || !column_log.readRow(next_row, row)) {
+      return false;
+    }
+    next_row += 1;
+    if (next_row % RELEASE_ROWS == 0) {
+      column_log.releaseRows(next_row);
+    }
+    return true;
+  }
+  return readCsvRow(row);
+}
+
+bool LogStream::readCsvRow(async_logger::LogRow &row) {
+  const int value_num = std::min<int>(column_names.size() - 1, async_logger::MAX_LOG_COLUMNS);
+  while (fgets(csv_buffer.data(), csv_buffer.size(), csv_file) != nullptr) {
+    const char *p = csv_buffer.data();
+    csv_read_bytes.fetch_add(std::strlen(p), std::memory_order_relaxed);
+    if (*p == '\n' || *p == '\r' || *p == '\0') {
+      continue;
+    }
+    // missing or malformed fields read as 0
+    char *next;
+    row.frame = std::strtoll(p, &next, 10);
+    row.size = value_num;
+    for (int i = 0; i < value_num; i++) {
+      if (p != nullptr) {
+        p = std::strchr(p, ',');
+      }
+      if (p != nullptr) {
+        p += 1;
+        row.values[i] = std::strtod(p, &next);
+      } else {
+        row.values[i] = 0.0;
+      }
+    }
+    return true;
+  }
+  return false;
+}
+
+void LogStream::readerLoop() {
+  async_logger::LogRow row;
+  bool have_row = false;
+  // csv logs are read up to the start offset, column logs have seeked in open()
+  bool skipping = csv_file != nullptr && start_offset > 0 && time_column >= 0;
+  bool have_begin = false;
+  double skip_until = 0;
+  while (running.load(std::memory_order_acquire)) {
+    if (!have_row) {
+      if (!readNext(row)) {
+        break;
+      }
+      if (skipping) {
+        if (!have_begin) {
+          skip_until = row.values[time_column] + start_offset;
+          have_begin = true;
+        }
+        if (row.values[time_column] < skip_until) {
+          continue;
+        }
+        skipping = false;
+      }
+      have_row = true;
+    }
+    if (window.push(row)) {
+      have_row = false;
+    } else {
+      std::this_thread::sleep_for(FULL_SLEEP);
+    }
+  }
+  finished.store(true, std::memory_order_release);
+}
+}
@@ -0,0 +1,61 @@
+/*
+    Formula Student Driverless Project (FSD-Project).
+    Copyright (c) 2019:
+     - chentairan <killasipilin@gmail.com>
+
+    FSD-Project is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FSD-Project is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FSD-Project.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "replay_clock.hpp"
+
+namespace ns_data_replayer {
+// Constructor
+ReplayClock::ReplayClock() :
+    speed_factor(1.0),
+    begin_now(0),
+    begin_log_time(0),
+    started(false) {
+}
+
+// Getters
+double ReplayClock::getLogTime(double now) const {
+  if (!started) {
+    return begin_log_time;
+  }
+  return begin_log_time + speed_factor * (now - begin_now);
+}
+
+// Setters
+bool ReplayClock::setSpeedFactor(double speed) {
+  speed_factor = speed;
+  if (speed_factor < MIN_SPEED_FACTOR) {
+    speed_factor = MIN_SPEED_FACTOR;
+  }
+  if (speed_factor > MAX_SPEED_FACTOR) {
+    speed_factor = MAX_SPEED_FACTOR;
+  }
+  return speed_factor == speed;
+}
+
+// Methods
+void ReplayClock::start(double now, double log_time) {
+  begin_now = now;
+  begin_log_time = log_time;
+  started = true;
+}
+
+void ReplayClock::reset() {
+  started = false;
+}
+}
@@ -0,0 +1,364 @@
+/*
+    Formula Student Driverless Project (FSD-Project).
+    Copyright (c) 2019:
+     - chentairan <killasipilin@gmail.com>
+
+    FSD-Project is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FSD-Project is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FSD-Project.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <gtest/gtest.h>
+#include <ros/ros.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <async_logger/column_log.h>
+
+#include "data_replayer.hpp"
+#include "log_stream.hpp"
+#include "replay_clock.hpp"
+
+namespace ns_data_replayer {
+
+namespace {
+// frame i is recorded at time 0.1 * i, at x = i
+async_logger::LogRow makeRow(int frame) {
+  async_logger::LogRow row;
+  row.frame = frame;
+  row.size = 4;
+  row.values[0] = 0.1 * frame;  // time
+  row.values[1] = frame;        // x
+  row.values[2] = -frame;       // y
+  row.values[3] = 0.0;          // heading
+  return row;
+}
+
+void writeColumnLog(const std::string &filename, int num) {
+  async_logger::ColumnLogWriter writer;
+  ASSERT_TRUE(writer.open(filename, {"frame", "time", "x", "y", "heading"}, 1, 64));
+  for (int i = 0; i < num; i++) {
+    ASSERT_TRUE(writer.append(makeRow(i)));
+  }
+  ASSERT_TRUE(writer.close());
+}
+
+void writeCsvLog(const std::string &filename, int num) {
+  FILE *file = fopen(filename.c_str(), "w");
+  ASSERT_TRUE(file != nullptr);
+  fprintf(file, "frame,time,x,y,heading\n");
+  for (int i = 0; i < num; i++) {
+    async_logger::LogRow row = makeRow(i);
+    fprintf(file, "%d,%.6f,%.6f,%.6f,%.6f\n", i, row.values[0], row.values[1], row.values[2], row.values[3]);
+  }
+  fclose(file);
+}
+
+Para makePara(bool interpolate, double speed_factor, bool batch_mode) {
+  Para para;
+  para.init_distance = 5.0;
+  para.start_time = 0.0;
+  para.streaming = true;
+  para.speed_factor = speed_factor;
+  para.batch_mode = batch_mode;
+  para.interpolate = interpolate;
+  return para;
+}
+
+// replays the log in sim time, the clock starts at 100 s
+struct ReplayFixture {
+  ros::NodeHandle nh;
+  DataReplayer replayer;
+  explicit ReplayFixture(const std::string &filename, const Para &para) : replayer(nh) {
+    ros::Time::setNow(ros::Time(100.0));
+    replayer.setParameters(para);
+    replayer.loadLogFile(filename);
+  }
+  bool stateAt(double now, common_msgs::VirtualVehicleState &state) {
+    ros::Time::setNow(ros::Time(now));
+    return replayer.getVirtualVehicleState(state);
+  }
+};
+
+// pops every frame left, waiting for the reader thread, and checks they follow each other
+int popAll(LogStream &stream, int64_t first_frame) {
+  async_logger::LogRow row;
+  int64_t frame = first_frame;
+  while (stream.waitForFrame(1.0)) {
+    EXPECT_TRUE(stream.pop(row));
+    EXPECT_EQ(frame, row.frame);
+    EXPECT_DOUBLE_EQ(static_cast<double>(frame), row.values[1]);
+    frame++;
+  }
+  return static_cast<int>(frame - first_frame);
+}
+
+// the reader thread fills the window up to its size and stops there
+void waitForFullWindow(const LogStream &stream, size_t window) {
+  for (int i = 0; i < 200 && stream.getBufferedFrames() < window; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+}
+}
+
+TEST(LogStream, boundedWindow) {
+  const std::string filename = "/tmp/test_log_stream_window.bin";
+  writeColumnLog(filename, 1000);
+  LogStream stream(16);
+  ASSERT_TRUE(stream.open(filename)) << stream.getError();
+  ASSERT_EQ(3, stream.findValueColumn("heading"));
+  ASSERT_EQ(-1, stream.findValueColumn("frame"));
+
+  waitForFullWindow(stream, 16);
+  ASSERT_EQ(16u, stream.getBufferedFrames());
+  ASSERT_FALSE(stream.isFinished());
+
+  // taking frames makes room, the reader refills up to the bound again
+  async_logger::LogRow row;
+  for (int i = 0; i < 10; i++) {
+    ASSERT_TRUE(stream.pop(row));
+    ASSERT_EQ(i, row.frame);
+  }
+  waitForFullWindow(stream, 16);
+  ASSERT_EQ(16u, stream.getBufferedFrames());
+  ASSERT_NEAR(0.01, stream.getProgress(), 1e-9);
+
+  ASSERT_EQ(990, popAll(stream, 10));
+  ASSERT_TRUE(stream.isFinished());
+  ASSERT_DOUBLE_EQ(1.0, stream.getProgress());
+  ASSERT_FALSE(stream.pop(row));
+  // popping past the end of the log is no underrun
+  ASSERT_EQ(0u, stream.getUnderruns());
+  stream.close();
+  ASSERT_FALSE(stream.isOpen());
+  std::remove(filename.c_str());
+}
+
+TEST(LogStream, csvToTheEnd) {
+  const std::string filename = "/tmp/test_log_stream.csv";
+  writeCsvLog(filename, 500);
+  LogStream stream(32);
+  ASSERT_TRUE(stream.open(filename)) << stream.getError();
+  ASSERT_EQ(5u, stream.getColumnNames().size());
+  waitForFullWindow(stream, 32);
+  ASSERT_EQ(32u, stream.getBufferedFrames());
+
+  // the first data row is dropped, as the in-memory csv replay does
+  ASSERT_EQ(499, popAll(stream, 1));
+  ASSERT_TRUE(stream.isFinished());
+  ASSERT_DOUBLE_EQ(1.0, stream.getProgress());
+
+  // reopening starts over
+  ASSERT_TRUE(stream.open(filename)) << stream.getError();
+  ASSERT_EQ(499, popAll(stream, 1));
+  std::remove(filename.c_str());
+}
+
+TEST(LogStream, startOffset) {
+  const std::string column_filename = "/tmp/test_log_stream_offset.bin";
+  const std::string csv_filename = "/tmp/test_log_stream_offset.csv";
+  writeColumnLog(column_filename, 1000);
+  writeCsvLog(csv_filename, 1000);
+
+  // 25 s after the first frame, the column log seeks with its time index
+  LogStream stream(64);
+  ASSERT_TRUE(stream.open(column_filename, 25.0)) << stream.getError();
+  ASSERT_EQ(750, popAll(stream, 250));
+
+  // the csv log is read up to the offset, counted from its first kept frame
+  ASSERT_TRUE(stream.open(csv_filename, 25.0)) << stream.getError();
+  ASSERT_EQ(749, popAll(stream, 251));
+  std::remove(column_filename.c_str());
+  std::remove(csv_filename.c_str());
+}
+
+TEST(LogStream, emptyAndMissingLogs) {
+  const std::string filename = "/tmp/test_log_stream_empty.csv";
+  writeCsvLog(filename, 0);
+  LogStream stream;
+  ASSERT_TRUE(stream.open(filename)) << stream.getError();
+  ASSERT_FALSE(stream.waitForFrame(1.0));
+  ASSERT_TRUE(stream.isFinished());
+  async_logger::LogRow row;
+  ASSERT_FALSE(stream.pop(row));
+
+  ASSERT_FALSE(stream.open("/tmp/test_log_stream_missing.csv"));
+  ASSERT_FALSE(stream.getError().empty());
+  ASSERT_FALSE(stream.isOpen());
+  std::remove(filename.c_str());
+}
+
+TEST(ReplayClock, pacing) {
+  ReplayClock clock;
+  ASSERT_FALSE(clock.isStarted());
+  ASSERT_DOUBLE_EQ(0.0, clock.getLogTime(50.0));
+
+  clock.start(10.0, 100.0);
+  ASSERT_TRUE(clock.isStarted());
+  ASSERT_DOUBLE_EQ(100.0, clock.getLogTime(10.0));
+  ASSERT_DOUBLE_EQ(102.5, clock.getLogTime(12.5));
+
+  // the factor applies to the node time since start()
+  ASSERT_TRUE(clock.setSpeedFactor(4.0));
+  ASSERT_DOUBLE_EQ(110.0, clock.getLogTime(12.5));
+
+  // stopped clocks hold the log time they started at
+  clock.reset();
+  ASSERT_FALSE(clock.isStarted());
+  ASSERT_DOUBLE_EQ(100.0, clock.getLogTime(20.0));
+  clock.start(20.0, 0.0);
+  ASSERT_DOUBLE_EQ(2.0, clock.getLogTime(20.5));
+}
+
+TEST(ReplayClock, speedFactorLimits) {
+  ReplayClock clock;
+  ASSERT_DOUBLE_EQ(1.0, clock.getSpeedFactor());
+  ASSERT_FALSE(clock.setSpeedFactor(100.0));
+  ASSERT_DOUBLE_EQ(MAX_SPEED_FACTOR, clock.getSpeedFactor());
+  ASSERT_FALSE(clock.setSpeedFactor(0.0));
+  ASSERT_DOUBLE_EQ(MIN_SPEED_FACTOR, clock.getSpeedFactor());
+  ASSERT_TRUE(clock.setSpeedFactor(MIN_SPEED_FACTOR));
+  ASSERT_TRUE(clock.setSpeedFactor(MAX_SPEED_FACTOR));
+}
+
+TEST(DataReplayer, noStateBeforeFirstFrame) {
+  const std::string filename = "/tmp/test_data_replayer_empty.csv";
+  writeCsvLog(filename, 0);
+  ros::NodeHandle nh;
+  DataReplayer replayer(nh);
+  replayer.setParameters(makePara(true, 1.0, false));
+  common_msgs::VirtualVehicleState state;
+  // no log loaded yet
+  ASSERT_FALSE(replayer.getVirtualVehicleState(state));
+
+  // a log without frames never has a state to publish
+  replayer.loadLogFile(filename);
+  ros::Time::setNow(ros::Time(100.0));
+  ASSERT_FALSE(replayer.getVirtualVehicleState(state));
+  ros::Time::setNow(ros::Time(101.0));
+  ASSERT_FALSE(replayer.getVirtualVehicleState(state));
+  ASSERT_TRUE(replayer.isReplayEnd());
+  std::remove(filename.c_str());
+}
+
+TEST(DataReplayer, interpolation) {
+  const std::string filename = "/tmp/test_data_replayer.bin";
+  writeColumnLog(filename, 1000);
+  ReplayFixture fixture(filename, makePara(true, 1.0, false));
+  common_msgs::VirtualVehicleState state;
+
+  // the first tick replays the first frame and starts the clock
+  ASSERT_TRUE(fixture.stateAt(100.0, state));
+  ASSERT_DOUBLE_EQ(0.0, state.utmpose.pose.pose.position.x);
+  ASSERT_DOUBLE_EQ(5.0, state.distance);
+
+  // halfway between frame 2 and 3, the distance runs up to the interpolated point
+  ASSERT_TRUE(fixture.stateAt(100.25, state));
+  ASSERT_NEAR(2.5, state.utmpose.pose.pose.position.x, 1e-9);
+  ASSERT_NEAR(-2.5, state.utmpose.pose.pose.position.y, 1e-9);
+  ASSERT_NEAR(5.0 + 2.5 * std::sqrt(2.0), state.distance, 1e-9);
+  ASSERT_DOUBLE_EQ(100.25, state.header.stamp.toSec());
+
+  // past the last frame the last one is held, each tick takes what the prefetch window holds
+  for (int tick = 0; tick < 100 && !fixture.replayer.isReplayEnd(); tick++) {
+    ASSERT_TRUE(fixture.stateAt(1000.0, state));
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  ASSERT_TRUE(fixture.replayer.isReplayEnd());
+  ASSERT_TRUE(fixture.stateAt(1000.0, state));
+  ASSERT_DOUBLE_EQ(999.0, state.utmpose.pose.pose.position.x);
+  std::remove(filename.c_str());
+}
+
+TEST(DataReplayer, recordedTimeWithoutInterpolation) {
+  const std::string filename = "/tmp/test_data_replayer_hold.bin";
+  writeColumnLog(filename, 1000);
+  ReplayFixture fixture(filename, makePara(false, 2.0, false));
+  common_msgs::VirtualVehicleState state;
+  ASSERT_TRUE(fixture.stateAt(100.0, state));
+  ASSERT_DOUBLE_EQ(0.0, state.utmpose.pose.pose.position.x);
+
+  // twice as fast: 0.33 s of log time, frame 3 is the last one recorded by then
+  ASSERT_TRUE(fixture.stateAt(100.165, state));
+  ASSERT_DOUBLE_EQ(3.0, state.utmpose.pose.pose.position.x);
+  ASSERT_NEAR(5.0 + 3.0 * std::sqrt(2.0), state.distance, 1e-9);
+
+  // frames are never replayed backwards
+  ASSERT_TRUE(fixture.stateAt(100.1, state));
+  ASSERT_DOUBLE_EQ(3.0, state.utmpose.pose.pose.position.x);
+  std::remove(filename.c_str());
+}
+
+TEST(DataReplayer, headingAlongTheShorterArc) {
+  const std::string filename = "/tmp/test_data_replayer_heading.bin";
+  {
+    async_logger::ColumnLogWriter writer;
+    ASSERT_TRUE(writer.open(filename, {"frame", "time", "x", "y", "heading"}, 1, 64));
+    for (int i = 0; i < 10; i++) {
+      async_logger::LogRow row = makeRow(i);
+      row.values[3] = (i % 2 == 0) ? 3.0 : -3.0;
+      ASSERT_TRUE(writer.append(row));
+    }
+    ASSERT_TRUE(writer.close());
+  }
+  ReplayFixture fixture(filename, makePara(true, 1.0, false));
+  common_msgs::VirtualVehicleState state;
+  ASSERT_TRUE(fixture.stateAt(100.0, state));
+  // halfway from 3 to -3 rad is pi, not 0
+  ASSERT_TRUE(fixture.stateAt(100.05, state));
+  const geometry_msgs::Quaternion &q = state.utmpose.pose.pose.orientation;
+  ASSERT_NEAR(M_PI, std::fabs(2.0 * std::atan2(q.z, q.w)), 1e-6);
+  std::remove(filename.c_str());
+}
+
+TEST(DataReplayer, batchCap) {
+  const std::string filename = "/tmp/test_data_replayer_batch.bin";
+  writeColumnLog(filename, 1000);
+  ReplayFixture fixture(filename, makePara(true, 1.0, true));
+
+  // every call stops at the cap, the rest stays buffered and follows on the next call
+  std::vector<common_msgs::VirtualVehicleState> states;
+  int frames = 0;
+  while (frames < 1000) {
+    // the prefetch window (256 frames) refills between ticks
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    states.clear();
+    int n = fixture.replayer.getNextFrames(64, states);
+    ASSERT_EQ(std::min(64, 1000 - frames), n);
+    ASSERT_EQ(static_cast<size_t>(n), states.size());
+    for (int i = 0; i < n; i++) {
+      // stamped with the recorded time
+      ASSERT_DOUBLE_EQ(frames + i, states[i].utmpose.pose.pose.position.x);
+      ASSERT_NEAR(0.1 * (frames + i), states[i].header.stamp.toSec(), 1e-6);
+    }
+    frames += n;
+  }
+  ASSERT_EQ(1000, frames);
+  states.clear();
+  ASSERT_EQ(0, fixture.replayer.getNextFrames(64, states));
+  ASSERT_TRUE(fixture.replayer.isReplayEnd());
+  std::remove(filename.c_str());
+}
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  ros::init(argc, argv, "TestNode");
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2015-2019 Autoware Foundation. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LIBWAYPOINT_FOLLOWER_COMPILED_PATH_H
+#define LIBWAYPOINT_FOLLOWER_COMPILED_PATH_H
+
+// ROS includes
+#include <autoware_msgs/Lane.h>
+#include <geometry_msgs/Pose.h>
+
+// C++ includes
+#include <cstdint>
+#include <vector>
+
+// Struct-of-arrays copy of the fields the controllers read from a path.
+//
+// A Lane is converted once when it is received, the control loop then reads
+// contiguous arrays instead of striding over full Waypoint messages.
+struct CompiledPath
+{
+  std::vector<double> x;      // [m]
+  std::vector<double> y;      // [m]
+  std::vector<double> z;      // [m] altitude, carried through for getPose(), not used by the controllers
+  std::vector<double> yaw;    // [rad]
+  std::vector<double> v;      // [m/s]
+  std::vector<double> s;      // arc length from the first waypoint [m]
+  std::vector<double> kappa;  // signed curvature, positive to the left [1/m]
+
+  void compile(const autoware_msgs::Lane &lane);
+  void compile(const std::vector<geometry_msgs::Pose> &poses);
+  void clear();
+
+  bool isEmpty() const
+  {
+    return x.empty();
+  }
+  int32_t getSize() const
+  {
+    return static_cast<int32_t>(x.size());
+  }
+  geometry_msgs::Point getPosition(int32_t idx) const;
+  geometry_msgs::Pose getPose(int32_t idx) const;
+};
+
+#endif  // LIBWAYPOINT_FOLLOWER_COMPILED_PATH_H
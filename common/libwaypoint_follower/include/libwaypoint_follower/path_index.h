@@ -0,0 +1,92 @@
+/*
+ * Copyright 2015-2019 Autoware Foundation. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LIBWAYPOINT_FOLLOWER_PATH_INDEX_H
+#define LIBWAYPOINT_FOLLOWER_PATH_INDEX_H
+
+// ROS includes
+#include <autoware_msgs/Lane.h>
+
+// C++ includes
+#include <cstdint>
+#include <vector>
+
+// Spatial index over the 2D positions of a path.
+//
+// The index is built once per path (O(n log n)) and answers nearest / lookahead
+// queries without scanning the whole path:
+//  - findNearest() first searches a small window around the previous result,
+//    which is the common case while following the path, and falls back to a
+//    sparse uniform grid when the window does not contain a local minimum.
+//  - findLookahead() uses the cumulative arc length to skip every waypoint
+//    that cannot be farther than the lookahead distance.
+class PathIndex
+{
+public:
+  PathIndex()
+    : cell_size_(2.0), window_size_(50), max_window_distance_(5.0), origin_x_(0.0), origin_y_(0.0),
+      num_cells_x_(0), num_cells_y_(0), last_nearest_idx_(-1) {}
+  PathIndex(double cell_size, int32_t window_size, double max_window_distance)
+    : cell_size_(cell_size), window_size_(window_size), max_window_distance_(max_window_distance),
+      origin_x_(0.0), origin_y_(0.0), num_cells_x_(0), num_cells_y_(0), last_nearest_idx_(-1) {}
+
+  // setter
+  void build(const autoware_msgs::Lane &lane);
+  void build(const std::vector<double> &xs, const std::vector<double> &ys);
+  void clear();
+  void resetHint() { last_nearest_idx_ = -1; }
+
+  // getter
+  bool isEmpty() const { return x_.empty(); }
+  int32_t getSize() const { return static_cast<int32_t>(x_.size()); }
+  double getArcLength(int32_t idx) const { return s_.at(idx); }
+  int32_t getLastNearestIdx() const { return last_nearest_idx_; }
+
+  // index of the waypoint closest to (x, y), -1 if the index is empty
+  int32_t findNearest(double x, double y);
+  // first waypoint at or after nearest_idx farther than lookahead_distance from (x, y), -1 if none
+  int32_t findLookahead(int32_t nearest_idx, double x, double y, double lookahead_distance) const;
+
+private:
+  // parameters
+  double cell_size_;
+  int32_t window_size_;
+  double max_window_distance_;
+
+  // path data
+  std::vector<double> x_;
+  std::vector<double> y_;
+  std::vector<double> s_;
+
+  // sparse grid: waypoint indices grouped by cell, occupied cells sorted by key
+  double origin_x_, origin_y_;
+  int32_t num_cells_x_, num_cells_y_;
+  std::vector<int64_t> cell_keys_;
+  std::vector<int32_t> cell_begin_;
+  std::vector<int32_t> cell_points_;
+
+  // state
+  int32_t last_nearest_idx_;
+
+  // functions
+  int64_t calcCellKey(int32_t cx, int32_t cy) const;
+  double calcDistSquared(int32_t idx, double x, double y) const;
+  int32_t findNearestInWindow(double x, double y, int32_t center_idx, double *dist_squared) const;
+  int32_t findNearestInGrid(double x, double y) const;
+  int32_t findNearestLinear(double x, double y) const;
+};
+
+#endif  // LIBWAYPOINT_FOLLOWER_PATH_INDEX_H
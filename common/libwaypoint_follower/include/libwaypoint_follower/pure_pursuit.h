@@ -21,6 +21,7 @@
 
 // ROS includes
 #include <geometry_msgs/Pose.h>
+#include "libwaypoint_follower/compiled_path.h"
 
 // C++ includes
 #include <memory>
@@ -36,6 +37,7 @@ public:
   void setUseLerp(bool ul);
   void setCurrentPose(const geometry_msgs::Pose &msg);
   void setWaypoints(const std::vector<geometry_msgs::Pose> &msg);
+  void setWaypoints(const std::shared_ptr<const CompiledPath> &path);
   void setLookaheadDistance(double ld);
   void setClosestThreshold(double clst_thr_dist, double clst_thr_ang);
 
@@ -54,10 +56,11 @@ private:
   // variables got from outside
   bool use_lerp_;
   double lookahead_distance_, clst_thr_dist_, clst_thr_ang_;
-  std::shared_ptr<std::vector<geometry_msgs::Pose>> curr_wps_ptr_;
+  std::shared_ptr<const CompiledPath> curr_wps_ptr_;
   std::shared_ptr<geometry_msgs::Pose> curr_pose_ptr_;
 
   // functions
+  std::pair<bool, int32_t> findClosestIdx() const;
   int32_t findNextPointIdx(int32_t search_start_idx);
   std::pair<bool, geometry_msgs::Point> lerpNextTarget(int32_t next_wp_idx);
 };
@@ -0,0 +1,116 @@
+/*
+ * Copyright 2015-2019 Autoware Foundation. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "libwaypoint_follower/compiled_path.h"
+
+#include <tf2/utils.h>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+void resizePath(CompiledPath *path, size_t size)
+{
+  path->x.resize(size);
+  path->y.resize(size);
+  path->z.resize(size);
+  path->yaw.resize(size);
+  path->v.resize(size);
+  path->s.resize(size);
+  path->kappa.resize(size);
+}
+
+void calcArcLengthAndCurvature(CompiledPath *path)
+{
+  const std::vector<double> &x = path->x;
+  const std::vector<double> &y = path->y;
+  std::vector<double> &s = path->s;
+  std::vector<double> &kappa = path->kappa;
+
+  const size_t n = x.size();
+  if (n == 0)
+    return;
+
+  s[0] = 0.0;
+  for (size_t i = 1; i < n; ++i)
+    s[i] = s[i - 1] + std::hypot(x[i] - x[i - 1], y[i] - y[i - 1]);
+
+  // curvature of the circle through three consecutive waypoints
+  for (size_t i = 1; i + 1 < n; ++i)
+  {
+    const double ax = x[i] - x[i - 1], ay = y[i] - y[i - 1];
+    const double bx = x[i + 1] - x[i], by = y[i + 1] - y[i];
+    const double cx = x[i + 1] - x[i - 1], cy = y[i + 1] - y[i - 1];
+    const double denominator = std::hypot(ax, ay) * std::hypot(bx, by) * std::hypot(cx, cy);
+    kappa[i] = (denominator > 0.0) ? 2.0 * (ax * by - ay * bx) / denominator : 0.0;
+  }
+  kappa[0] = (n > 2) ? kappa[1] : 0.0;
+  kappa[n - 1] = (n > 2) ? kappa[n - 2] : 0.0;
+}
+}  // namespace
+
+void CompiledPath::compile(const autoware_msgs::Lane &lane)
+{
+  resizePath(this, lane.waypoints.size());
+  for (size_t i = 0; i < lane.waypoints.size(); ++i)
+  {
+    const autoware_msgs::Waypoint &wp = lane.waypoints[i];
+    x[i] = wp.pose.pose.position.x;
+    y[i] = wp.pose.pose.position.y;
+    z[i] = wp.pose.pose.position.z;
+    yaw[i] = tf2::getYaw(wp.pose.pose.orientation);
+    v[i] = wp.twist.twist.linear.x;
+  }
+  calcArcLengthAndCurvature(this);
+}
+
+void CompiledPath::compile(const std::vector<geometry_msgs::Pose> &poses)
+{
+  resizePath(this, poses.size());
+  for (size_t i = 0; i < poses.size(); ++i)
+  {
+    x[i] = poses[i].position.x;
+    y[i] = poses[i].position.y;
+    z[i] = poses[i].position.z;
+    yaw[i] = tf2::getYaw(poses[i].orientation);
+    v[i] = 0.0;
+  }
+  calcArcLengthAndCurvature(this);
+}
+
+void CompiledPath::clear()
+{
+  resizePath(this, 0);
+}
+
+geometry_msgs::Point CompiledPath::getPosition(int32_t idx) const
+{
+  geometry_msgs::Point p;
+  p.x = x.at(idx);
+  p.y = y.at(idx);
+  p.z = z.at(idx);
+  return p;
+}
+
+geometry_msgs::Pose CompiledPath::getPose(int32_t idx) const
+{
+  geometry_msgs::Pose pose;
+  pose.position = getPosition(idx);
+  tf2::Quaternion q;
+  q.setRPY(0, 0, yaw.at(idx));
+  pose.orientation = tf2::toMsg(q);
+  return pose;
+}
@@ -0,0 +1,276 @@
+/*
+ * Copyright 2015-2019 Autoware Foundation. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "libwaypoint_follower/path_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace
+{
+// rings of grid cells searched before giving up and scanning the whole path,
+// only reached when the query is far away from every waypoint
+constexpr int64_t MAX_SEARCH_RINGS = 64;
+}  // namespace
+
+void PathIndex::build(const autoware_msgs::Lane &lane)
+{
+  std::vector<double> xs, ys;
+  xs.reserve(lane.waypoints.size());
+  ys.reserve(lane.waypoints.size());
+  for (const auto &wp : lane.waypoints)
+  {
+    xs.push_back(wp.pose.pose.position.x);
+    ys.push_back(wp.pose.pose.position.y);
+  }
+  build(xs, ys);
+}
+
+void PathIndex::build(const std::vector<double> &xs, const std::vector<double> &ys)
+{
+  clear();
+  const size_t n = std::min(xs.size(), ys.size());
+  if (n == 0)
+    return;
+
+  x_.assign(xs.begin(), xs.begin() + n);
+  y_.assign(ys.begin(), ys.begin() + n);
+
+  // cumulative arc length
+  s_.resize(n);
+  s_[0] = 0.0;
+  for (size_t i = 1; i < n; ++i)
+    s_[i] = s_[i - 1] + std::hypot(x_[i] - x_[i - 1], y_[i] - y_[i - 1]);
+
+  // bounding box
+  const auto x_minmax = std::minmax_element(x_.begin(), x_.end());
+  const auto y_minmax = std::minmax_element(y_.begin(), y_.end());
+  origin_x_ = *x_minmax.first;
+  origin_y_ = *y_minmax.first;
+  num_cells_x_ = static_cast<int32_t>(std::floor((*x_minmax.second - origin_x_) / cell_size_)) + 1;
+  num_cells_y_ = static_cast<int32_t>(std::floor((*y_minmax.second - origin_y_) / cell_size_)) + 1;
+
+  // group waypoints by cell
+  std::vector<std::pair<int64_t, int32_t>> keyed(n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    const int32_t cx = static_cast<int32_t>(std::floor((x_[i] - origin_x_) / cell_size_));
+    const int32_t cy = static_cast<int32_t>(std::floor((y_[i] - origin_y_) / cell_size_));
+    keyed[i] = std::make_pair(calcCellKey(cx, cy), static_cast<int32_t>(i));
+  }
+  std::sort(keyed.begin(), keyed.end());
+
+  cell_points_.resize(n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    cell_points_[i] = keyed[i].second;
+    if (i == 0 || keyed[i].first != keyed[i - 1].first)
+    {
+      cell_keys_.push_back(keyed[i].first);
+      cell_begin_.push_back(static_cast<int32_t>(i));
+    }
+  }
+  cell_begin_.push_back(static_cast<int32_t>(n));
+}
+
+void PathIndex::clear()
+{
+  x_.clear();
+  y_.clear();
+  s_.clear();
+  cell_keys_.clear();
+  cell_begin_.clear();
+  cell_points_.clear();
+  num_cells_x_ = 0;
+  num_cells_y_ = 0;
+  last_nearest_idx_ = -1;
+}
+
+int32_t PathIndex::findNearest(double x, double y)
+{
+  if (isEmpty())
+    return -1;
+
+  // fast path: continue from the previous nearest waypoint
+  if (last_nearest_idx_ >= 0 && last_nearest_idx_ < getSize())
+  {
+    double dist_squared;
+    const int32_t idx = findNearestInWindow(x, y, last_nearest_idx_, &dist_squared);
+    if (idx >= 0 && dist_squared <= max_window_distance_ * max_window_distance_)
+    {
+      last_nearest_idx_ = idx;
+      return idx;
+    }
+  }
+
+  last_nearest_idx_ = findNearestInGrid(x, y);
+  return last_nearest_idx_;
+}
+
+int32_t PathIndex::findLookahead(int32_t nearest_idx, double x, double y, double lookahead_distance) const
+{
+  const int32_t size = getSize();
+  if (nearest_idx < 0 || nearest_idx >= size - 1)
+    return -1;
+
+  // |p_j - pose| <= |p_nearest - pose| + (s_j - s_nearest), so every waypoint whose arc length
+  // from the nearest one is shorter than (lookahead - nearest distance) is inside the lookahead circle
+  int32_t start_idx = nearest_idx;
+  const double skip = lookahead_distance - std::sqrt(calcDistSquared(nearest_idx, x, y));
+  if (skip > 0.0)
+  {
+    start_idx = static_cast<int32_t>(
+        std::lower_bound(s_.begin() + nearest_idx, s_.end(), s_[nearest_idx] + skip) - s_.begin());
+  }
+
+  const double lookahead_squared = lookahead_distance * lookahead_distance;
+  for (int32_t i = start_idx; i < size; ++i)
+  {
+    if (calcDistSquared(i, x, y) > lookahead_squared)
+      return i;
+  }
+  return -1;
+}
+
+int64_t PathIndex::calcCellKey(int32_t cx, int32_t cy) const
+{
+  return (static_cast<int64_t>(cx) << 32) | static_cast<uint32_t>(cy);
+}
+
+double PathIndex::calcDistSquared(int32_t idx, double x, double y) const
+{
+  const double dx = x_[idx] - x;
+  const double dy = y_[idx] - y;
+  return dx * dx + dy * dy;
+}
+
+// nearest waypoint in a window biased towards the driving direction,
+// -1 if the minimum lies on a window boundary that is not a path boundary
+int32_t PathIndex::findNearestInWindow(double x, double y, int32_t center_idx, double *dist_squared) const
+{
+  const int32_t lower = std::max(0, center_idx - window_size_ / 4);
+  const int32_t upper = std::min(getSize() - 1, center_idx + window_size_);
+
+  int32_t idx_min = lower;
+  double ds_min = calcDistSquared(lower, x, y);
+  for (int32_t i = lower + 1; i <= upper; ++i)
+  {
+    const double ds = calcDistSquared(i, x, y);
+    if (ds < ds_min)
+    {
+      ds_min = ds;
+      idx_min = i;
+    }
+  }
+
+  if ((idx_min == lower && lower > 0) || (idx_min == upper && upper < getSize() - 1))
+    return -1;
+
+  *dist_squared = ds_min;
+  return idx_min;
+}
+
+// nearest waypoint by searching rings of grid cells around the query position
+int32_t PathIndex::findNearestInGrid(double x, double y) const
+{
+  const double fcx = std::floor((x - origin_x_) / cell_size_);
+  const double fcy = std::floor((y - origin_y_) / cell_size_);
+
+  // distance in cells from the query cell to the grid
+  const double gap = std::max({ 0.0, -fcx, fcx - (num_cells_x_ - 1), -fcy, fcy - (num_cells_y_ - 1) });
+  if (gap > MAX_SEARCH_RINGS)
+    return findNearestLinear(x, y);
+
+  const int64_t cx = static_cast<int64_t>(fcx);
+  const int64_t cy = static_cast<int64_t>(fcy);
+  const int64_t ring_begin = static_cast<int64_t>(gap);
+  const int64_t ring_end = std::max({ std::abs(cx), std::abs(cx - (num_cells_x_ - 1)),
+                                      std::abs(cy), std::abs(cy - (num_cells_y_ - 1)) });
+
+  int32_t idx_min = -1;
+  double ds_min = std::numeric_limits<double>::max();
+
+  auto visitCell = [&](int64_t ix, int64_t iy) {
+    if (ix < 0 || iy < 0 || ix >= num_cells_x_ || iy >= num_cells_y_)
+      return;
+    const int64_t key = calcCellKey(static_cast<int32_t>(ix), static_cast<int32_t>(iy));
+    const auto it = std::lower_bound(cell_keys_.begin(), cell_keys_.end(), key);
+    if (it == cell_keys_.end() || *it != key)
+      return;
+    const size_t cell = it - cell_keys_.begin();
+    for (int32_t k = cell_begin_[cell]; k < cell_begin_[cell + 1]; ++k)
+    {
+      const int32_t i = cell_points_[k];
+      const double ds = calcDistSquared(i, x, y);
+      // prefer the lower index on ties, as a linear scan would
+      if (ds < ds_min || (ds == ds_min && i < idx_min))
+      {
+        ds_min = ds;
+        idx_min = i;
+      }
+    }
+  };
+
+  for (int64_t r = ring_begin; r <= ring_end; ++r)
+  {
+    if (r - ring_begin > MAX_SEARCH_RINGS)
+      return findNearestLinear(x, y);
+
+    if (r == 0)
+    {
+      visitCell(cx, cy);
+    }
+    else
+    {
+      for (int64_t d = -r; d <= r; ++d)
+      {
+        visitCell(cx + d, cy - r);
+        visitCell(cx + d, cy + r);
+      }
+      for (int64_t d = -r + 1; d <= r - 1; ++d)
+      {
+        visitCell(cx - r, cy + d);
+        visitCell(cx + r, cy + d);
+      }
+    }
+
+    // every waypoint outside the searched rings is at least r cells away
+    const double searched = r * cell_size_;
+    if (idx_min >= 0 && ds_min <= searched * searched)
+      break;
+  }
+
+  return idx_min;
+}
+
+int32_t PathIndex::findNearestLinear(double x, double y) const
+{
+  int32_t idx_min = -1;
+  double ds_min = std::numeric_limits<double>::max();
+  for (int32_t i = 0; i < getSize(); ++i)
+  {
+    const double ds = calcDistSquared(i, x, y);
+    if (ds < ds_min)
+    {
+      ds_min = ds;
+      idx_min = i;
+    }
+  }
+  return idx_min;
+}
@@ -48,7 +48,7 @@ std::pair<bool, double> PurePursuit::run()
   if (!isRequirementsSatisfied())
     return error;
 
-  auto clst_pair = findClosestIdxWithDistAngThr(*curr_wps_ptr_, *curr_pose_ptr_, clst_thr_dist_, clst_thr_ang_);
+  auto clst_pair = findClosestIdx();
 
   if (!clst_pair.first)
   {
@@ -63,13 +63,13 @@ std::pair<bool, double> PurePursuit::run()
     return error;
   }
 
-  loc_next_wp_ = curr_wps_ptr_->at(next_wp_idx).position;
+  loc_next_wp_ = curr_wps_ptr_->getPosition(next_wp_idx);
 
   geometry_msgs::Point next_tgt_pos;
   // if use_lerp_ is false or next waypoint is first
   if (!use_lerp_ || next_wp_idx == 0)
   {
-    next_tgt_pos = curr_wps_ptr_->at(next_wp_idx).position;
+    next_tgt_pos = curr_wps_ptr_->getPosition(next_wp_idx);
   }
   else
   {
@@ -91,31 +91,62 @@ std::pair<bool, double> PurePursuit::run()
   return std::make_pair(true, kappa);
 }
 
+// closest waypoint within the distance and angle thresholds
+std::pair<bool, int32_t> PurePursuit::findClosestIdx() const
+{
+  const CompiledPath &path = *curr_wps_ptr_;
+  const geometry_msgs::Point &curr_pos = curr_pose_ptr_->position;
+  const double yaw_pose = tf2::getYaw(curr_pose_ptr_->orientation);
+  const double dist_thr_squared = clst_thr_dist_ * clst_thr_dist_;
+
+  double dist_squared_min = std::numeric_limits<double>::max();
+  int32_t idx_min = -1;
+
+  for (int32_t i = 0; i < path.getSize(); ++i)
+  {
+    const double dx = path.x[i] - curr_pos.x;
+    const double dy = path.y[i] - curr_pos.y;
+    const double ds = dx * dx + dy * dy;
+    if (ds > dist_thr_squared)
+      continue;
+
+    if (std::fabs(normalizeEulerAngle(yaw_pose - path.yaw[i])) > clst_thr_ang_)
+      continue;
+
+    if (ds < dist_squared_min)
+    {
+      dist_squared_min = ds;
+      idx_min = i;
+    }
+  }
+
+  return (idx_min >= 0) ? std::make_pair(true, idx_min) : std::make_pair(false, idx_min);
+}
+
 // linear interpolation of next target
 std::pair<bool, geometry_msgs::Point> PurePursuit::lerpNextTarget(int32_t next_wp_idx)
 {
   std::pair<bool, geometry_msgs::Point> error = std::make_pair(false, geometry_msgs::Point());
   constexpr double ERROR2 = 1e-5;  // 0.00001
-  const geometry_msgs::Point &vec_end = curr_wps_ptr_->at(next_wp_idx).position;
-  const geometry_msgs::Point &vec_start = curr_wps_ptr_->at(next_wp_idx - 1).position;
+  const CompiledPath &path = *curr_wps_ptr_;
   const geometry_msgs::Pose &curr_pose = *curr_pose_ptr_;
 
-  Eigen::Vector3d vec_a((vec_end.x - vec_start.x),
-                        (vec_end.y - vec_start.y),
-                        (vec_end.z - vec_start.z));
+  const double start_x = path.x[next_wp_idx - 1];
+  const double start_y = path.y[next_wp_idx - 1];
+  Eigen::Vector2d vec_a(path.x[next_wp_idx] - start_x, path.y[next_wp_idx] - start_y);
 
   if (vec_a.norm() < ERROR2)
     return error;
 
-  double lateral_error = calcLateralError2D(
-      vec_start, vec_end, curr_pose.position);
+  // signed distance of the current position from the segment, positive to the left
+  Eigen::Vector2d vec_b(curr_pose.position.x - start_x, curr_pose.position.y - start_y);
+  double lateral_error = (vec_a.x() * vec_b.y() - vec_a.y() * vec_b.x()) / vec_a.norm();
 
   if (std::fabs(lateral_error) > lookahead_distance_)
     return error;
 
   /* calculate the position of the foot of a perpendicular line */
-  Eigen::Vector2d uva2d(vec_a.x(), vec_a.y());
-  uva2d.normalize();
+  Eigen::Vector2d uva2d = vec_a.normalized();
   Eigen::Rotation2Dd rot = (lateral_error > 0) ? Eigen::Rotation2Dd(-M_PI / 2.0) : Eigen::Rotation2Dd(M_PI / 2.0);
   Eigen::Vector2d uva2d_rot = rot * uva2d;
 
@@ -144,36 +175,42 @@ std::pair<bool, geometry_msgs::Point> PurePursuit::lerpNextTarget(int32_t next_w
 
 int32_t PurePursuit::findNextPointIdx(int32_t search_start_idx)
 {
+  const CompiledPath &path = *curr_wps_ptr_;
+  const int32_t size = path.getSize();
+
   // if waypoints are not given, do nothing.
-  if (curr_wps_ptr_->size() < 3 || search_start_idx == -1)
+  if (size < 3 || search_start_idx == -1)
     return -1;
 
+  // driving direction of the path, see isDirectionForward()
+  const bool is_forward =
+      (std::cos(path.yaw[1]) * (path.x[2] - path.x[1]) + std::sin(path.yaw[1]) * (path.y[2] - path.y[1])) > 0.0;
+
+  const geometry_msgs::Point &curr_pose_point = curr_pose_ptr_->position;
+  const double yaw = tf2::getYaw(curr_pose_ptr_->orientation);
+  const double cos_yaw = std::cos(yaw);
+  const double sin_yaw = std::sin(yaw);
+  const double lookahead_squared = std::pow(lookahead_distance_, 2);
+
   // look for the next waypoint.
-  for (int32_t i = search_start_idx; i < static_cast<int32_t>(curr_wps_ptr_->size()); i++)
+  for (int32_t i = search_start_idx; i < size; i++)
   {
     // if search waypoint is the last
-    if (i == static_cast<int32_t>(curr_wps_ptr_->size() - 1))
+    if (i == size - 1)
     {
       return i;
     }
 
     // if waypoint is  not on the front
-    if (isDirectionForward(*curr_wps_ptr_))
-    {
-      if (transformToRelativeCoordinate2D(curr_wps_ptr_->at(i).position, *curr_pose_ptr_).x < 0)
-        continue;
-    }
-    else
-    {
-      if (transformToRelativeCoordinate2D(curr_wps_ptr_->at(i).position, *curr_pose_ptr_).x > 0)
-        continue;
-    }
+    const double dx = path.x[i] - curr_pose_point.x;
+    const double dy = path.y[i] - curr_pose_point.y;
+    const double rel_x = cos_yaw * dx + sin_yaw * dy;
+    if (is_forward ? (rel_x < 0) : (rel_x > 0))
+      continue;
 
-    const geometry_msgs::Point &curr_motion_point = curr_wps_ptr_->at(i).position;
-    const geometry_msgs::Point &curr_pose_point = curr_pose_ptr_->position;
     // if there exists an effective waypoint
-    const double ds = calcDistSquared2D(curr_motion_point, curr_pose_point);
-    if (ds > std::pow(lookahead_distance_, 2))
+    const double ds = dx * dx + dy * dy;
+    if (ds > lookahead_squared)
       return i;
   }
 
@@ -190,7 +227,13 @@ void PurePursuit::setCurrentPose(const geometry_msgs::Pose &msg)
 
 void PurePursuit::setWaypoints(const std::vector<geometry_msgs::Pose> &msg)
 {
-  curr_wps_ptr_ = std::make_shared<std::vector<geometry_msgs::Pose>>();
-  *curr_wps_ptr_ = msg;
+  std::shared_ptr<CompiledPath> path = std::make_shared<CompiledPath>();
+  path->compile(msg);
+  curr_wps_ptr_ = path;
+}
+
+void PurePursuit::setWaypoints(const std::shared_ptr<const CompiledPath> &path)
+{
+  curr_wps_ptr_ = path;
 }
 
@@ -0,0 +1,93 @@
+/*
+ * Copyright 2015-2019 Autoware Foundation. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <ros/ros.h>
+#include <tf2/utils.h>
+#include <cmath>
+#include <autoware_msgs/Lane.h>
+#include "libwaypoint_follower/compiled_path.h"
+
+class TestSuite : public ::testing::Test
+{
+public:
+  TestSuite()
+  {
+  }
+  ~TestSuite()
+  {
+  }
+};
+
+// counter-clockwise circle with the given radius, waypoints every 1 degree
+autoware_msgs::Lane generateCircleLane(double radius, int num)
+{
+  autoware_msgs::Lane lane;
+  for (int idx = 0; idx < num; idx++)
+  {
+    const double theta = idx * M_PI / 180.0;
+    autoware_msgs::Waypoint wp;
+    wp.pose.pose.position.x = radius * std::cos(theta);
+    wp.pose.pose.position.y = radius * std::sin(theta);
+    wp.pose.pose.position.z = 0.01 * idx;
+    tf2::Quaternion q;
+    q.setRPY(0, 0, theta + M_PI_2);
+    wp.pose.pose.orientation = tf2::toMsg(q);
+    wp.twist.twist.linear.x = 2.0;
+    lane.waypoints.emplace_back(wp);
+  }
+  return lane;
+}
+
+TEST_F(TestSuite, CompiledPath_empty)
+{
+  CompiledPath path;
+  path.compile(autoware_msgs::Lane());
+  ASSERT_EQ(true, path.isEmpty());
+  ASSERT_EQ(0, path.getSize());
+}
+
+TEST_F(TestSuite, CompiledPath_compile)
+{
+  const double radius = 10.0;
+  const autoware_msgs::Lane lane = generateCircleLane(radius, 90);
+  CompiledPath path;
+  path.compile(lane);
+  ASSERT_EQ(90, path.getSize());
+
+  const double chord = 2.0 * radius * std::sin(M_PI / 360.0);
+  for (int i = 0; i < path.getSize(); i++)
+  {
+    ASSERT_DOUBLE_EQ(lane.waypoints.at(i).pose.pose.position.x, path.x[i]);
+    ASSERT_DOUBLE_EQ(lane.waypoints.at(i).pose.pose.position.y, path.y[i]);
+    ASSERT_NEAR(tf2::getYaw(lane.waypoints.at(i).pose.pose.orientation), path.yaw[i], 1e-9);
+    ASSERT_DOUBLE_EQ(2.0, path.v[i]);
+    ASSERT_NEAR(i * chord, path.s[i], 1e-9);
+    ASSERT_NEAR(1.0 / radius, path.kappa[i], 1e-9);
+  }
+
+  const geometry_msgs::Pose pose = path.getPose(45);
+  ASSERT_DOUBLE_EQ(path.x[45], pose.position.x);
+  ASSERT_DOUBLE_EQ(lane.waypoints.at(45).pose.pose.position.z, pose.position.z);
+  ASSERT_NEAR(path.yaw[45], tf2::getYaw(pose.orientation), 1e-9);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  ros::init(argc, argv, "TestNode");
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,130 @@
+/*
+ * Copyright 2015-2019 Autoware Foundation. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <ros/ros.h>
+#include <cmath>
+#include <vector>
+#include <autoware_msgs/Lane.h>
+#include "libwaypoint_follower/path_index.h"
+
+class TestSuite : public ::testing::Test
+{
+public:
+  TestSuite()
+  {
+  }
+  ~TestSuite()
+  {
+  }
+};
+
+// S-shaped path with 0.1 m spacing
+autoware_msgs::Lane generateCurvedLane(int num)
+{
+  autoware_msgs::Lane lane;
+  for (int idx = 0; idx < num; idx++)
+  {
+    autoware_msgs::Waypoint wp;
+    wp.pose.pose.position.x = 0.1 * idx;
+    wp.pose.pose.position.y = 20.0 * std::sin(0.1 * idx / 50.0);
+    lane.waypoints.emplace_back(wp);
+  }
+  return lane;
+}
+
+int32_t findNearestBruteForce(const autoware_msgs::Lane &lane, double x, double y)
+{
+  int32_t idx_min = -1;
+  double ds_min = 1e300;
+  for (int32_t i = 0; i < static_cast<int32_t>(lane.waypoints.size()); i++)
+  {
+    const double dx = lane.waypoints.at(i).pose.pose.position.x - x;
+    const double dy = lane.waypoints.at(i).pose.pose.position.y - y;
+    if (dx * dx + dy * dy < ds_min)
+    {
+      ds_min = dx * dx + dy * dy;
+      idx_min = i;
+    }
+  }
+  return idx_min;
+}
+
+TEST_F(TestSuite, PathIndex_empty)
+{
+  PathIndex index;
+  ASSERT_EQ(true, index.isEmpty());
+  ASSERT_EQ(-1, index.findNearest(0.0, 0.0));
+  ASSERT_EQ(-1, index.findLookahead(0, 0.0, 0.0, 1.0));
+}
+
+TEST_F(TestSuite, PathIndex_findNearest)
+{
+  const autoware_msgs::Lane lane = generateCurvedLane(5000);
+  PathIndex index;
+  index.build(lane);
+  ASSERT_EQ(5000, index.getSize());
+
+  // cold queries go through the grid, including positions far away from the path
+  const double queries[][2] = { { 0.0, 0.0 }, { 123.4, 5.6 }, { 250.0, -30.0 }, { -500.0, 800.0 }, { 499.9, 0.0 } };
+  for (const auto &q : queries)
+  {
+    index.resetHint();
+    ASSERT_EQ(findNearestBruteForce(lane, q[0], q[1]), index.findNearest(q[0], q[1]));
+  }
+
+  // warm queries continue from the last nearest waypoint
+  index.resetHint();
+  for (int i = 0; i < 5000; i += 3)
+  {
+    const double x = lane.waypoints.at(i).pose.pose.position.x;
+    const double y = lane.waypoints.at(i).pose.pose.position.y + 0.5;
+    ASSERT_EQ(findNearestBruteForce(lane, x, y), index.findNearest(x, y));
+  }
+}
+
+TEST_F(TestSuite, PathIndex_findLookahead)
+{
+  const autoware_msgs::Lane lane = generateCurvedLane(5000);
+  PathIndex index;
+  index.build(lane);
+
+  const double x = 100.0, y = 2.0, lookahead = 8.0;
+  const int32_t nearest = index.findNearest(x, y);
+  int32_t expected = -1;
+  for (int32_t i = nearest; i < 5000; i++)
+  {
+    if (std::hypot(lane.waypoints.at(i).pose.pose.position.x - x, lane.waypoints.at(i).pose.pose.position.y - y) >
+        lookahead)
+    {
+      expected = i;
+      break;
+    }
+  }
+  ASSERT_EQ(expected, index.findLookahead(nearest, x, y, lookahead));
+
+  // no waypoint beyond the end of the path
+  ASSERT_EQ(-1, index.findLookahead(4999, x, y, lookahead));
+  const geometry_msgs::Point &end = lane.waypoints.at(4990).pose.pose.position;
+  ASSERT_EQ(-1, index.findLookahead(4990, end.x, end.y, lookahead));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  ros::init(argc, argv, "TestNode");
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,151 @@
+// Solve time of MpcLateral in closed loop on its own model, at the speeds and
+// curvatures the vehicle sees. The worst case is what has to fit in one cycle:
+// every solve is timed once and the maximum is reported, together with a second
+// run at tolerance 0 where every solve uses the whole iteration budget.
+//   rosrun control mpc_lateral_benchmark [cycles] [max_iteration]
+
+#include "mpc_lateral.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+const double CYCLE = 0.02;      // [s] 50 Hz control loop
+const int SUBSTEPS = 10;        // plant integration steps per cycle
+const double SEGMENT = 20.0;    // [m] length of constant curvature pieces
+
+// vehicle_param.yaml
+Vehicle_para vehicleParameters(){
+  Vehicle_para veh;
+  veh.l_f = 1.8;
+  veh.l_r = 2.2;
+  veh.Iz = 15000;
+  veh.m = 5000;
+  veh.C_f = 200000;
+  veh.C_r = 400000;
+  return veh;
+}
+
+// control_para.yaml
+Mpc_para mpcParameters(int max_iteration){
+  Mpc_para para;
+  para.dt = 0.1;
+  para.q = {1.0, 0.0, 1.0, 0.0};
+  para.r = 1.0;
+  para.r_rate = 10.0;
+  para.max_angle = 20.0 * M_PI / 180.0;
+  para.min_speed = 1.0;
+  para.max_iteration = max_iteration;
+  para.tolerance = 1e-5;
+  para.vehicle = vehicleParameters();
+  return para;
+}
+
+struct Result{
+  std::vector<double> solve_us;
+  int max_iterations = 0;
+  int capped = 0;
+  double max_error = 0;
+};
+
+Result runClosedLoop(const Mpc_para &para, int cycles){
+  MpcLateral mpc;
+  mpc.setParameters(para);
+
+  // the same path and speeds for every run
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> unit(-1.0, 1.0);
+
+  // path curvature per SEGMENT metres, scaled to the speed below
+  std::vector<double> kappa_of_segment(1024);
+  for (double &k : kappa_of_segment){
+    k = unit(rng);
+  }
+  auto pathKappa = [&](double s){
+    const int i = static_cast<int>(s / SEGMENT) % static_cast<int>(kappa_of_segment.size());
+    return kappa_of_segment[i];
+  };
+
+  Result result;
+  result.solve_us.reserve(cycles);
+
+  Eigen::Vector4d x = Eigen::Vector4d::Zero();
+  double s = 0;
+  double speed = 5.0;
+  for (int cycle = 0; cycle < cycles; cycle++){
+    // a new speed every 10 s
+    if (cycle % 500 == 0){
+      speed = 8.0 + 7.0 * unit(rng);
+    }
+    // radius 20 m and at most 2 m/s^2 lateral acceleration, within the steering limit
+    const double kappa_max = std::min(0.05, 2.0 / (speed * speed));
+
+    MpcLateral::Sequence kappa;
+    for (int k = 0; k < MpcLateral::N; k++){
+      kappa(k) = kappa_max * pathKappa(s + speed * para.dt * k);
+    }
+
+    // timed once, a preempted solve counts as it would in the control loop
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    const double delta = mpc.outputFrontWheelAngle(speed, x, kappa);
+    std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+    result.solve_us.push_back(std::chrono::duration<double, std::micro>(t2 - t1).count());
+    result.max_iterations = std::max(result.max_iterations, mpc.getIterations());
+    if (mpc.getIterations() == para.max_iteration){
+      result.capped++;
+    }
+
+    // plant: the continuous model, the path curvature changing under it
+    Eigen::Matrix4d A;
+    Eigen::Vector4d B, E;
+    lateralErrorModel(para.vehicle, speed, A, B, E);
+    const double h = CYCLE / SUBSTEPS;
+    for (int i = 0; i < SUBSTEPS; i++){
+      x += h * (A * x + B * delta + E * speed * kappa_max * pathKappa(s));
+      s += speed * h;
+    }
+    result.max_error = std::max(result.max_error, std::abs(x(0)));
+  }
+  return result;
+}
+
+void printSolveTime(const char *name, const Result &result){
+  std::vector<double> sorted = result.solve_us;
+  std::sort(sorted.begin(), sorted.end());
+  double mean = 0;
+  for (double t : sorted){
+    mean += t;
+  }
+  mean /= sorted.size();
+  std::printf("  %-12s  mean %8.2f us   p99 %8.2f us   max %8.2f us   (cycle %.0f us)\n",
+              name, mean, sorted[sorted.size() * 99 / 100], sorted.back(), CYCLE * 1e6);
+}
+
+}
+
+int main(int argc, char **argv){
+  const int cycles = (argc > 1) ? std::atoi(argv[1]) : 100000;
+  const int max_iteration = (argc > 2) ? std::atoi(argv[2]) : 200;
+
+  const Mpc_para para = mpcParameters(max_iteration);
+  const Result result = runClosedLoop(para, cycles);
+
+  // no early exit, every solve runs max_iteration iterations: the bound the budget guarantees
+  Mpc_para forced_para = para;
+  forced_para.tolerance = 0.0;
+  const Result forced = runClosedLoop(forced_para, cycles);
+
+  std::printf("MpcLateral, horizon %d x %.2f s, %d cycles at 1-15 m/s\n", MpcLateral::N, para.dt, cycles);
+  printSolveTime("solve time", result);
+  printSolveTime("full budget", forced);
+  std::printf("  iterations    max %d of %d, budget used up in %d cycles\n",
+              result.max_iterations, max_iteration, result.capped);
+  std::printf("  tracking      max lateral error %.3f m\n", result.max_error);
+  return 0;
+}
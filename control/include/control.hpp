@@ -16,6 +16,9 @@
 #include "pid.hpp"
 #include "pure_pursuit.hpp"
 #include "lqr_path_tracking.hpp"
+#include "mpc_lateral.hpp"
+#include <libwaypoint_follower/compiled_path.h>
+#include <libwaypoint_follower/path_index.h>
 
 namespace ns_control {
 
@@ -49,6 +52,7 @@ class Control {
   void setPidParameters(const Pid_para &msg);
   void setPurePursuitParameters(const Pure_pursuit_para &msg);
   void setLQRParameters(const LQR_para &msg);
+  void setMpcParameters(const Mpc_para &msg);
   void setControlParameters(const Para &msg);
   void setVirtualVehicleState(const common_msgs::VirtualVehicleState &msg);
 
@@ -68,8 +72,11 @@ class Control {
 
   ros::NodeHandle &nh_;
 
-  autoware_msgs::Lane final_waypoints;
-  std::vector<autoware_msgs::Waypoint> current_waypoints;
+  CompiledPath final_waypoints;
+  int final_waypoints_version = 0;
+  ros::Time final_waypoints_stamp;
+  size_t final_waypoints_size = 0;
+  PathIndex path_index;
   nav_msgs::Odometry utm_pose;
   geometry_msgs::Pose current_pose;
   common_msgs::ChassisState vehicle_dynamic_state;
@@ -81,28 +88,29 @@ class Control {
   PID pid_controller;
   Pure_pursuit pp_controller;
   LQRPathTracking lqr_controller;
+  MpcLateral mpc_controller;
 
   Pid_para pid_para;
   Pure_pursuit_para pp_para;
   LQR_para lqr_para;
+  Mpc_para mpc_para;
   
   Para control_para;
   
   // methods
 
   double lookahead_distance;
-  autoware_msgs::Waypoint nearest_waypoint;
-  autoware_msgs::Waypoint lookahead_waypoint;
   geometry_msgs::PoseStamped nearest_ps;
   geometry_msgs::PoseStamped lookahead_ps;
   geometry_msgs::PointStamped nearest_point;
   geometry_msgs::PointStamped lookahead_point;
 
-  // int nearest_waypoint_idx;
+  int nearest_waypoint_idx = -1;
   // int lookahead_waypoint_idx;
   
   int findNearestWaypoint();
   int findLookAheadWaypoint(float lookAheadDistance);
+  double mpcFrontWheelAngle(double v_x, double cur_yaw);
 };
 }
 
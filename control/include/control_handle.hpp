@@ -59,6 +59,7 @@ class ControlHandle {
   Pid_para pid_para_;
   Pure_pursuit_para pp_para_;
   LQR_para lqr_para_;
+  Mpc_para mpc_para_;
 
   Control control_;
 
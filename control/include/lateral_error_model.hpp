@@ -0,0 +1,54 @@
+#ifndef LATERAL_ERROR_MODEL_H
+#define LATERAL_ERROR_MODEL_H
+
+#include <Eigen/Core>
+#include <Eigen/LU>
+
+struct Vehicle_para{
+  double l_f;   // [m] cog to front axle
+  double l_r;   // [m] cog to rear axle
+  double Iz;    // [kg m^2] yaw inertia
+  double m;     // [kg]
+  double C_f;   // [N/rad] cornering stiffness of the front axle
+  double C_r;   // [N/rad] cornering stiffness of the rear axle
+};
+
+/*
+  Bicycle model in the path frame at speed v:
+    x_dot = A x + B delta + E psi_des_dot
+  with state x = (e, e_dot, psi_e, psi_e_dot), e the lateral offset from the
+  path and psi_e the heading relative to it, both positive to the left, delta
+  the front wheel angle and psi_des_dot = v * kappa the yaw rate of the path.
+*/
+inline void lateralErrorModel(const Vehicle_para &veh, double v,
+                              Eigen::Matrix4d &A, Eigen::Vector4d &B, Eigen::Vector4d &E){
+  const double c_sum = veh.C_f + veh.C_r;
+  const double c_moment = veh.C_f * veh.l_f - veh.C_r * veh.l_r;
+  const double c_inertia = veh.C_f * veh.l_f * veh.l_f + veh.C_r * veh.l_r * veh.l_r;
+  A = Eigen::Matrix4d::Zero();
+  A(0, 1) = 1.0;
+  A(1, 1) = -c_sum / (veh.m * v);
+  A(1, 2) = c_sum / veh.m;
+  A(1, 3) = -c_moment / (veh.m * v);
+  A(2, 3) = 1.0;
+  A(3, 1) = -c_moment / (veh.Iz * v);
+  A(3, 2) = c_moment / veh.Iz;
+  A(3, 3) = -c_inertia / (veh.Iz * v);
+  B << 0.0, veh.C_f / veh.m, 0.0, veh.C_f * veh.l_f / veh.Iz;
+  E << 0.0, -c_moment / (veh.m * v) - v, 0.0, -c_inertia / (veh.Iz * v);
+}
+
+/*
+  Bilinear discretisation with period dt, keeps the discrete model stable
+  wherever the continuous one is. Inputs are held over the period.
+*/
+inline void discretiseLateralErrorModel(const Eigen::Matrix4d &A, const Eigen::Vector4d &B, const Eigen::Vector4d &E,
+                                        double dt, Eigen::Matrix4d &Ad, Eigen::Vector4d &Bd, Eigen::Vector4d &Ed){
+  const Eigen::Matrix4d I = Eigen::Matrix4d::Identity();
+  const Eigen::Matrix4d M = (I - 0.5 * dt * A).inverse();
+  Ad = M * (I + 0.5 * dt * A);
+  Bd = M * B * dt;
+  Ed = M * E * dt;
+}
+
+#endif //LATERAL_ERROR_MODEL_H
@@ -9,22 +9,54 @@
 #include <string>
 #include <fstream>
 #include <cmath>
+#include <atomic>
+#include <thread>
+#include "lateral_error_model.hpp"
 
 struct LQR_para{
-  std::string para_filename;   
+  std::string para_filename;
+  std::string gain_source;      // file: gains from para_filename, riccati: solved from the vehicle model
+  bool solve_in_background;     // riccati: solve on a thread, the file gains are used until it is done
+  double dt;                    // [s] controller period the model is discretised with
+  double speed_min;             // [m/s] gain table range and resolution
+  double speed_max;
+  double speed_step;
+  std::vector<double> q;        // weights of lateral error, its rate, heading error, its rate
+  double r;                     // weight of the front wheel angle
+  int max_iteration;            // riccati iterations per speed
+  double tolerance;             // converged when no element of P changes more than this
+  Vehicle_para vehicle;
 };
 
 class LQRPathTracking{
     private:
         // double control_output;
-        std::vector<std::vector<double>> k_vector;
-        
+
+        // gains of consecutive speeds in one flat array, 4 per row
+        struct GainTable{
+            double speed_min = 0.0;
+            double speed_step = 1.0;
+            int rows = 0;
+            std::vector<double> k;
+        };
+        GainTable gain_table;
+
+        // riccati table of the solver thread, taken over by the control thread once solved
+        GainTable solved_table;
+        std::atomic<bool> solved_flag;
+        std::thread solver_thread;
+
+        static bool solveGainTable(const LQR_para &para, GainTable &table);
+        void adoptSolvedTable();
 
     public:
         std::string lqr_para_filename;
         LQRPathTracking();
+        ~LQRPathTracking();
         void readLQRParameters();
+        void computeLQRGains(const LQR_para &para);
+        void getGains(const double current_speed, double k[4]);
         double outputFrontWheelAngle(const double current_speed, const std::vector<double> &current_state);
 };
 
-#endif //LQR_PATH_TRACKING
\ No newline at end of file
+#endif //LQR_PATH_TRACKING
@@ -0,0 +1,71 @@
+#ifndef MPC_LATERAL_H
+#define MPC_LATERAL_H
+
+#include <vector>
+#include <Eigen/Core>
+#include "lateral_error_model.hpp"
+
+struct Mpc_para{
+  double dt;                // [s] prediction step
+  std::vector<double> q;    // weights of lateral error, its rate, heading error, its rate
+  double r;                 // weight of the front wheel angle
+  double r_rate;            // weight of the change of the front wheel angle from step to step
+  double max_angle;         // [rad] front wheel angle limit
+  double min_speed;         // [m/s] the model is singular at standstill, slower speeds use this one
+  int max_iteration;        // solver iterations per cycle, bounds the solve time
+  double tolerance;         // [rad] converged when no front wheel angle changes more than this
+  Vehicle_para vehicle;
+};
+
+/*
+  Lateral model predictive controller on the path frame bicycle model.
+
+  The inputs of the whole horizon are the only unknowns (condensed form), the
+  states are eliminated through the prediction, leaving a box constrained QP
+  of fixed size N. It is solved by accelerated projected gradient from the
+  previous solution, with at most max_iteration iterations of one N x N
+  matrix-vector product each, so the solve time has a fixed upper bound.
+*/
+class MpcLateral{
+ public:
+  static const int N = 20;   // horizon in prediction steps
+  typedef Eigen::Matrix<double, N, 1> Sequence;
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  // Constructor
+  MpcLateral();
+
+  // Getters
+  int getIterations() const;
+  const Sequence &getInputSequence() const;
+
+  // Setters
+  void setParameters(const Mpc_para &para);
+
+  // Methods
+  void reset();
+  // state (e, e_dot, psi_e, psi_e_dot) as in lateralErrorModel(), kappa the path curvature
+  // at each prediction step. Returns the front wheel angle [rad], positive to the left.
+  double outputFrontWheelAngle(double speed, const Eigen::Vector4d &state, const Sequence &kappa);
+
+ private:
+  Mpc_para para;
+  Eigen::Matrix4d Q;
+
+  Sequence u_sequence;      // solution of the last cycle, the next warm start
+  double u_applied = 0.0;   // first input of the last cycle, for the rate weight
+  int iterations = 0;
+
+  // condensed QP 1/2 U'HU + g'U, prediction X = Gamma U + X_free
+  Eigen::Matrix<double, 4 * N, N> Gamma;
+  Eigen::Matrix<double, 4 * N, N> QGamma;
+  Eigen::Matrix<double, 4 * N, 1> X_free;
+  Eigen::Matrix<double, N, N> H;
+  Sequence g;
+
+  void buildQP(double speed, const Eigen::Vector4d &state, const Sequence &kappa);
+  void solveQP();
+};
+
+#endif //MPC_LATERAL_H
@@ -39,8 +39,17 @@ namespace ns_control
 
   // Setters
   void Control::setFinalWaypoints(const autoware_msgs::Lane &msg){
-    final_waypoints = msg;
-    current_waypoints = final_waypoints.waypoints;
+    // The waypoint loader sets a new increment and stamp on every load, 0 means unversioned.
+    // A repeat must match all three, so a path from another (restarted) loader is never skipped
+    if (finalWaypointsFlag && msg.increment != 0 && msg.increment == final_waypoints_version &&
+        msg.header.stamp == final_waypoints_stamp && msg.waypoints.size() == final_waypoints_size){
+      return;
+    }
+    final_waypoints_version = msg.increment;
+    final_waypoints_stamp = msg.header.stamp;
+    final_waypoints_size = msg.waypoints.size();
+    final_waypoints.compile(msg);
+    path_index.build(final_waypoints.x, final_waypoints.y);
   }
   void Control::setVehicleDynamicState(const common_msgs::ChassisState &msg){
     vehicle_dynamic_state = msg;
@@ -73,6 +82,12 @@ namespace ns_control
     lqr_para = msg;
     lqr_controller.lqr_para_filename = lqr_para.para_filename;
     lqr_controller.readLQRParameters();
+    lqr_controller.computeLQRGains(lqr_para);
+  }
+
+  void Control::setMpcParameters(const Mpc_para &msg){
+    mpc_para = msg;
+    mpc_controller.setParameters(mpc_para);
   }
 
   void Control::setControlParameters(const Para &msg){
@@ -80,54 +95,41 @@ namespace ns_control
     
   }
   int Control::findNearestWaypoint(){
-    int waypoints_size = current_waypoints.size();
+    int waypoints_size = final_waypoints.getSize();
     if (waypoints_size == 0){
       ROS_WARN("No waypoints in final_waypoints.");
+      nearest_waypoint_idx = -1;
       return -1;
     }
 
-    // find nearest point
-    int nearest_idx = 0;
-    double nearest_distance = getPlaneDistance(current_waypoints.at(0).pose.pose.position,current_pose.position);
-    for (int i = 0; i < waypoints_size; i++){
-      // if search waypoint is the last
-      if(i == (waypoints_size - 1)){
-        ROS_INFO("search waypoint is the last");
-        // break;
-      }
-      double dis = getPlaneDistance(current_waypoints.at(i).pose.pose.position,current_pose.position);
-      if (dis < nearest_distance){
-        nearest_idx = i;
-        nearest_distance = dis;
-      }
+    // find nearest point, continuing from the last nearest waypoint
+    int nearest_idx = path_index.findNearest(current_pose.position.x, current_pose.position.y);
+    if (nearest_idx == waypoints_size - 1){
+      ROS_INFO("search waypoint is the last");
     }
-    nearest_waypoint = final_waypoints.waypoints[nearest_idx];
-    nearest_ps = nearest_waypoint.pose;
+    nearest_ps.pose = final_waypoints.getPose(nearest_idx);
     nearest_point.point = nearest_ps.pose.position;
+    nearest_waypoint_idx = nearest_idx;
     return nearest_idx;
   }
 
   int Control::findLookAheadWaypoint(float lookAheadDistance){
-    int waypoints_size = current_waypoints.size();
-    int nearest_waypoint_idx = findNearestWaypoint();
-    if (nearest_waypoint_idx < 0 | nearest_waypoint_idx == waypoints_size - 1){
+    int waypoints_size = final_waypoints.getSize();
+    findNearestWaypoint();
+    if (nearest_waypoint_idx < 0 || nearest_waypoint_idx == waypoints_size - 1){
       return -1;
     }
     
     // look for the next waypoint
-    for (int j = nearest_waypoint_idx; j < waypoints_size; j++){
-      // if search waypoint is the last
-      if (j == (waypoints_size - 1)){
-        ROS_INFO("search waypoints is the last");
-      }
-      // if there exists an effective waypoint
-      if (getPlaneDistance(current_waypoints.at(j).pose.pose.position, current_pose.position) > lookAheadDistance){
-          lookahead_waypoint = final_waypoints.waypoints[j];
-          lookahead_ps = lookahead_waypoint.pose;
-          lookahead_point.point = lookahead_ps.pose.position;
-        return j;
-      }
+    int j = path_index.findLookahead(nearest_waypoint_idx, current_pose.position.x,
+                                     current_pose.position.y, lookAheadDistance);
+    if (j < 0){
+      ROS_INFO("search waypoints is the last");
+      return -1;
     }
+    lookahead_ps.pose = final_waypoints.getPose(j);
+    lookahead_point.point = lookahead_ps.pose.position;
+    return j;
   }
 
   double Control::latControlUpdate(){
@@ -193,13 +195,13 @@ namespace ns_control
           front_wheel_angle = lqr_controller.outputFrontWheelAngle(v_x,current_state);
         }
         break;
-      case 3:{
-          ROS_INFO("Feedforward plus feedback.");
-          if (virtualFlag){
-
-          }
-
-      }
+      case 3: // mpc controller
+        {
+          front_wheel_angle = mpcFrontWheelAngle(v_x, cur_yaw);
+          ROS_INFO_STREAM("Using mpc controller, output: " << front_wheel_angle
+                          << ", iterations: " << mpc_controller.getIterations());
+        }
+        break;
       default:{
         front_wheel_angle = 0;
         ROS_WARN("Illegal controller id!");
@@ -210,6 +212,41 @@ namespace ns_control
     return front_wheel_angle;
   }
 
+  double Control::mpcFrontWheelAngle(double v_x, double cur_yaw){
+    if (nearest_waypoint_idx < 0){
+      return 0;
+    }
+    const int i = nearest_waypoint_idx;
+    const int waypoints_size = final_waypoints.getSize();
+    const double path_yaw = final_waypoints.yaw[i];
+    const double dx = current_pose.position.x - final_waypoints.x[i];
+    const double dy = current_pose.position.y - final_waypoints.y[i];
+
+    // offset and heading relative to the path, positive to the left
+    double heading_error = cur_yaw - path_yaw;
+    if (heading_error > M_PI) heading_error -= 2 * M_PI;
+    else if (heading_error < -M_PI) heading_error += 2 * M_PI;
+    Eigen::Vector4d state;
+    state(0) = -std::sin(path_yaw) * dx + std::cos(path_yaw) * dy;
+    state(1) = v_x * std::sin(heading_error);
+    state(2) = heading_error;
+    state(3) = vehicle_dynamic_state.vehicle_yaw_rate - v_x * final_waypoints.kappa[i];
+
+    // curvature of the path where the vehicle will be at each prediction step
+    MpcLateral::Sequence kappa;
+    const double step = std::max(v_x, mpc_para.min_speed) * mpc_para.dt;
+    int j = i;
+    for (int k = 0; k < MpcLateral::N; k++){
+      const double s = final_waypoints.s[i] + step * k;
+      while (j + 1 < waypoints_size && final_waypoints.s[j + 1] <= s){
+        j++;
+      }
+      kappa(k) = final_waypoints.kappa[j];
+    }
+
+    return mpc_controller.outputFrontWheelAngle(v_x, state, kappa) * 180 / M_PI;
+  }
+
   double Control::lonControlUpdate(){
     
   }
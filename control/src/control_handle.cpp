@@ -15,6 +15,7 @@ ControlHandle::ControlHandle(ros::NodeHandle &nodeHandle) :
   control_.setPurePursuitParameters(pp_para_);
   control_.setControlParameters(control_para_);
   control_.setLQRParameters(lqr_para_);
+  control_.setMpcParameters(mpc_para_);
   // control_mode_ = control_para_.longitudinal_mode; 
   // 1: constant speed 2: planned sped, 3: desired distance
   subscribeToTopics();
@@ -101,6 +102,48 @@ void ControlHandle::loadParameters() {
   
   // LQR path tracking parameters
   nodeHandle_.param<std::string>("lqr_para_filename", lqr_para_.para_filename,"../config/lqr_para/lqr_para.txt");
+  nodeHandle_.param<std::string>("lqr/gain_source", lqr_para_.gain_source, "file");
+  nodeHandle_.param<bool>("lqr/solve_in_background", lqr_para_.solve_in_background, true);
+  nodeHandle_.param<double>("lqr/speed_min", lqr_para_.speed_min, 0.5);
+  nodeHandle_.param<double>("lqr/speed_max", lqr_para_.speed_max, 15.0);
+  nodeHandle_.param<double>("lqr/speed_step", lqr_para_.speed_step, 0.1);
+  if (!nodeHandle_.param("lqr/q", lqr_para_.q, std::vector<double>{0.1, 0.0, 0.0, 0.0})) {
+    ROS_WARN_STREAM("Did not load lqr/q. Standard value is: 0.1, 0, 0, 0");
+  }
+  nodeHandle_.param<double>("lqr/r", lqr_para_.r, 1.0);
+  nodeHandle_.param<int>("lqr/max_iteration", lqr_para_.max_iteration, 100000);
+  nodeHandle_.param<double>("lqr/tolerance", lqr_para_.tolerance, 1e-9);
+  lqr_para_.dt = 1.0 / node_rate_;
+
+  // MPC lateral controller parameters
+  nodeHandle_.param<double>("mpc/dt", mpc_para_.dt, 0.1);
+  if (!nodeHandle_.param("mpc/q", mpc_para_.q, std::vector<double>{1.0, 0.0, 1.0, 0.0})) {
+    ROS_WARN_STREAM("Did not load mpc/q. Standard value is: 1, 0, 1, 0");
+  }
+  nodeHandle_.param<double>("mpc/r", mpc_para_.r, 1.0);
+  nodeHandle_.param<double>("mpc/r_rate", mpc_para_.r_rate, 10.0);
+  double max_angle_deg;
+  nodeHandle_.param<double>("mpc/max_angle", max_angle_deg, LIMIT_STEERING_ANGLE);
+  mpc_para_.max_angle = max_angle_deg * M_PI / 180.0;
+  nodeHandle_.param<double>("mpc/min_speed", mpc_para_.min_speed, 1.0);
+  nodeHandle_.param<int>("mpc/max_iteration", mpc_para_.max_iteration, 200);
+  nodeHandle_.param<double>("mpc/tolerance", mpc_para_.tolerance, 1e-5);
+
+  // Vehicle parameters of the lqr and mpc models, vehicle_param.yaml
+  bool model_based = lqr_para_.gain_source == "riccati" || control_para_.lat_controller_id == 3;
+  if (model_based && !nodeHandle_.hasParam("vehicle/m")) {
+    ROS_WARN("Did not load vehicle parameters for the lateral model. Using standard values.");
+  }
+  Vehicle_para vehicle;
+  nodeHandle_.param<double>("vehicle/l_f", vehicle.l_f, 1.8);
+  nodeHandle_.param<double>("vehicle/l_r", vehicle.l_r, 2.2);
+  nodeHandle_.param<double>("vehicle/Iz", vehicle.Iz, 15000);
+  nodeHandle_.param<double>("vehicle/m", vehicle.m, 5000);
+  nodeHandle_.param<double>("vehicle/C_f", vehicle.C_f, 200000);
+  nodeHandle_.param<double>("vehicle/C_r", vehicle.C_r, 400000);
+  lqr_para_.vehicle = vehicle;
+  mpc_para_.vehicle = vehicle;
+  ROS_INFO_STREAM("lqr gain source: " << lqr_para_.gain_source);
 
 }
 
@@ -1,43 +1,176 @@
 #include "lqr_path_tracking.hpp"
+#include <Eigen/Dense>
+
+namespace {
+
+typedef Eigen::Matrix4d Matrix4;
+typedef Eigen::Vector4d Vector4;
 
-LQRPathTracking::LQRPathTracking(){
+}
+
+LQRPathTracking::LQRPathTracking() : solved_flag(false){
+}
+
+LQRPathTracking::~LQRPathTracking(){
+    if (solver_thread.joinable()){
+        solver_thread.join();
+    }
 }
 
 void LQRPathTracking::readLQRParameters(){
     using namespace std;
     ifstream f(lqr_para_filename);
     string temp;
-    vector<double> temp_line;
+    // row i holds the gains of (i + 1) m/s
+    GainTable table;
+    table.speed_min = 1.0;
+    table.speed_step = 1.0;
     while (getline(f,temp))
     {
         stringstream input(temp);
         string out;
-        while (input >> out){
-            temp_line.push_back(stod(out));
+        int n = 0;
+        while (n < 4 && input >> out){
+            table.k.push_back(stod(out));
+            n++;
         }
-        k_vector.push_back(temp_line);
-        temp_line.clear();
+        if (n == 0){
+            continue;
+        }
+        table.k.resize(table.k.size() + 4 - n, 0.0);
+        table.rows++;
     }
-    ROS_INFO_STREAM("Loaded! Size of LQR parameters: " << k_vector.size());
+    ROS_INFO_STREAM("Loaded! Size of LQR parameters: " << table.rows);
     f.close();
+    gain_table = table;
+}
+
+void LQRPathTracking::computeLQRGains(const LQR_para &para){
+    if (para.gain_source != "riccati"){
+        return;
+    }
+    if (para.solve_in_background){
+        if (solver_thread.joinable()){
+            solver_thread.join();
+        }
+        solved_flag = false;
+        solver_thread = std::thread([this, para](){
+            if (solveGainTable(para, solved_table)){
+                solved_flag.store(true, std::memory_order_release);
+            }
+        });
+        return;
+    }
+    GainTable table;
+    if (solveGainTable(para, table)){
+        gain_table = table;
+    }
+}
+
+bool LQRPathTracking::solveGainTable(const LQR_para &para, GainTable &table){
+    if (para.speed_min <= 0 || para.speed_step <= 0 || para.speed_max < para.speed_min
+        || para.dt <= 0 || para.q.size() != 4 || para.r <= 0){
+        ROS_ERROR("[LQR] invalid riccati parameters, keeping the gains from %s.", para.para_filename.c_str());
+        return false;
+    }
+
+    ros::WallTime start = ros::WallTime::now();
+    table.speed_min = para.speed_min;
+    table.speed_step = para.speed_step;
+    table.rows = static_cast<int>(std::floor((para.speed_max - para.speed_min) / para.speed_step + 1e-9)) + 1;
+    table.k.assign(table.rows * 4, 0.0);
+
+    Matrix4 Q = Matrix4::Zero();
+    for (int i = 0; i < 4; i++){
+        Q(i, i) = para.q[i];
+    }
+
+    // neighbouring speeds have close solutions, each row starts from the previous P
+    Matrix4 P = Q;
+    int total_iterations = 0;
+    for (int row = 0; row < table.rows; row++){
+        const double v = para.speed_min + row * para.speed_step;
+        Matrix4 A, Ad;
+        Vector4 B, E, Bd, Ed;
+        lateralErrorModel(para.vehicle, v, A, B, E);
+        discretiseLateralErrorModel(A, B, E, para.dt, Ad, Bd, Ed);
+
+        // P = Q + Ad'P Ad - Ad'P Bd (r + Bd'P Bd)^-1 Bd'P Ad
+        Eigen::RowVector4d K;
+        int it = 0;
+        double diff = 0;
+        for (; it < para.max_iteration; it++){
+            const Vector4 PB = P * Bd;
+            K = (PB.transpose() * Ad) / (para.r + Bd.dot(PB));
+            Matrix4 P_next = Q + Ad.transpose() * P * Ad - (Ad.transpose() * PB) * K;
+            P_next = 0.5 * (P_next + P_next.transpose()).eval();
+            diff = (P_next - P).cwiseAbs().maxCoeff();
+            P = P_next;
+            if (diff < para.tolerance){
+                break;
+            }
+        }
+        total_iterations += it;
+        if (it == para.max_iteration){
+            ROS_WARN("[LQR] riccati not converged at %.2f m/s after %d iterations, last change %g.", v, it, diff);
+        }
+        const Vector4 PB = P * Bd;
+        K = (PB.transpose() * Ad) / (para.r + Bd.dot(PB));
+        for (int i = 0; i < 4; i++){
+            table.k[row * 4 + i] = K(i);
+        }
+    }
+    ROS_INFO("[LQR] solved %d gains from %.2f to %.2f m/s in %.1f ms, %d iterations.", table.rows,
+             table.speed_min, table.speed_min + (table.rows - 1) * table.speed_step,
+             (ros::WallTime::now() - start).toSec() * 1e3, total_iterations);
+    return true;
+}
+
+void LQRPathTracking::adoptSolvedTable(){
+    if (!solved_flag.load(std::memory_order_acquire)){
+        return;
+    }
+    solved_flag = false;
+    solver_thread.join();
+    gain_table = std::move(solved_table);
+    ROS_INFO("[LQR] using the riccati gains.");
+}
+
+void LQRPathTracking::getGains(const double current_speed, double k[4]){
+    adoptSolvedTable();
+    if (gain_table.rows == 0){
+        ROS_WARN_THROTTLE(1.0, "[LQR] no gains loaded.");
+        k[0] = k[1] = k[2] = k[3] = 0;
+        return;
+    }
+    // linear between the two neighbouring speeds, clamped to the table
+    const double s = (current_speed - gain_table.speed_min) / gain_table.speed_step;
+    int i = 0;
+    double f = 0;
+    if (s >= gain_table.rows - 1){
+        i = gain_table.rows - 1;
+    }else if (s > 0){
+        i = static_cast<int>(s);
+        f = s - i;
+    }
+    const double *k0 = &gain_table.k[i * 4];
+    const double *k1 = (f > 0) ? k0 + 4 : k0;
+    for (int j = 0; j < 4; j++){
+        k[j] = k0[j] + f * (k1[j] - k0[j]);
+    }
 }
 
-double LQRPathTracking::outputFrontWheelAngle(const double current_speed, 
+double LQRPathTracking::outputFrontWheelAngle(const double current_speed,
                                           const std::vector<double> &current_state){
-    int speed_level = floor(current_speed/1.0);
+    double k[4];
+    getGains(current_speed, k);
     double u = 0;
     double lateral_error =  current_state[0];
     double dot_lateral_error = current_state[1];
     double heading_error = current_state[2];
     double dot_heading_error = current_state[3];
-    int p;
-    if (speed_level > 0 && speed_level < 12){
-        p = speed_level - 1;
-    }else{
-         p = 0;
-    }
-    u = k_vector[p][0] * lateral_error + k_vector[p][1] * dot_lateral_error
-       +k_vector[p][2] * heading_error + k_vector[p][3] * dot_heading_error;
-    u = u * 180/M_PI;    
+    u = k[0] * lateral_error + k[1] * dot_lateral_error
+       +k[2] * heading_error + k[3] * dot_heading_error;
+    u = u * 180/M_PI;
     return u;
 }
@@ -0,0 +1,107 @@
+#include "mpc_lateral.hpp"
+#include <algorithm>
+#include <cmath>
+
+// Constructor
+MpcLateral::MpcLateral(){
+  Q = Eigen::Matrix4d::Zero();
+  reset();
+}
+
+// Getters
+int MpcLateral::getIterations() const { return iterations; }
+const MpcLateral::Sequence &MpcLateral::getInputSequence() const { return u_sequence; }
+
+// Setters
+void MpcLateral::setParameters(const Mpc_para &msg){
+  para = msg;
+  Q = Eigen::Matrix4d::Zero();
+  for (int i = 0; i < 4 && i < static_cast<int>(para.q.size()); i++){
+    Q(i, i) = para.q[i];
+  }
+  reset();
+}
+
+// Methods
+void MpcLateral::reset(){
+  u_sequence.setZero();
+  u_applied = 0.0;
+  iterations = 0;
+}
+
+double MpcLateral::outputFrontWheelAngle(double speed, const Eigen::Vector4d &state, const Sequence &kappa){
+  buildQP(std::max(speed, para.min_speed), state, kappa);
+  solveQP();
+  u_applied = u_sequence(0);
+  return u_applied;
+}
+
+void MpcLateral::buildQP(double speed, const Eigen::Vector4d &state, const Sequence &kappa){
+  Eigen::Matrix4d A, Ad;
+  Eigen::Vector4d B, E, Bd, Ed;
+  lateralErrorModel(para.vehicle, speed, A, B, E);
+  discretiseLateralErrorModel(A, B, E, para.dt, Ad, Bd, Ed);
+
+  /*
+   * x_k+1 = Ad x_k + Bd u_k + Ed v kappa_k, stacked for k = 0..N-1:
+   * block (k, j) of Gamma is Ad^(k-j) Bd for j <= k, the free response
+   * follows the path curvature with all inputs zero.
+   */
+  Eigen::Vector4d S = Bd;
+  Gamma.setZero();
+  for (int i = 0; i < N; i++){
+    for (int j = 0; j + i < N; j++){
+      Gamma.block<4, 1>(4 * (j + i), j) = S;
+    }
+    S = Ad * S;
+  }
+  Eigen::Vector4d x = state;
+  for (int k = 0; k < N; k++){
+    x = Ad * x + Ed * (speed * kappa(k));
+    X_free.segment<4>(4 * k) = x;
+  }
+
+  for (int k = 0; k < N; k++){
+    QGamma.block<4, N>(4 * k, 0).noalias() = Q * Gamma.block<4, N>(4 * k, 0);
+  }
+  H.noalias() = Gamma.transpose() * QGamma;
+  g.noalias() = QGamma.transpose() * X_free;
+
+  // r sum u_k^2 + r_rate sum (u_k - u_k-1)^2, u_-1 being the angle applied last cycle
+  H.diagonal().array() += para.r + 2.0 * para.r_rate;
+  H(N - 1, N - 1) -= para.r_rate;
+  for (int k = 0; k + 1 < N; k++){
+    H(k, k + 1) -= para.r_rate;
+    H(k + 1, k) -= para.r_rate;
+  }
+  g(0) -= para.r_rate * u_applied;
+}
+
+void MpcLateral::solveQP(){
+  // the largest row sum bounds the largest eigenvalue of H, 1 / L is a safe gradient step
+  const double L = H.cwiseAbs().rowwise().sum().maxCoeff();
+  const double lim = para.max_angle;
+
+  Sequence U = u_sequence.cwiseMax(-lim).cwiseMin(lim);
+  Sequence Y = U;
+  Sequence U_next;
+  double t = 1.0;
+  for (iterations = 0; iterations < para.max_iteration;){
+    U_next = (Y - (H * Y + g) / L).cwiseMax(-lim).cwiseMin(lim);
+    iterations++;
+    const double change = (U_next - U).cwiseAbs().maxCoeff();
+    if (change < para.tolerance){
+      U = U_next;
+      break;
+    }
+    // momentum that points uphill is dropped
+    if ((Y - U_next).dot(U_next - U) > 0.0){
+      t = 1.0;
+    }
+    const double t_next = 0.5 * (1.0 + std::sqrt(1.0 + 4.0 * t * t));
+    Y = U_next + ((t - 1.0) / t_next) * (U_next - U);
+    U = U_next;
+    t = t_next;
+  }
+  u_sequence = U;
+}
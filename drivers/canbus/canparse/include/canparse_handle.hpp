@@ -2,6 +2,7 @@
 #define CANPARSE_HANDLE_HPP
 
 #include "canparse.hpp"
+#include <can_msgs/FrameArray.h>
 
 namespace ns_canparse {
 
@@ -24,14 +25,18 @@ class CanparseHandle {
  private:
   ros::NodeHandle nodeHandle_;
   ros::Subscriber canbus_receive_Subscriber_;
+  ros::Subscriber canbus_receive_batch_Subscriber_;
   ros::Publisher chassisStatePublisher_;
 
   void CanbusReceiveCallback(const can_msgs::Frame &f);
+  void CanbusReceiveBatchCallback(const can_msgs::FrameArray &frames);
 
   std::string chassis_state_topic_name_; 
   std::string canbus_receive_topic_name_;
+  std::string canbus_receive_batch_topic_name_;
 
   int node_rate_;
+  double statistics_period_;
 
   Canparse canparse_;
 
@@ -0,0 +1,65 @@
+#ifndef FRAME_DISPATCHER_HPP
+#define FRAME_DISPATCHER_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "protocol.h"
+
+namespace ns_canparse {
+
+/*
+  CAN ID to decoder table.
+
+  Decoders are added once, build() then looks for a multiplicative hash
+  without collisions over the registered IDs, so dispatch() is a multiply,
+  a shift and one compare whatever the number of decoders. Every ID counts
+  its frames; IDs nobody decodes are counted in a small fixed table, the
+  hot path never allocates.
+*/
+class FrameDispatcher {
+
+ public:
+  struct Counters{
+    uint64_t received = 0;   // frames with this ID
+    uint64_t decoded = 0;    // handed to the decoder, error and remote frames are not
+  };
+
+  // Setters
+  void add(protocol *decoder);
+  void build();
+
+  // Getters
+  bool getCounters(uint32_t id, Counters &counters) const;
+  uint64_t getUnknownCount() const;
+  std::string getSummary() const;
+
+  // Methods
+  // false for an ID without decoder
+  bool dispatch(uint32_t id, bool is_error, bool is_rtr, uint8_t *data);
+
+ private:
+  struct Entry{
+    uint32_t id;
+    protocol *decoder;
+    Counters counters;
+  };
+  std::vector<Entry> entries;     // sorted by ID
+  std::vector<int16_t> slots;     // hash -> index into entries, -1 when empty
+  uint32_t multiplier = 0;
+  unsigned shift = 32;
+
+  static const int UNKNOWN_SLOTS = 64;
+  struct Unknown{
+    uint32_t id = 0;
+    uint64_t count = 0;
+  };
+  Unknown unknown[UNKNOWN_SLOTS];
+  uint64_t unknown_total = 0;
+
+  uint32_t slotOf(uint32_t id) const { return (id * multiplier) >> shift; }
+  void countUnknown(uint32_t id);
+};
+}
+
+#endif //FRAME_DISPATCHER_HPP
@@ -11,6 +11,7 @@ CanparseHandle::CanparseHandle(ros::NodeHandle &nodeHandle) :
     canparse_(nodeHandle) {
   ROS_INFO("Constructing Handle");
   loadParameters();
+  canparse_.setStatisticsPeriod(statistics_period_);
   subscribeToTopics();
   publishToTopics();
 }
@@ -26,6 +27,11 @@ void CanparseHandle::loadParameters() {
                                       "/received_messages")) {
     ROS_WARN_STREAM("Did not load canbus_receive_topic_name_. Standard value is: " << canbus_receive_topic_name_);
   }
+  if (!nodeHandle_.param<std::string>("canbus_receive_batch_topic_name",
+                                      canbus_receive_batch_topic_name_,
+                                      "/received_message_batches")) {
+    ROS_WARN_STREAM("Did not load canbus_receive_batch_topic_name_. Standard value is: " << canbus_receive_batch_topic_name_);
+  }
   if (!nodeHandle_.param<std::string>("chassis_state_topic_name",
                                       chassis_state_topic_name_,
                                       "/chassis/vehicle_state")) {
@@ -34,12 +40,18 @@ void CanparseHandle::loadParameters() {
   if (!nodeHandle_.param("node_rate", node_rate_, 1)) {
     ROS_WARN_STREAM("Did not load node_rate. Standard value is: " << node_rate_);
   }
+  if (!nodeHandle_.param("statistics_period", statistics_period_, 10.0)) {
+    ROS_WARN_STREAM("Did not load statistics_period. Standard value is: " << statistics_period_);
+  }
 }
 
 void CanparseHandle::subscribeToTopics() {
   ROS_INFO("subscribe to topics");
   canbus_receive_Subscriber_ =
       nodeHandle_.subscribe(canbus_receive_topic_name_, 100, &CanparseHandle::CanbusReceiveCallback, this);
+  // the bridge publishes either single frames or batches, one spin every 20 ms holds ~20 batches of 1 ms
+  canbus_receive_batch_Subscriber_ =
+      nodeHandle_.subscribe(canbus_receive_batch_topic_name_, 100, &CanparseHandle::CanbusReceiveBatchCallback, this);
 }
 
 void CanparseHandle::publishToTopics() {
@@ -63,4 +75,10 @@ void CanparseHandle::sendMsg() {
 void CanparseHandle::CanbusReceiveCallback(const can_msgs::Frame &f) {
   canparse_.Parse(f);
 }
+
+void CanparseHandle::CanbusReceiveBatchCallback(const can_msgs::FrameArray &frames) {
+  for (const can_msgs::Frame &f : frames.frames) {
+    canparse_.Parse(f);
+  }
+}
 }
@@ -0,0 +1,120 @@
+#include <ros/ros.h>
+#include "frame_dispatcher.hpp"
+#include <algorithm>
+#include <cstdio>
+
+namespace ns_canparse {
+
+// Setters
+void FrameDispatcher::add(protocol *decoder){
+  Entry entry;
+  entry.id = decoder->id();
+  entry.decoder = decoder;
+  for (const Entry &e : entries){
+    if (e.id == entry.id){
+      ROS_ERROR("[Canparse] two decoders for id %X, keeping the first.", entry.id);
+      return;
+    }
+  }
+  entries.push_back(entry);
+}
+
+void FrameDispatcher::build(){
+  std::sort(entries.begin(), entries.end(),
+            [](const Entry &a, const Entry &b){ return a.id < b.id; });
+
+  // smallest table with at least twice the IDs, grown until some odd multiplier separates them all
+  unsigned bits = 1;
+  while ((1u << bits) < 2 * entries.size()){
+    bits++;
+  }
+  uint32_t candidate = 0x9E3779B1u;   // golden ratio first, then a fixed sequence
+  for (; bits <= 16; bits++){
+    shift = 32 - bits;
+    for (int attempt = 0; attempt < 10000; attempt++){
+      multiplier = candidate | 1u;
+      candidate = candidate * 1664525u + 1013904223u;
+      slots.assign(size_t(1) << bits, -1);
+      bool collision = false;
+      for (size_t i = 0; i < entries.size() && !collision; i++){
+        int16_t &slot = slots[slotOf(entries[i].id)];
+        collision = slot >= 0;
+        slot = static_cast<int16_t>(i);
+      }
+      if (!collision){
+        ROS_INFO("[Canparse] %zu decoders in a table of %zu.", entries.size(), slots.size());
+        return;
+      }
+    }
+  }
+  ROS_ERROR("[Canparse] no collision free table for %zu decoders.", entries.size());
+  slots.clear();
+}
+
+// Getters
+bool FrameDispatcher::getCounters(uint32_t id, Counters &counters) const {
+  for (const Entry &e : entries){
+    if (e.id == id){
+      counters = e.counters;
+      return true;
+    }
+  }
+  return false;
+}
+
+uint64_t FrameDispatcher::getUnknownCount() const { return unknown_total; }
+
+std::string FrameDispatcher::getSummary() const {
+  std::string summary;
+  char buffer[64];
+  for (const Entry &e : entries){
+    std::snprintf(buffer, sizeof(buffer), " %X: %llu/%llu", e.id,
+                  static_cast<unsigned long long>(e.counters.decoded),
+                  static_cast<unsigned long long>(e.counters.received));
+    summary += buffer;
+  }
+  std::snprintf(buffer, sizeof(buffer), "; unknown %llu:", static_cast<unsigned long long>(unknown_total));
+  summary += buffer;
+  for (const Unknown &u : unknown){
+    if (u.count > 0){
+      std::snprintf(buffer, sizeof(buffer), " %X: %llu", u.id, static_cast<unsigned long long>(u.count));
+      summary += buffer;
+    }
+  }
+  return summary;
+}
+
+// Methods
+bool FrameDispatcher::dispatch(uint32_t id, bool is_error, bool is_rtr, uint8_t *data){
+  if (!slots.empty()){
+    const int16_t index = slots[slotOf(id)];
+    if (index >= 0 && entries[index].id == id){
+      Entry &entry = entries[index];
+      entry.counters.received++;
+      if (!is_error && !is_rtr){
+        entry.decoder->Update(data);
+        entry.counters.decoded++;
+      }
+      return true;
+    }
+  }
+  countUnknown(id);
+  return false;
+}
+
+void FrameDispatcher::countUnknown(uint32_t id){
+  unknown_total++;
+  // linear probing, IDs past a full table are only in the total
+  uint32_t slot = (id * 0x9E3779B1u) >> 26;
+  for (int i = 0; i < UNKNOWN_SLOTS; i++, slot = (slot + 1) % UNKNOWN_SLOTS){
+    Unknown &u = unknown[slot];
+    if (u.count == 0){
+      u.id = id;
+    }
+    if (u.id == id){
+      u.count++;
+      return;
+    }
+  }
+}
+}
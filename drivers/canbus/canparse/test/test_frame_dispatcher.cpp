@@ -0,0 +1,169 @@
+#include "frame_dispatcher.hpp"
+
+#include <gtest/gtest.h>
+
+#include <set>
+#include <string>
+#include <vector>
+
+namespace ns_canparse {
+
+namespace {
+// counts the frames handed to it
+class CountingDecoder : public protocol {
+ public:
+  explicit CountingDecoder(uint32_t id){
+    id_ = id;
+  }
+  void Update(uint8_t *data) override {
+    updates++;
+    last_byte = data[0];
+  }
+  int updates = 0;
+  uint8_t last_byte = 0;
+};
+
+// IDs of the vehicle DBC, standard and extended
+const uint32_t VEHICLE_IDS[] = {0x59, 0x5A, 0x151, 0x650, 0x18F01D48, 0x18F02501, 0x18F02502, 0x18F02505, 0x18FF4BD1};
+}
+
+TEST(FrameDispatcherTest, knownIds){
+  std::vector<CountingDecoder> decoders(std::begin(VEHICLE_IDS), std::end(VEHICLE_IDS));
+  FrameDispatcher dispatcher;
+  for (CountingDecoder &decoder : decoders){
+    dispatcher.add(&decoder);
+  }
+  dispatcher.build();
+
+  uint8_t data[8] = {0};
+  for (size_t i = 0; i < decoders.size(); i++){
+    data[0] = static_cast<uint8_t>(i + 1);
+    for (size_t n = 0; n <= i; n++){
+      EXPECT_TRUE(dispatcher.dispatch(decoders[i].id(), false, false, data));
+    }
+  }
+  for (size_t i = 0; i < decoders.size(); i++){
+    EXPECT_EQ(static_cast<int>(i + 1), decoders[i].updates);
+    EXPECT_EQ(i + 1, decoders[i].last_byte);
+    FrameDispatcher::Counters counters;
+    ASSERT_TRUE(dispatcher.getCounters(decoders[i].id(), counters));
+    EXPECT_EQ(i + 1, counters.received);
+    EXPECT_EQ(i + 1, counters.decoded);
+  }
+  EXPECT_EQ(0u, dispatcher.getUnknownCount());
+}
+
+TEST(FrameDispatcherTest, errorAndRemoteFrames){
+  CountingDecoder decoder(0x151);
+  FrameDispatcher dispatcher;
+  dispatcher.add(&decoder);
+  dispatcher.build();
+
+  uint8_t data[8] = {0};
+  // counted for the ID, but not decoded
+  EXPECT_TRUE(dispatcher.dispatch(0x151, true, false, data));
+  EXPECT_TRUE(dispatcher.dispatch(0x151, false, true, data));
+  EXPECT_TRUE(dispatcher.dispatch(0x151, false, false, data));
+  EXPECT_EQ(1, decoder.updates);
+  FrameDispatcher::Counters counters;
+  ASSERT_TRUE(dispatcher.getCounters(0x151, counters));
+  EXPECT_EQ(3u, counters.received);
+  EXPECT_EQ(1u, counters.decoded);
+}
+
+TEST(FrameDispatcherTest, duplicateDecoder){
+  CountingDecoder first(0x650);
+  CountingDecoder second(0x650);
+  FrameDispatcher dispatcher;
+  dispatcher.add(&first);
+  dispatcher.add(&second);
+  dispatcher.build();
+
+  uint8_t data[8] = {0};
+  EXPECT_TRUE(dispatcher.dispatch(0x650, false, false, data));
+  EXPECT_EQ(1, first.updates);
+  EXPECT_EQ(0, second.updates);
+}
+
+TEST(FrameDispatcherTest, unknownIds){
+  std::vector<CountingDecoder> decoders(std::begin(VEHICLE_IDS), std::end(VEHICLE_IDS));
+  FrameDispatcher dispatcher;
+  for (CountingDecoder &decoder : decoders){
+    dispatcher.add(&decoder);
+  }
+  dispatcher.build();
+
+  uint8_t data[8] = {0};
+  // IDs close to known ones, which may share their hash slot
+  for (uint32_t id : VEHICLE_IDS){
+    EXPECT_FALSE(dispatcher.dispatch(id + 0x100, false, false, data));
+    EXPECT_FALSE(dispatcher.dispatch(id ^ 0x80000000u, false, false, data));
+  }
+  EXPECT_FALSE(dispatcher.dispatch(0x123, false, false, data));
+  EXPECT_FALSE(dispatcher.dispatch(0x123, false, false, data));
+  EXPECT_EQ(2 * decoders.size() + 2, dispatcher.getUnknownCount());
+  for (const CountingDecoder &decoder : decoders){
+    EXPECT_EQ(0, decoder.updates);
+  }
+  FrameDispatcher::Counters counters;
+  EXPECT_FALSE(dispatcher.getCounters(0x123, counters));
+  EXPECT_NE(std::string::npos, dispatcher.getSummary().find(" 123: 2"));
+}
+
+TEST(FrameDispatcherTest, unknownIdOverflow){
+  FrameDispatcher dispatcher;
+  dispatcher.build();
+
+  // 64 IDs fill the table, the ones after are only in the total
+  uint8_t data[8] = {0};
+  const int num_ids = 100;
+  for (int i = 0; i < num_ids; i++){
+    EXPECT_FALSE(dispatcher.dispatch(0x700 + i, false, false, data));
+  }
+  EXPECT_EQ(static_cast<uint64_t>(num_ids), dispatcher.getUnknownCount());
+  // IDs already in the table still count there
+  EXPECT_FALSE(dispatcher.dispatch(0x700, false, false, data));
+  EXPECT_EQ(static_cast<uint64_t>(num_ids + 1), dispatcher.getUnknownCount());
+
+  // the summary lists the 64 IDs of the table after the total
+  const std::string summary = dispatcher.getSummary();
+  const std::string total = "unknown 101:";
+  const size_t list_begin = summary.find(total);
+  ASSERT_NE(std::string::npos, list_begin);
+  EXPECT_NE(std::string::npos, summary.find(" 700: 2"));
+  size_t listed = 0;
+  for (size_t pos = summary.find(": ", list_begin + total.size()); pos != std::string::npos;
+       pos = summary.find(": ", pos + 1)){
+    listed++;
+  }
+  EXPECT_EQ(64u, listed);
+}
+
+TEST(FrameDispatcherTest, manyDecoders){
+  // extended IDs that only differ in few bits, the table has to separate them all
+  std::vector<CountingDecoder> decoders;
+  for (uint32_t i = 0; i < 300; i++){
+    decoders.emplace_back(0x18F00000u + (i << 4));
+  }
+  FrameDispatcher dispatcher;
+  for (CountingDecoder &decoder : decoders){
+    dispatcher.add(&decoder);
+  }
+  dispatcher.build();
+
+  uint8_t data[8] = {0};
+  for (CountingDecoder &decoder : decoders){
+    EXPECT_TRUE(dispatcher.dispatch(decoder.id(), false, false, data));
+    EXPECT_FALSE(dispatcher.dispatch(decoder.id() + 1, false, false, data));
+  }
+  for (const CountingDecoder &decoder : decoders){
+    EXPECT_EQ(1, decoder.updates);
+  }
+  EXPECT_EQ(decoders.size(), dispatcher.getUnknownCount());
+}
+}
+
+int main(int argc, char **argv){
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
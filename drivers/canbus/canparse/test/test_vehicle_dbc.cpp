@@ -0,0 +1,272 @@
+#include "vehicle_dbc.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+namespace vehicle_dbc {
+
+namespace {
+// well below the smallest DBC factor, so a value one raw step off fails
+const double EPS = 1e-6;
+
+template <class Spec>
+void pack(uint8_t *data, double value){
+  can_codec::encode<Spec>(data, value);
+}
+
+void expectFrame(const uint8_t *expected, const uint8_t *actual, int dlc){
+  for (int i = 0; i < dlc; i++){
+    EXPECT_EQ(expected[i], actual[i]) << "byte " << i;
+  }
+}
+}
+
+// Each test holds a frame worked out by hand from vehicle.dbc. The generated
+// class decodes it to the listed values, and encoding the values into zeroed
+// data gives the frame back.
+
+TEST(VehicleDbcTest, steer0x18F01D48){
+  // angle -1234 signed, wheel speed 25, state byte 0b10101110, std info 200
+  uint8_t frame[8] = {0x2E, 0xFB, 0x19, 0xAE, 0x00, 0xC8, 0x00, 0x00};
+  ID_0x18F01D48 msg;
+  EXPECT_EQ(0x18F01D48u, msg.id());
+  EXPECT_EQ(6, msg.dlc());
+  msg.Update(frame);
+  EXPECT_NEAR(-123.4, msg.flwSteeringWheelAngel(), EPS);
+  EXPECT_NEAR(100.0, msg.flwWheelSpd(), EPS);
+  EXPECT_EQ(1.0, msg.stateinfo1());
+  EXPECT_EQ(3.0, msg.stateinfo23());
+  EXPECT_EQ(0.0, msg.stateinfo4());
+  EXPECT_EQ(1.0, msg.stateinfo5());
+  EXPECT_EQ(0.0, msg.stateinfo6());
+  EXPECT_EQ(1.0, msg.stateinfo7());
+  EXPECT_EQ(200.0, msg.flwstdinfo());
+
+  uint8_t data[8] = {0};
+  pack<spec::ID_0x18F01D48::flwSteeringWheelAngel>(data, -123.4);
+  pack<spec::ID_0x18F01D48::flwWheelSpd>(data, 100.0);
+  pack<spec::ID_0x18F01D48::stateinfo1>(data, 1.0);
+  pack<spec::ID_0x18F01D48::stateinfo23>(data, 3.0);
+  pack<spec::ID_0x18F01D48::stateinfo4>(data, 0.0);
+  pack<spec::ID_0x18F01D48::stateinfo5>(data, 1.0);
+  pack<spec::ID_0x18F01D48::stateinfo6>(data, 0.0);
+  pack<spec::ID_0x18F01D48::stateinfo7>(data, 1.0);
+  pack<spec::ID_0x18F01D48::flwstdinfo>(data, 200.0);
+  expectFrame(frame, data, 8);
+}
+
+TEST(VehicleDbcTest, vcu0x18F02501){
+  // acceleration raw 123 with offset -15
+  uint8_t frame[8] = {0x2A, 0x7B, 0x00, 0x2B, 0x02, 0x25, 0x00, 0x00};
+  ID_0x18F02501 msg;
+  EXPECT_EQ(8, msg.dlc());
+  msg.Update(frame);
+  EXPECT_EQ(42.0, msg.flwPedBrk());
+  EXPECT_NEAR(-2.7, msg.flwAcc(), EPS);
+  EXPECT_NEAR(55.5, msg.flwSpd(), EPS);
+  EXPECT_NEAR(0.37, msg.flwBrkPress(), EPS);
+
+  uint8_t data[8] = {0};
+  pack<spec::ID_0x18F02501::flwPedBrk>(data, 42.0);
+  pack<spec::ID_0x18F02501::flwAcc>(data, -2.7);
+  pack<spec::ID_0x18F02501::flwSpd>(data, 55.5);
+  pack<spec::ID_0x18F02501::flwBrkPress>(data, 0.37);
+  expectFrame(frame, data, 8);
+}
+
+TEST(VehicleDbcTest, vcu0x18F02502){
+  uint8_t frame[8] = {0x63, 0x00, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00};
+  ID_0x18F02502 msg;
+  EXPECT_EQ(4, msg.dlc());
+  msg.Update(frame);
+  EXPECT_EQ(99.0, msg.flwPedBrk());
+  EXPECT_EQ(7.0, msg.flwPdlAcc());
+
+  uint8_t data[8] = {0};
+  pack<spec::ID_0x18F02502::flwPedBrk>(data, 99.0);
+  pack<spec::ID_0x18F02502::flwPdlAcc>(data, 7.0);
+  expectFrame(frame, data, 8);
+}
+
+TEST(VehicleDbcTest, vcu0x18F02505){
+  uint8_t frame[8] = {0xDC, 0x05, 0x19, 0x00, 0xFA, 0x00, 0x03, 0x00};
+  ID_0x18F02505 msg;
+  msg.Update(frame);
+  EXPECT_NEAR(150.0, msg.flwPedBrkobj(), EPS);
+  EXPECT_NEAR(2.5, msg.flwPdlAccobj(), EPS);
+  EXPECT_EQ(5000.0, msg.flwPedBrkfreq());
+  EXPECT_EQ(60.0, msg.flwPdlAccfreq());
+
+  uint8_t data[8] = {0};
+  pack<spec::ID_0x18F02505::flwPedBrkobj>(data, 150.0);
+  pack<spec::ID_0x18F02505::flwPdlAccobj>(data, 2.5);
+  pack<spec::ID_0x18F02505::flwPedBrkfreq>(data, 5000.0);
+  pack<spec::ID_0x18F02505::flwPdlAccfreq>(data, 60.0);
+  expectFrame(frame, data, 8);
+}
+
+TEST(VehicleDbcTest, steer0x18FF4BD1){
+  // angle raw 28262 with offset -3276.7, error class in the low 2 bits of byte 5
+  uint8_t frame[8] = {0x66, 0x6E, 0x00, 0x00, 0x00, 0x02, 0x81, 0x00};
+  ID_0x18FF4BD1 msg;
+  msg.Update(frame);
+  EXPECT_NEAR(-450.5, msg.flwStrAgl(), EPS);
+  EXPECT_EQ(2.0, msg.flwStrErrCls());
+  EXPECT_EQ(129.0, msg.flwStrErrCod());
+
+  uint8_t data[8] = {0};
+  pack<spec::ID_0x18FF4BD1::flwStrAgl>(data, -450.5);
+  pack<spec::ID_0x18FF4BD1::flwStrErrCls>(data, 2.0);
+  pack<spec::ID_0x18FF4BD1::flwStrErrCod>(data, 129.0);
+  expectFrame(frame, data, 8);
+}
+
+TEST(VehicleDbcTest, imuMotorola0x59){
+  // big endian, start bit 15 puts the most significant byte in byte 1
+  uint8_t frame[8] = {0x00, 0xFC, 0x18, 0x40, 0x00, 0x80, 0x00, 0x00};
+  ID_0x00000059 msg;
+  EXPECT_EQ(0x59u, msg.id());
+  msg.Update(frame);
+  EXPECT_NEAR(-1000 * 0.000598, msg.flwLonAcc(), EPS);
+  EXPECT_NEAR(16384 * 0.000598, msg.flwTranAcc(), EPS);
+  EXPECT_NEAR(-32768 * 0.000598, msg.flwVerAcc(), EPS);
+
+  uint8_t data[8] = {0};
+  pack<spec::ID_0x00000059::flwLonAcc>(data, -0.598);
+  pack<spec::ID_0x00000059::flwTranAcc>(data, 9.797632);
+  pack<spec::ID_0x00000059::flwVerAcc>(data, -19.595264);
+  expectFrame(frame, data, 8);
+}
+
+TEST(VehicleDbcTest, imuMotorola0x5A){
+  uint8_t frame[8] = {0x00, 0x00, 0x83, 0xFE, 0xFA, 0x00, 0x00, 0x00};
+  ID_0x0000005A msg;
+  msg.Update(frame);
+  EXPECT_NEAR(131 * 0.0076335878, msg.flwPitchRt(), EPS);
+  EXPECT_NEAR(-262 * 0.0076335878, msg.flwYawRt(), EPS);
+
+  uint8_t data[8] = {0};
+  pack<spec::ID_0x0000005A::flwPitchRt>(data, 1.0);
+  pack<spec::ID_0x0000005A::flwYawRt>(data, -2.0);
+  expectFrame(frame, data, 8);
+}
+
+TEST(VehicleDbcTest, vcu0x151){
+  uint8_t frame[8] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x5A};
+  ID_0x00000151 msg;
+  msg.Update(frame);
+  EXPECT_EQ(90.0, msg.FootControlSysInfo());
+
+  uint8_t data[8] = {0};
+  pack<spec::ID_0x00000151::FootControlSysInfo>(data, 90.0);
+  expectFrame(frame, data, 8);
+}
+
+TEST(VehicleDbcTest, uwb0x650){
+  uint8_t frame[8] = {0x03, 0x00, 0x39, 0x30, 0xFE, 0xFF, 0x2C, 0x01};
+  ID_0x00000650 msg;
+  msg.Update(frame);
+  EXPECT_EQ(3.0, msg.uwbSta());
+  EXPECT_NEAR(123.45, msg.uwbDis(), EPS);
+  EXPECT_EQ(-2.0, msg.uwbFW());
+  EXPECT_EQ(300.0, msg.uwbZT());
+
+  uint8_t data[8] = {0};
+  pack<spec::ID_0x00000650::uwbSta>(data, 3.0);
+  pack<spec::ID_0x00000650::uwbDis>(data, 123.45);
+  pack<spec::ID_0x00000650::uwbFW>(data, -2.0);
+  pack<spec::ID_0x00000650::uwbZT>(data, 300.0);
+  expectFrame(frame, data, 8);
+}
+
+TEST(VehicleDbcTest, ctrl0x04EF8480){
+  const uint8_t frame[4] = {0x01, 0x32, 0x2D, 0x7B};
+  ID_0x04EF8480 msg;
+  EXPECT_EQ(0x4EF8480u, msg.id());
+  EXPECT_EQ(4, msg.dlc());
+  msg.SetcomControlCmd(1.0);
+  msg.SetconRtCmd(200.0);
+  msg.SetconDegCmd(-123.4);
+  EXPECT_EQ(1.0, msg.comControlCmd());
+  EXPECT_EQ(200.0, msg.conRtCmd());
+  EXPECT_NEAR(-123.4, msg.conDegCmd(), EPS);
+
+  // only dlc bytes are copied out
+  uint8_t data[8];
+  std::memset(data, 0xEE, sizeof(data));
+  msg.Update(data);
+  expectFrame(frame, data, 4);
+  EXPECT_EQ(0xEE, data[4]);
+}
+
+TEST(VehicleDbcTest, ctrl0x0C040B2A){
+  // control scheme in the high nibble of byte 2
+  const uint8_t frame[8] = {0xA5, 0x00, 0x10, 0x00, 0x1E, 0x0C, 0x00, 0x07};
+  ID_0x0C040B2A msg;
+  msg.SetconAccReq(1.5);
+  msg.SetcontrolScheme(1.0);
+  msg.SetaccPedOpenReq(30.0);
+  msg.SetbrkPedOpenReq(12.0);
+  msg.SetconSta(7.0);
+  EXPECT_NEAR(1.5, msg.conAccReq(), EPS);
+  EXPECT_EQ(1.0, msg.controlScheme());
+  EXPECT_EQ(30.0, msg.accPedOpenReq());
+  EXPECT_EQ(12.0, msg.brkPedOpenReq());
+  EXPECT_EQ(7.0, msg.conSta());
+
+  uint8_t data[8] = {0};
+  msg.Update(data);
+  expectFrame(frame, data, 8);
+
+  // setting a signal again leaves the others alone
+  msg.SetconAccReq(-1.5);
+  msg.Update(data);
+  EXPECT_EQ(0x87, data[0]);
+  EXPECT_EQ(0x00, data[1]);
+  EXPECT_EQ(0x10, data[2]);
+  EXPECT_EQ(0x1E, data[4]);
+}
+
+TEST(VehicleDbcTest, encodeClampsAndRounds){
+  uint8_t data[8] = {0};
+  // below the range of a signal with offset, clamped to raw 0
+  std::memset(data, 0xFF, sizeof(data));
+  pack<spec::ID_0x0C040B2A::conAccReq>(data, -20.0);
+  EXPECT_EQ(0x00, data[0]);
+  EXPECT_EQ(0x00, data[1]);
+  EXPECT_EQ(0xFF, data[2]);
+  // above it, clamped to 15 m/s^2, raw 300
+  pack<spec::ID_0x0C040B2A::conAccReq>(data, 99.0);
+  EXPECT_EQ(0x2C, data[0]);
+  EXPECT_EQ(0x01, data[1]);
+  // 4 bit field limited to 1 by the DBC
+  pack<spec::ID_0x0C040B2A::controlScheme>(data, 2.0);
+  EXPECT_EQ(0x1F, data[2]);
+
+  // rounded to the nearest raw value, away from zero for signed signals
+  std::memset(data, 0, sizeof(data));
+  pack<spec::ID_0x18F01D48::flwSteeringWheelAngel>(data, 12.34);
+  EXPECT_EQ(0x7B, data[0]);
+  pack<spec::ID_0x18F01D48::flwSteeringWheelAngel>(data, -12.36);
+  EXPECT_EQ(0x84, data[0]);
+  EXPECT_EQ(0xFF, data[1]);
+
+  // signed big endian at the ends of the range
+  std::memset(data, 0, sizeof(data));
+  pack<spec::ID_0x00000059::flwLonAcc>(data, -100.0);
+  EXPECT_EQ(0x80, data[1]);
+  EXPECT_EQ(0x00, data[2]);
+  pack<spec::ID_0x00000059::flwLonAcc>(data, 100.0);
+  EXPECT_EQ(0x7F, data[1]);
+  EXPECT_EQ(0xFF, data[2]);
+  EXPECT_EQ(0x00, data[0]);
+  EXPECT_EQ(0x00, data[3]);
+}
+
+}
+
+int main(int argc, char **argv){
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
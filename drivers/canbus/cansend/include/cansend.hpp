@@ -23,11 +23,10 @@
 #include "std_msgs/String.h"
 #include "can_msgs/Frame.h"
 #include "common_msgs/ChassisControl.h"
-#include "ID_0x04EF8480.h"
-#include "ID_0x0C040B2A.h"
+#include "vehicle_dbc.h"   // generated from dbc/vehicle.dbc
 
-extern ID_0x04EF8480 *id_0x04EF8480;
-extern ID_0x0C040B2A *id_0x0C040B2A;
+extern vehicle_dbc::ID_0x04EF8480 *id_0x04EF8480;
+extern vehicle_dbc::ID_0x0C040B2A *id_0x0C040B2A;
 namespace ns_cansend {
 
 struct Para{
@@ -1,19 +1,20 @@
 #include <ros/ros.h>
 #include "cansend.hpp"
 #include <sstream>
-ID_0x04EF8480 *id_0x04EF8480;
-ID_0x0C040B2A *id_0x0C040B2A;
+vehicle_dbc::ID_0x04EF8480 *id_0x04EF8480;
+vehicle_dbc::ID_0x0C040B2A *id_0x0C040B2A;
 
 namespace ns_cansend {
 // Constructor
 Cansend::Cansend(ros::NodeHandle &nh) : nh_(nh) {
-  id_0x04EF8480=new ID_0x04EF8480();
+  id_0x04EF8480=new vehicle_dbc::ID_0x04EF8480();
   id_0x04EF8480->SetconDegCmd(0.0);
   id_0x04EF8480->SetcomControlCmd(0.0);
   id_0x04EF8480->SetconRtCmd(0.0);
 
-  id_0x0C040B2A=new ID_0x0C040B2A();
-  id_0x0C040B2A->SetconAccReq(0.0);
+  id_0x0C040B2A=new vehicle_dbc::ID_0x0C040B2A();
+  // raw 0 as always sent, the pedal control schemes do not use the acceleration request
+  id_0x0C040B2A->SetconAccReq(-15.0);
   id_0x0C040B2A->SetconSta(0.0);
   id_0x0C040B2A->SetcontrolScheme(0.0);
 
@@ -51,7 +52,7 @@ void Cansend::runAlgorithm() {
     id_0x04EF8480->SetcomControlCmd(1);
     id_0x04EF8480->SetconRtCmd(para.setup_steer_speed);
 
-    id_0x0C040B2A->SetconAccReq(0);
+    id_0x0C040B2A->SetconAccReq(-15.0);
     id_0x0C040B2A->SetconSta(loop_number);
     int control_mode = 0;
     int target_acc_pedal = 0;
@@ -66,15 +67,15 @@ void Cansend::runAlgorithm() {
       }
     }
     id_0x0C040B2A->SetcontrolScheme(control_mode);
-    id_0x0C040B2A->SetAccPedOpenReq(target_acc_pedal);
-    id_0x0C040B2A->SetBrkPedOpenReq(target_brk_pedal);
+    id_0x0C040B2A->SetaccPedOpenReq(target_acc_pedal);
+    id_0x0C040B2A->SetbrkPedOpenReq(target_brk_pedal);
   }else{
     //autonomous driving mode
     id_0x04EF8480->SetconDegCmd(chassis_control_cmd.steer_angle);
     id_0x04EF8480->SetcomControlCmd(1);
     id_0x04EF8480->SetconRtCmd(para.setup_steer_speed);
 
-    id_0x0C040B2A->SetconAccReq(0);
+    id_0x0C040B2A->SetconAccReq(-15.0);
     id_0x0C040B2A->SetconSta(loop_number);
     int control_mode = 0;
     int target_acc_pedal = 0;
@@ -89,8 +90,8 @@ void Cansend::runAlgorithm() {
       }
     }
     id_0x0C040B2A->SetcontrolScheme(control_mode);
-    id_0x0C040B2A->SetAccPedOpenReq(target_acc_pedal);
-    id_0x0C040B2A->SetBrkPedOpenReq(target_brk_pedal);
+    id_0x0C040B2A->SetaccPedOpenReq(target_acc_pedal);
+    id_0x0C040B2A->SetbrkPedOpenReq(target_brk_pedal);
   }
 
   if (loop_number >= 16){
@@ -0,0 +1,249 @@
+#!/usr/bin/env python3
+"""
+Generates the ID_0x* protocol classes of a DBC file as one header.
+
+Every signal becomes a spec with a compile time Layout (can_codec.h), so a
+getter is a load, shift and mask with folded constants. Messages the node
+receives keep the payload and decode a signal when it is read (or every
+signal in Update() with --eager), messages the node transmits encode a
+signal when it is set.
+
+    python3 dbc_codegen.py vehicle.dbc vehicle_dbc.h --node CTRL [--namespace vehicle_dbc] [--eager]
+"""
+
+import argparse
+import os
+import re
+import sys
+
+BO_RE = re.compile(r'^BO_\s+(\d+)\s+(\w+)\s*:\s*(\d+)\s+(\w+)')
+SG_RE = re.compile(r'^SG_\s+(\w+)\s*(M|m\d+)?\s*:\s*(\d+)\|(\d+)@([01])([+-])\s*'
+                   r'\(([^,]+),([^)]+)\)\s*\[([^|]+)\|([^\]]+)\]\s*"([^"]*)"\s*(.*)$')
+CM_SG_RE = re.compile(r'^CM_\s+SG_\s+(\d+)\s+(\w+)\s+"([^"]*)"\s*;')
+CM_BO_RE = re.compile(r'^CM_\s+BO_\s+(\d+)\s+"([^"]*)"\s*;')
+
+EXTENDED_FLAG = 0x80000000
+
+
+class Signal(object):
+    def __init__(self, m):
+        self.name = m.group(1)
+        if m.group(2):
+            raise ValueError('multiplexed signal %s is not supported' % self.name)
+        self.start_bit = int(m.group(3))
+        self.length = int(m.group(4))
+        self.motorola = m.group(5) == '0'
+        self.signed = m.group(6) == '-'
+        self.factor = m.group(7).strip()
+        self.offset = m.group(8).strip()
+        self.minimum = m.group(9).strip()
+        self.maximum = m.group(10).strip()
+        self.unit = m.group(11)
+        self.comment = ''
+
+    def fits(self):
+        if self.motorola:
+            msb = (7 - self.start_bit // 8) * 8 + self.start_bit % 8
+            return msb - (self.length - 1) >= 0 and msb < 64
+        return self.start_bit + self.length <= 64
+
+
+class Message(object):
+    def __init__(self, m):
+        frame_id = int(m.group(1))
+        self.extended = bool(frame_id & EXTENDED_FLAG)
+        self.id = frame_id & ~EXTENDED_FLAG
+        self.name = m.group(2)
+        self.dlc = int(m.group(3))
+        self.transmitter = m.group(4)
+        self.signals = []
+        self.comment = ''
+
+
+def parse(path):
+    messages = []
+    by_id = {}
+    message = None
+    with open(path) as f:
+        for number, line in enumerate(f, 1):
+            line = line.strip()
+            m = BO_RE.match(line)
+            if m:
+                message = Message(m)
+                messages.append(message)
+                by_id[int(m.group(1))] = message
+                continue
+            if line.startswith('SG_'):
+                m = SG_RE.match(line)
+                if not m or message is None:
+                    raise ValueError('%s:%d: cannot read signal' % (path, number))
+                signal = Signal(m)
+                if not signal.fits():
+                    raise ValueError('%s:%d: %s does not fit in 8 bytes' % (path, number, signal.name))
+                message.signals.append(signal)
+                continue
+            if not line:
+                message = None
+            m = CM_SG_RE.match(line)
+            if m and int(m.group(1)) in by_id:
+                for signal in by_id[int(m.group(1))].signals:
+                    if signal.name == m.group(2):
+                        signal.comment = m.group(3)
+                continue
+            m = CM_BO_RE.match(line)
+            if m and int(m.group(1)) in by_id:
+                by_id[int(m.group(1))].comment = m.group(2)
+    return messages
+
+
+def literal(number):
+    # DBC numbers are written as they are, only made double
+    if re.search(r'[.eE]', number):
+        return number
+    return number + '.0'
+
+
+def layout(signal):
+    return 'can_codec::Layout<%d, %d, %s, %s>' % (
+        signal.start_bit, signal.length,
+        'true' if signal.motorola else 'false',
+        'true' if signal.signed else 'false')
+
+
+def emit_specs(out, message):
+    out.append('namespace %s {' % message.name)
+    for s in message.signals:
+        out.append('struct %s{' % s.name)
+        out.append('  typedef %s layout;' % layout(s))
+        out.append('  static constexpr double factor = %s;' % literal(s.factor))
+        out.append('  static constexpr double offset = %s;' % literal(s.offset))
+        out.append('  static constexpr double minimum = %s;' % literal(s.minimum))
+        out.append('  static constexpr double maximum = %s;' % literal(s.maximum))
+        out.append('};')
+    out.append('}')
+
+
+def emit_class(out, message, transmit, eager):
+    spec = 'spec::%s::' % message.name
+    direction = '%s, %d bytes, %s' % (message.transmitter, message.dlc,
+                                      'encoded when set' if transmit else
+                                      ('decoded in Update()' if eager else 'decoded when read'))
+    out.append('// %s' % direction)
+    if message.comment:
+        out.append('// %s' % message.comment)
+    out.append('class %s:public protocol{' % message.name)
+    out.append('  public:')
+    out.append('    %s(){' % message.name)
+    out.append('      id_ = 0x%X;' % message.id)
+    out.append('      dlc_ = %d;' % message.dlc)
+    out.append('      is_extended_ = %d;' % (1 if message.extended else 0))
+    out.append('      is_error_ = 0;')
+    out.append('      is_rtr_ = 0;')
+    out.append('      Reset();')
+    out.append('    }')
+    out.append('    virtual ~%s()=default;' % message.name)
+
+    members = eager and not transmit
+    out.append('    void Reset() override{')
+    out.append('      std::memset(data_, 0, sizeof(data_));')
+    if members:
+        for s in message.signals:
+            out.append('      %s_ = 0;' % s.name)
+    out.append('    }')
+
+    if transmit:
+        out.append('    // copies the encoded payload to data')
+        out.append('    void Update(uint8_t *data) override{')
+        out.append('      std::memcpy(data, data_, dlc_);')
+        out.append('    }')
+    else:
+        out.append('    // data holds the 8 bytes of a received frame')
+        out.append('    void Update(uint8_t *data) override{')
+        out.append('      std::memcpy(data_, data, sizeof(data_));')
+        if members:
+            for s in message.signals:
+                out.append('      %s_ = can_codec::decode<%s%s>(data_);' % (s.name, spec, s.name))
+        out.append('    }')
+
+    for s in message.signals:
+        unit = ' [%s]' % s.unit if s.unit else ''
+        comment = ' %s' % s.comment if s.comment else ''
+        if unit or comment:
+            out.append('    //%s%s' % (unit, comment))
+        if members:
+            out.append('    double %s() const{ return %s_; }' % (s.name, s.name))
+        else:
+            out.append('    double %s() const{ return can_codec::decode<%s%s>(data_); }' % (s.name, spec, s.name))
+        if transmit:
+            out.append('    void Set%s(double %s){ can_codec::encode<%s%s>(data_, %s); }'
+                       % (s.name, s.name, spec, s.name, s.name))
+
+    if members:
+        out.append('  private:')
+        for s in message.signals:
+            out.append('    double %s_;' % s.name)
+    out.append('};')
+
+
+def generate(messages, dbc, node, namespace, eager):
+    guard = namespace.upper() + '_H'
+    out = []
+    out.append('// Generated by dbc_codegen.py from %s, do not edit.' % os.path.basename(dbc))
+    out.append('#ifndef %s' % guard)
+    out.append('#define %s' % guard)
+    out.append('')
+    out.append('#include <cstring>')
+    out.append('#include "protocol.h"')
+    out.append('#include "can_codec.h"')
+    out.append('')
+    out.append('namespace %s {' % namespace)
+    out.append('')
+    out.append('namespace spec {')
+    for message in messages:
+        emit_specs(out, message)
+    out.append('}')
+    for message in messages:
+        out.append('')
+        emit_class(out, message, message.transmitter == node, eager)
+    out.append('')
+    out.append('template <uint32_t Id> struct MessageById;')
+    for message in messages:
+        out.append('template <> struct MessageById<0x%X>{ typedef %s type; };' % (message.id, message.name))
+    out.append('')
+    out.append('}')
+    out.append('')
+    out.append('#endif //%s' % guard)
+    return '\n'.join(out) + '\n'
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Generate CAN protocol classes from a DBC file.')
+    parser.add_argument('dbc')
+    parser.add_argument('output')
+    parser.add_argument('--node', required=True, help='this node, its messages are encoded, all others decoded')
+    parser.add_argument('--namespace', default='vehicle_dbc')
+    parser.add_argument('--eager', action='store_true', help='decode every signal in Update() instead of when read')
+    args = parser.parse_args()
+
+    try:
+        messages = parse(args.dbc)
+    except ValueError as e:
+        sys.stderr.write('dbc_codegen: %s\n' % e)
+        return 1
+    text = generate(messages, args.dbc, args.node, args.namespace, args.eager)
+
+    # unchanged output keeps its timestamp, nothing depending on it is rebuilt
+    if os.path.exists(args.output):
+        with open(args.output) as f:
+            if f.read() == text:
+                return 0
+    directory = os.path.dirname(args.output)
+    if directory and not os.path.isdir(directory):
+        os.makedirs(directory)
+    with open(args.output, 'w') as f:
+        f.write(text)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
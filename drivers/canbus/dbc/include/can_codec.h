@@ -0,0 +1,75 @@
+#ifndef CAN_CODEC_H
+#define CAN_CODEC_H
+
+/*
+  Signal access for the classes dbc_codegen.py generates.
+
+  A signal is a Layout, fixed by its DBC start bit, length, byte order and
+  sign, plus factor, offset and range. The 8 data bytes are loaded as one
+  64 bit word (byte swapped for Motorola signals), so reading a signal is a
+  load, a shift and a mask with constants the compiler folds in.
+*/
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "can_codec.h assumes a little endian host"
+#endif
+
+namespace can_codec {
+
+// bit of the word the least significant bit of a Motorola signal lands on,
+// the word being the frame read big endian (byte 0 in the high bits)
+constexpr int motorolaShift(unsigned start_bit, unsigned length){
+  return static_cast<int>((7 - start_bit / 8) * 8 + start_bit % 8) - static_cast<int>(length - 1);
+}
+
+template <unsigned StartBit, unsigned Length, bool Motorola, bool Signed>
+struct Layout{
+  static constexpr int shift = Motorola ? motorolaShift(StartBit, Length) : static_cast<int>(StartBit);
+  static constexpr uint64_t mask = (Length >= 64) ? ~uint64_t(0) : (uint64_t(1) << Length) - 1;
+  static constexpr uint64_t sign = uint64_t(1) << (Length - 1);
+
+  static_assert(Length >= 1 && Length <= 64, "signal length out of range");
+  static_assert(shift >= 0 && shift + Length <= 64, "signal does not fit in 8 data bytes");
+
+  static uint64_t load(const uint8_t *data){
+    uint64_t word;
+    std::memcpy(&word, data, sizeof(word));
+    return Motorola ? __builtin_bswap64(word) : word;
+  }
+  static void store(uint8_t *data, uint64_t word){
+    word = Motorola ? __builtin_bswap64(word) : word;
+    std::memcpy(data, &word, sizeof(word));
+  }
+
+  static int64_t get(const uint8_t *data){
+    const uint64_t raw = (load(data) >> shift) & mask;
+    // sign extension without shifting into the sign bit
+    return Signed ? static_cast<int64_t>((raw ^ sign) - sign) : static_cast<int64_t>(raw);
+  }
+  static void put(uint8_t *data, int64_t value){
+    const uint64_t word = load(data);
+    store(data, (word & ~(mask << shift)) | ((static_cast<uint64_t>(value) & mask) << shift));
+  }
+};
+
+// Spec: layout, factor, offset, minimum, maximum as generated
+template <class Spec>
+inline double decode(const uint8_t *data){
+  return Spec::layout::get(data) * Spec::factor + Spec::offset;
+}
+
+// clamped to the DBC range and rounded to the nearest raw value
+template <class Spec>
+inline void encode(uint8_t *data, double value){
+  if (value < Spec::minimum) value = Spec::minimum;
+  if (value > Spec::maximum) value = Spec::maximum;
+  const double raw = (value - Spec::offset) / Spec::factor;
+  Spec::layout::put(data, static_cast<int64_t>(raw < 0 ? raw - 0.5 : raw + 0.5));
+}
+
+}
+
+#endif //CAN_CODEC_H
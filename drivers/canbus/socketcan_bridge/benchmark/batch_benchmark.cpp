@@ -0,0 +1,135 @@
+/*
+ * Frames lost and CPU used on both sides of the bridge, with the bridge
+ * publishing one message per frame or batches (batch_window, batch_size).
+ * The subscriber here spins like canparse: 50 Hz, queues of 100. Frames
+ * carry a counter in their first four bytes, a jump in it is a lost frame.
+ *
+ *   ./test/initialize_vcan.sh
+ *   rosrun socketcan_bridge socketcan_to_topic_node _can_device:=vcan0 [_batch_window:=0.001 _batch_size:=32]
+ *   rosrun socketcan_bridge batch_benchmark _bridge_pid:=$(pidof socketcan_to_topic_node) [_duration:=10]
+ *   cangen vcan0 -g 0.4 -I 18F02501 -e -L 8 -D i     # 2500 frames/s
+ * benchmark/compare_batching.sh runs both configurations in a row.
+ */
+
+#include <ros/ros.h>
+#include <can_msgs/Frame.h>
+#include <can_msgs/FrameArray.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace
+{
+class FrameCounter
+{
+  public:
+    uint64_t frames = 0;
+    uint64_t messages = 0;
+    uint64_t lost = 0;
+
+    void frameCallback(const can_msgs::Frame& f)
+    {
+      messages++;
+      count(f);
+    }
+
+    void batchCallback(const can_msgs::FrameArray& b)
+    {
+      messages++;
+      for (const can_msgs::Frame& f : b.frames)
+      {
+        count(f);
+      }
+    }
+
+  private:
+    uint32_t last_ = 0;
+
+    void count(const can_msgs::Frame& f)
+    {
+      const uint32_t counter = f.data[0] | f.data[1] << 8 | f.data[2] << 16 | static_cast<uint32_t>(f.data[3]) << 24;
+      if (frames > 0 && counter > last_ + 1)
+      {
+        lost += counter - last_ - 1;
+      }
+      frames++;
+      last_ = counter;
+    }
+};
+
+// user and system time of this process [s]
+double ownCpuTime()
+{
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec * 1e-6 + usage.ru_stime.tv_sec + usage.ru_stime.tv_usec * 1e-6;
+}
+
+// user and system time of another process [s], 0 if it cannot be read
+double processCpuTime(int pid)
+{
+  std::ifstream stat("/proc/" + std::to_string(pid) + "/stat");
+  std::string line;
+  if (pid <= 0 || !std::getline(stat, line))
+  {
+    return 0;
+  }
+  // the fields after the command name, which may hold spaces
+  std::istringstream fields(line.substr(line.rfind(')') + 2));
+  std::string field;
+  double utime = 0, stime = 0;
+  for (int i = 3; i <= 15 && fields >> field; i++)
+  {
+    if (i == 14) utime = std::stod(field);
+    if (i == 15) stime = std::stod(field);
+  }
+  return (utime + stime) / sysconf(_SC_CLK_TCK);
+}
+}  // namespace
+
+int main(int argc, char *argv[])
+{
+  ros::init(argc, argv, "batch_benchmark");
+  ros::NodeHandle nh(""), nh_param("~");
+
+  const double duration = nh_param.param("duration", 10.0);
+  const double spin_rate = nh_param.param("spin_rate", 50.0);
+  const int queue_size = nh_param.param("queue_size", 100);
+  const int bridge_pid = nh_param.param("bridge_pid", 0);
+
+  FrameCounter counter;
+  ros::Subscriber frames = nh.subscribe("received_messages", queue_size, &FrameCounter::frameCallback, &counter);
+  ros::Subscriber batches = nh.subscribe("received_message_batches", queue_size,
+                                         &FrameCounter::batchCallback, &counter);
+
+  std::printf("waiting for frames\n");
+  ros::Rate loop_rate(spin_rate);
+  while (ros::ok() && counter.frames == 0)
+  {
+    ros::spinOnce();
+    loop_rate.sleep();
+  }
+  const uint64_t frames_start = counter.frames, messages_start = counter.messages, lost_start = counter.lost;
+  const double own_start = ownCpuTime(), bridge_start = processCpuTime(bridge_pid);
+  const ros::WallTime start = ros::WallTime::now();
+  while (ros::ok() && (ros::WallTime::now() - start).toSec() < duration)
+  {
+    ros::spinOnce();
+    loop_rate.sleep();
+  }
+  const double elapsed = (ros::WallTime::now() - start).toSec();
+
+  const double frames_count = counter.frames - frames_start, lost = counter.lost - lost_start;
+  std::printf("%.1f s, %.0f frames/s in %.0f messages/s\n", elapsed, frames_count / elapsed,
+              (counter.messages - messages_start) / elapsed);
+  std::printf("lost        %.0f frames, %.3f %%\n", lost, 100.0 * lost / (frames_count + lost));
+  std::printf("subscriber  %.2f %% cpu\n", 100.0 * (ownCpuTime() - own_start) / elapsed);
+  if (bridge_pid > 0)
+  {
+    std::printf("bridge      %.2f %% cpu\n", 100.0 * (processCpuTime(bridge_pid) - bridge_start) / elapsed);
+  }
+  return 0;
+}
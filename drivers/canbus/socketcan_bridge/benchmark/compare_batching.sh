@@ -0,0 +1,42 @@
+#!/bin/bash
+
+# runs batch_benchmark against the bridge publishing one message per frame, as
+# before the batching, and against the batching bridge, under the same cangen load
+#   ./test/initialize_vcan.sh && roscore &
+#   ./benchmark/compare_batching.sh [duration s] [cangen gap ms]
+# then runs the bridge rostests on the same bus. The lost frames and CPU it
+# prints for both configurations are the numbers the batching change needs;
+# none have been recorded yet.
+
+DURATION=${1:-10}
+GAP=${2:-0.4}   # 2500 frames/s
+DEVICE=vcan0
+
+if ! rostopic list > /dev/null 2>&1; then
+  echo "no ROS master, start roscore first."
+  exit 1
+fi
+if ! command -v cangen > /dev/null; then
+  echo "cangen not found, it is in can-utils."
+  exit 1
+fi
+
+run() {
+  echo "=== $1"
+  shift
+  # rosrun execs the node, so $! is the bridge
+  rosrun socketcan_bridge socketcan_to_topic_node _can_device:=$DEVICE "$@" > /dev/null &
+  BRIDGE=$!
+  sleep 2
+  cangen $DEVICE -g $GAP -I 18F02501 -e -L 8 -D i &
+  GENERATOR=$!
+  rosrun socketcan_bridge batch_benchmark _bridge_pid:=$BRIDGE _duration:=$DURATION
+  kill $GENERATOR $BRIDGE
+  wait $GENERATOR $BRIDGE 2> /dev/null
+}
+
+run "one message per frame" _batch_window:=0.0 _batch_size:=1 _receive_batch:=1 _kernel_filters:=false
+run "batches" _batch_window:=0.001 _batch_size:=32 _receive_batch:=32 _kernel_filters:=false
+
+echo "=== rostests"
+rostest socketcan_bridge to_topic.test && rostest socketcan_bridge to_socketcan.test
@@ -31,7 +31,9 @@
 #include <socketcan_interface/socketcan.h>
 #include <socketcan_interface/filter.h>
 #include <can_msgs/Frame.h>
+#include <can_msgs/FrameArray.h>
 #include <ros/ros.h>
+#include <mutex>
 
 namespace socketcan_bridge
 {
@@ -51,9 +53,26 @@ class SocketCANToTopic
     can::FrameListenerConstSharedPtr frame_listener_;
     can::StateListenerConstSharedPtr state_listener_;
 
+    // can_ids filters set on the socket too, for every listener of the driver
+    bool kernel_filters_;
+
+    // with batch_window > 0 or batch_size > 1 the frames are published together
+    // as can_msgs::FrameArray on received_message_batches instead of one by one.
+    // A batch goes out once it holds batch_size frames or its first frame is
+    // batch_window old; on a quiet bus the timer sends it at most two windows late.
+    bool batching_;
+    double batch_window_;
+    int batch_size_;
+    ros::Publisher batch_topic_;
+    ros::WallTimer batch_timer_;
+    std::mutex batch_mutex_;
+    can_msgs::FrameArray batch_;
+    ros::WallTime batch_start_;
 
     void frameCallback(const can::Frame& f);
     void stateCallback(const can::State & s);
+    void batchTimerCallback(const ros::WallTimerEvent& e);
+    void publishBatch();  // with batch_mutex_ held, so batches keep their order
 };
 
 void convertSocketCANToMessage(const can::Frame& f, can_msgs::Frame& m)
@@ -28,6 +28,7 @@
 #include <socketcan_bridge/socketcan_to_topic.h>
 #include <socketcan_interface/string.h>
 #include <can_msgs/Frame.h>
+#include <algorithm>
 #include <string>
 
 namespace can
@@ -52,8 +53,27 @@ namespace socketcan_bridge
   SocketCANToTopic::SocketCANToTopic(ros::NodeHandle* nh, ros::NodeHandle* nh_param,
       can::DriverInterfaceSharedPtr driver)
     {
-      can_topic_ = nh->advertise<can_msgs::Frame>("received_messages",
-                                                  nh_param->param("received_messages_queue_size", 10));
+      int queue_size = nh_param->param("received_messages_queue_size", 10);
+      kernel_filters_ = nh_param->param("kernel_filters", false);
+      batch_window_ = nh_param->param("batch_window", 0.0);
+      batch_size_ = nh_param->param("batch_size", 1);
+      batching_ = batch_window_ > 0 || batch_size_ > 1;
+
+      if (batching_)
+      {
+        batch_topic_ = nh->advertise<can_msgs::FrameArray>("received_message_batches", queue_size);
+        batch_.frames.reserve(std::max(batch_size_, 1));
+        if (batch_window_ > 0)
+        {
+          batch_timer_ = nh->createWallTimer(ros::WallDuration(batch_window_),
+                                             &SocketCANToTopic::batchTimerCallback, this);
+        }
+        ROS_INFO("Publishing frames in batches, window: %f s, size: %d", batch_window_, batch_size_);
+      }
+      else
+      {
+        can_topic_ = nh->advertise<can_msgs::Frame>("received_messages", queue_size);
+      }
       driver_ = driver;
     };
 
@@ -66,6 +86,16 @@ namespace socketcan_bridge
 
   void SocketCANToTopic::setup(const can::FilteredFrameListener::FilterVector &filters)
   {
+    // the kernel drops the other frames before they are read, the listener below still filters
+    if (kernel_filters_)
+    {
+      can::SocketCANInterfaceSharedPtr socketcan = std::dynamic_pointer_cast<can::SocketCANInterface>(driver_);
+      if (!socketcan || !socketcan->setKernelFilters(filters))
+      {
+        ROS_WARN("Could not pass the can_ids filters to the kernel, filtering after reading them");
+      }
+    }
+
     frame_listener_.reset(new can::FilteredFrameListener(driver_,
                                                          std::bind(&SocketCANToTopic::frameCallback,
                                                                    this,
@@ -111,9 +141,49 @@ namespace socketcan_bridge
       convertSocketCANToMessage(f, msg);
 
       msg.header.frame_id = "";  // empty frame is the de-facto standard for no frame.
-      msg.header.stamp = ros::Time::now();
+      if (f.stamp.time_since_epoch().count() != 0)  // kernel receive time, unset by drivers without one
+      {
+        msg.header.stamp.fromNSec(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            f.stamp.time_since_epoch()).count());
+      }
+      else
+      {
+        msg.header.stamp = ros::Time::now();
+      }
 
-      can_topic_.publish(msg);
+      if (!batching_)
+      {
+        can_topic_.publish(msg);
+        return;
+      }
+
+      std::lock_guard<std::mutex> lock(batch_mutex_);
+      if (batch_.frames.empty())
+      {
+        batch_start_ = ros::WallTime::now();
+      }
+      batch_.frames.push_back(msg);
+      if ((batch_size_ > 1 && batch_.frames.size() >= static_cast<size_t>(batch_size_)) ||
+          (batch_window_ > 0 && ros::WallTime::now() - batch_start_ >= ros::WallDuration(batch_window_)))
+      {
+        publishBatch();
+      }
+    };
+
+  void SocketCANToTopic::batchTimerCallback(const ros::WallTimerEvent& e)
+    {
+      std::lock_guard<std::mutex> lock(batch_mutex_);
+      if (!batch_.frames.empty() && ros::WallTime::now() - batch_start_ >= ros::WallDuration(batch_window_))
+      {
+        publishBatch();
+      }
+    };
+
+  void SocketCANToTopic::publishBatch()
+    {
+      batch_.header.stamp = ros::Time::now();
+      batch_topic_.publish(batch_);
+      batch_.frames.clear();  // keeps the capacity
     };
 
 
@@ -27,6 +27,7 @@
 #include <socketcan_bridge/socketcan_to_topic.h>
 
 #include <can_msgs/Frame.h>
+#include <can_msgs/FrameArray.h>
 #include <socketcan_interface/socketcan.h>
 #include <socketcan_interface/dummy.h>
 #include <socketcan_bridge/topic_to_socketcan.h>
@@ -51,6 +52,19 @@ class msgCollector
     }
 };
 
+class batchCollector
+{
+  public:
+    std::list<can_msgs::FrameArray> batches;
+
+    batchCollector() {}
+
+    void batchCallback(const can_msgs::FrameArray& b)
+    {
+      batches.push_back(b);
+    }
+};
+
 std::string convertMessageToString(const can_msgs::Frame &msg, bool lc = true)
 {
   can::Frame f;
@@ -315,6 +329,88 @@ TEST(SocketCANToTopicTest, checkMaskFilter)
   EXPECT_EQ(pass2, convertMessageToString(message_collector_.messages.back()));
 }
 
+TEST(SocketCANToTopicTest, checkBatchBySize)
+{
+  ros::NodeHandle nh(""), nh_param("~");
+
+  can::DummyBus bus("checkBatchBySize");
+
+  // create the dummy interface
+  can::ThreadedDummyInterfaceSharedPtr dummy = std::make_shared<can::ThreadedDummyInterface>();
+
+  // start the to topic bridge, publishing batches of three frames.
+  nh_param.setParam("batch_size", 3);
+  socketcan_bridge::SocketCANToTopic to_topic_bridge(&nh, &nh_param, dummy);
+  nh_param.deleteParam("batch_size");
+  to_topic_bridge.setup();  // initiate the message callbacks
+
+  dummy->init(bus.name, true, can::NoSettings::create());
+
+  // create collectors for both topics.
+  msgCollector message_collector_;
+  batchCollector batch_collector_;
+  ros::Subscriber subscriber_ = nh.subscribe("received_messages", 10, &msgCollector::msgCallback, &message_collector_);
+  ros::Subscriber batch_subscriber_ = nh.subscribe("received_message_batches", 10,
+                                                   &batchCollector::batchCallback, &batch_collector_);
+
+  const std::string frames[] = {"300#01", "301#02", "302#03", "303#04"};
+  for (const std::string &frame : frames)
+  {
+    dummy->send(can::toframe(frame));
+  }
+
+  // give some time for the interface some time to process the message
+  ros::WallDuration(0.5).sleep();
+  ros::spinOnce();
+
+  // the fourth frame waits for two more.
+  EXPECT_EQ(0, message_collector_.messages.size());
+  ASSERT_EQ(1, batch_collector_.batches.size());
+  const can_msgs::FrameArray &batch = batch_collector_.batches.front();
+  ASSERT_EQ(3, batch.frames.size());
+  for (size_t i = 0; i < batch.frames.size(); i++)
+  {
+    EXPECT_EQ(frames[i], convertMessageToString(batch.frames[i]));
+  }
+}
+
+TEST(SocketCANToTopicTest, checkBatchByWindow)
+{
+  ros::NodeHandle nh(""), nh_param("~");
+
+  can::DummyBus bus("checkBatchByWindow");
+
+  // create the dummy interface
+  can::ThreadedDummyInterfaceSharedPtr dummy = std::make_shared<can::ThreadedDummyInterface>();
+
+  // start the to topic bridge, with a batch size the frames never reach.
+  nh_param.setParam("batch_window", 0.05);
+  nh_param.setParam("batch_size", 100);
+  socketcan_bridge::SocketCANToTopic to_topic_bridge(&nh, &nh_param, dummy);
+  nh_param.deleteParam("batch_window");
+  nh_param.deleteParam("batch_size");
+  to_topic_bridge.setup();  // initiate the message callbacks
+
+  dummy->init(bus.name, true, can::NoSettings::create());
+
+  batchCollector batch_collector_;
+  ros::Subscriber batch_subscriber_ = nh.subscribe("received_message_batches", 10,
+                                                   &batchCollector::batchCallback, &batch_collector_);
+
+  dummy->send(can::toframe("300#1234"));
+  dummy->send(can::toframe("301#5678"));
+
+  // the timer sends the batch from a spin, its subscriber gets it in the next one.
+  for (int i = 0; i < 5; i++)
+  {
+    ros::WallDuration(0.1).sleep();
+    ros::spinOnce();
+  }
+
+  ASSERT_EQ(1, batch_collector_.batches.size());
+  EXPECT_EQ(2, batch_collector_.batches.front().frames.size());
+}
+
 int main(int argc, char **argv)
 {
   ros::init(argc, argv, "test_to_topic");
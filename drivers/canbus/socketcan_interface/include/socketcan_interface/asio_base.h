@@ -7,6 +7,7 @@
 #include <boost/thread/mutex.hpp>
 #include <boost/thread/thread.hpp>
 #include <functional>
+#include <vector>
 
 namespace can{
 
@@ -45,6 +46,9 @@ protected:
     void dispatchFrame(const Frame &msg){
         strand_.post([this, msg]{ frame_dispatcher_.dispatch(msg.key(), msg);} ); // copies msg
     }
+    void dispatchFrames(std::vector<Frame> &&msgs){
+        strand_.post([this, msgs = std::move(msgs)]{ for(const Frame &msg : msgs) frame_dispatcher_.dispatch(msg.key(), msg);} ); // one job per batch
+    }
     void setErrorCode(const boost::system::error_code& error){
         boost::mutex::scoped_lock lock(state_mutex_);
         if(state_.error_code != error){
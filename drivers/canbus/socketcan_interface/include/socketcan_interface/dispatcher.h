@@ -1,16 +1,67 @@
 #ifndef H_CAN_DISPATCHER
 #define H_CAN_DISPATCHER
 
+#include <algorithm>
+#include <atomic>
 #include <functional>
 #include <memory>
-#include <list>
 #include <unordered_map>
+#include <vector>
 
 #include <socketcan_interface/interface.h>
 #include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
 
 namespace can{
 
+/**
+ * read-copy-update for the listener tables of the dispatchers
+ *
+ * dispatch() only counts itself in and out (no lock, no allocation, the map is only read),
+ * writers copy the table they change, publish the copy and wait in synchronize()
+ * until no dispatch() can still be reading the old one. Readers counted in before a
+ * writer flips the epoch hold up only that writer, later ones count on the other side.
+ * As with the mutex before, a listener must not be created or destroyed from inside a
+ * callback of the same dispatcher, the writer would wait for itself.
+ */
+class DispatchGuard{
+    std::atomic<unsigned int> epoch_;
+    std::atomic<unsigned int> readers_[2];
+public:
+    boost::mutex mutex; ///< serializes the writers
+
+    DispatchGuard() : epoch_(0) { readers_[0] = 0; readers_[1] = 0; }
+
+    /**
+     * counts itself in on the side of the current epoch, re-checked after counting in:
+     * the epoch cannot have moved on between the check and the load of a table, so every table
+     * a Reader loads stays valid until it is destroyed. A writer that flips the epoch in between
+     * sees the count and waits, the Reader then retries on the new side.
+     */
+    class Reader{
+        std::atomic<unsigned int> *readers_;
+    public:
+        Reader(DispatchGuard &guard) {
+            for(;;){
+                const unsigned int epoch = guard.epoch_.load();
+                readers_ = &guard.readers_[epoch & 1];
+                ++*readers_;
+                if(guard.epoch_.load() == epoch) break;
+                --*readers_;
+            }
+        }
+        ~Reader() { --*readers_; }
+    };
+
+    /** with mutex held, after the new table is published and before the old one is freed */
+    void synchronize(){
+        const unsigned int epoch = epoch_++;
+        while(readers_[epoch & 1].load() != 0){
+            boost::this_thread::yield();
+        }
+    }
+};
+
 template< typename Listener > class SimpleDispatcher{
 public:
     using Callable = typename Listener::Callable;
@@ -35,46 +86,63 @@ protected:
             }
         };
 
-        boost::mutex &mutex_;
-        std::list<const Listener* > listeners_;
+        using ListenerVector = std::vector<const Listener* >;
+
+        DispatchGuard &guard_;
+        std::atomic<const ListenerVector* > listeners_; // replaced, never changed in place
+
+        void replace(const ListenerVector *listeners){
+            const ListenerVector *old = listeners_.exchange(listeners);
+            guard_.synchronize();
+            delete old;
+        }
     public:
-        DispatcherBase(boost::mutex &mutex) : mutex_(mutex) {}
+        DispatcherBase(DispatchGuard &guard) : guard_(guard), listeners_(new ListenerVector) {}
+        ~DispatcherBase() { delete listeners_.load(); }
+
+        /** inside a DispatchGuard::Reader */
         void dispatch_nolock(const Type &obj, const Listener* loopback=nullptr) const{
-            for(typename std::list<const Listener* >::const_iterator it=listeners_.begin(); it != listeners_.end(); ++it){
+            const ListenerVector &listeners = *listeners_.load();
+            for(typename ListenerVector::const_iterator it=listeners.begin(); it != listeners.end(); ++it){
                 if (loopback != *it) {
                     (**it)(obj);
                 }
             }
         }
         void remove(Listener *d){
-            boost::mutex::scoped_lock lock(mutex_);
-            listeners_.remove(d);
+            boost::mutex::scoped_lock lock(guard_.mutex);
+            ListenerVector *listeners = new ListenerVector(*listeners_.load());
+            listeners->erase(std::remove(listeners->begin(), listeners->end(), d), listeners->end());
+            replace(listeners);
         }
         size_t numListeners(){
-            boost::mutex::scoped_lock lock(mutex_);
-            return listeners_.size();
+            boost::mutex::scoped_lock lock(guard_.mutex);
+            return listeners_.load()->size();
         }
 
+        /** with the mutex of the DispatchGuard held */
         static ListenerConstSharedPtr createListener(DispatcherBaseSharedPtr dispatcher, const  Callable &callable){
             ListenerConstSharedPtr l(new GuardedListener(dispatcher,callable));
-            dispatcher->listeners_.push_back(l.get());
+            ListenerVector *listeners = new ListenerVector(*dispatcher->listeners_.load());
+            listeners->push_back(l.get());
+            dispatcher->replace(listeners);
             return l;
         }
     };
-    boost::mutex mutex_;
+    DispatchGuard guard_;
     DispatcherBaseSharedPtr dispatcher_;
 public:
-    SimpleDispatcher() : dispatcher_(new DispatcherBase(mutex_)) {}
+    SimpleDispatcher() : dispatcher_(new DispatcherBase(guard_)) {}
     ListenerConstSharedPtr createListener(const Callable &callable){
-        boost::mutex::scoped_lock lock(mutex_);
+        boost::mutex::scoped_lock lock(guard_.mutex);
         return DispatcherBase::createListener(dispatcher_, callable);
     }
     void dispatch(const Type &obj){
-        boost::mutex::scoped_lock lock(mutex_);
+        DispatchGuard::Reader reader(guard_);
         dispatcher_->dispatch_nolock(obj);
     }
     void dispatch_filtered(const Type &obj, ListenerConstSharedPtr without){
-        boost::mutex::scoped_lock lock(mutex_);
+        DispatchGuard::Reader reader(guard_);
         dispatcher_->dispatch_nolock(obj, without.get());
     }
     size_t numListeners(){
@@ -85,13 +153,28 @@ public:
 
 template<typename K, typename Listener, typename Hash = std::hash<K> > class FilteredDispatcher: public SimpleDispatcher<Listener>{
     using BaseClass = SimpleDispatcher<Listener>;
-    std::unordered_map<K, typename BaseClass::DispatcherBaseSharedPtr, Hash> filtered_;
+    using FilterMap = std::unordered_map<K, typename BaseClass::DispatcherBaseSharedPtr, Hash>;
+    std::atomic<const FilterMap* > filtered_; // replaced when a key is added, keys are never removed
 public:
+    FilteredDispatcher() : filtered_(new FilterMap) {}
+    ~FilteredDispatcher() { delete filtered_.load(); }
+
     using BaseClass::createListener;
     typename BaseClass::ListenerConstSharedPtr createListener(const K &key, const typename BaseClass::Callable &callable){
-        boost::mutex::scoped_lock lock(BaseClass::mutex_);
-        typename BaseClass::DispatcherBaseSharedPtr &ptr = filtered_[key];
-        if(!ptr) ptr.reset(new typename BaseClass::DispatcherBase(BaseClass::mutex_));
+        boost::mutex::scoped_lock lock(BaseClass::guard_.mutex);
+        const FilterMap *filtered = filtered_.load();
+        typename FilterMap::const_iterator it = filtered->find(key);
+        typename BaseClass::DispatcherBaseSharedPtr ptr;
+        if(it != filtered->end()){
+            ptr = it->second;
+        }else{
+            ptr.reset(new typename BaseClass::DispatcherBase(BaseClass::guard_));
+            FilterMap *next = new FilterMap(*filtered);
+            next->emplace(key, ptr);
+            filtered_.store(next);
+            BaseClass::guard_.synchronize();
+            delete filtered;
+        }
         return BaseClass::DispatcherBase::createListener(ptr, callable);
     }
 
@@ -102,9 +185,10 @@ public:
     }
 
     void dispatch(const K &key, const typename BaseClass::Type &obj){
-        boost::mutex::scoped_lock lock(BaseClass::mutex_);
-        typename BaseClass::DispatcherBaseSharedPtr &ptr = filtered_[key];
-        if(ptr) ptr->dispatch_nolock(obj);
+        DispatchGuard::Reader reader(BaseClass::guard_);
+        const FilterMap &filtered = *filtered_.load();
+        typename FilterMap::const_iterator it = filtered.find(key);
+        if(it != filtered.end()) it->second->dispatch_nolock(obj);
         BaseClass::dispatcher_->dispatch_nolock(obj);
     }
 
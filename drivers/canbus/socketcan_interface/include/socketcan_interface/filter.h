@@ -10,6 +10,8 @@ namespace can {
 class FrameFilter {
 public:
   virtual bool pass(const can::Frame &frame) const = 0;
+  /** the filter as masked id and mask on Frame::key(), false if it cannot be written so */
+  virtual bool getMask(uint32_t &/*masked_id*/, uint32_t &/*mask*/, bool &/*invert*/) const { return false; }
   virtual ~FrameFilter() {}
 };
 using FrameFilterSharedPtr = std::shared_ptr<FrameFilter>;
@@ -25,6 +27,12 @@ public:
     const uint32_t k = frame.key();
     return ((mask_ & k) == masked_id_) != invert_;
   }
+  virtual bool getMask(uint32_t &masked_id, uint32_t &mask, bool &invert) const{
+    masked_id = masked_id_;
+    mask = mask_;
+    invert = invert_;
+    return true;
+  }
 private:
   const uint32_t mask_;
   const uint32_t masked_id_;
@@ -2,6 +2,7 @@
 #define H_CAN_INTERFACE
 
 #include <array>
+#include <chrono>
 #include <memory>
 #include <functional>
 
@@ -63,6 +64,7 @@ struct Frame: public Header{
     using value_type = unsigned char;
     std::array<value_type, 8> data; ///< array for 8 data bytes with bounds checking
     unsigned char dlc; ///< len of data
+    std::chrono::system_clock::time_point stamp; ///< kernel receive time, left at the epoch by drivers without one
 
     /** check if frame header and length are valid*/
     bool isValid() const{
@@ -8,14 +8,19 @@
 #include <sys/socket.h>
 #include <sys/ioctl.h>
 #include <net/if.h>
+#include <poll.h>
 
 #include <linux/can.h>
 #include <linux/can/raw.h>
 #include <linux/can/error.h>
 
+#include <algorithm>
+#include <cerrno>
 #include <cstring>
+#include <vector>
 
 #include <socketcan_interface/dispatcher.h>
+#include <socketcan_interface/filter.h>
 #include <socketcan_interface/string.h>
 
 namespace can {
@@ -24,6 +29,8 @@ class SocketCANInterface : public AsioDriver<boost::asio::posix::stream_descript
     bool loopback_;
     int sc_;
     can_err_mask_t error_mask_, fatal_error_mask_;
+    int receive_batch_;
+    std::vector<can_filter> kernel_filters_;
 
     static can_err_mask_t parse_error_mask(SettingsConstSharedPtr settings, const std::string &entry, can_err_mask_t defaults) {
         can_err_mask_t mask = 0;
@@ -44,9 +51,11 @@ class SocketCANInterface : public AsioDriver<boost::asio::posix::stream_descript
     }
 public:
     SocketCANInterface()
-    : loopback_(false), sc_(-1), error_mask_(0), fatal_error_mask_(0)
+    : loopback_(false), sc_(-1), error_mask_(0), fatal_error_mask_(0), receive_batch_(1)
     {}
 
+    using AsioDriver::send;
+
     virtual bool doesLoopBack() const{
         return loopback_;
     }
@@ -79,6 +88,8 @@ public:
                                            );
       can_err_mask_t fatal_error_mask = parse_error_mask(settings, "fatal_error_mask", fatal_errors) | CAN_ERR_BUSOFF;
       can_err_mask_t error_mask = parse_error_mask(settings, "error_mask", report_errors | fatal_error_mask) | fatal_error_mask;
+      // frames per recvmmsg() call
+      receive_batch_ = std::max(1, settings->get_optional("receive_batch", 1));
       return init(device, loopback, error_mask, fatal_error_mask);
     }
 
@@ -129,10 +140,71 @@ public:
     int getInternalSocket() {
         return sc_;
     }
+
+    /**
+     * let the kernel drop the frames no filter passes (CAN_RAW_FILTER), for every listener of this driver
+     *
+     * @param[in] filters: mask filters, the kernel lets a frame pass if one of them does; empty clears
+     * @return false if a filter has no mask form or the socket refuses them, the kernel then passes all frames
+     */
+    bool setKernelFilters(const FilteredFrameListener::FilterVector &filters){
+        std::vector<can_filter> kernel_filters;
+        const bool converted = toKernelFilters(filters, kernel_filters);
+        kernel_filters_ = converted ? kernel_filters : std::vector<can_filter>();
+        if(!converted){
+            // drop the filters set before, the listeners may want frames they do not pass
+            if(socket_.is_open()) applyKernelFilters(sc_);
+            return false;
+        }
+        if(socket_.is_open() && !applyKernelFilters(sc_)){
+            kernel_filters_.clear();
+            applyKernelFilters(sc_);
+            return false;
+        }
+        return true;
+    }
+
+    static bool toKernelFilters(const FilteredFrameListener::FilterVector &filters, std::vector<can_filter> &kernel_filters){
+        kernel_filters.clear();
+        for(const FrameFilterSharedPtr &filter : filters){
+            uint32_t masked_id, mask;
+            bool invert;
+            if(!filter || !filter->getMask(masked_id, mask, invert)){
+                return false;
+            }
+            // Frame::key() has the bit layout of can_id; error frames are left to CAN_RAW_ERR_FILTER
+            can_filter f;
+            f.can_id = (masked_id & ~CAN_ERR_FLAG) | (invert ? CAN_INV_FILTER : 0);
+            f.can_mask = mask & ~CAN_ERR_FLAG;
+            kernel_filters.push_back(f);
+        }
+        return true;
+    }
+
+    /**
+     * send frames in order with as few sendmmsg() calls as the socket allows
+     *
+     * @return true if all frames were sent
+     */
+    bool send(const std::vector<Frame> &msgs){
+        return getState().driver_state == State::ready && enqueue(msgs.data(), msgs.size());
+    }
 protected:
     std::string device_;
     can_frame frame_;
 
+    // recvmsg() buffers of a single frame
+    iovec frame_iov_;
+    msghdr frame_msg_;
+    std::vector<char> frame_control_;
+
+    // recvmmsg() buffers, receive_batch_ entries
+    std::vector<can_frame> batch_frames_;
+    std::vector<iovec> batch_iov_;
+    std::vector<mmsghdr> batch_msgs_;
+    std::vector<char> batch_control_;
+    static const size_t CONTROL_SIZE = CMSG_SPACE(sizeof(timeval));
+
     bool init(const std::string &device, bool loopback, can_err_mask_t error_mask, can_err_mask_t fatal_error_mask) {
         State s = getState();
         if(s.driver_state == State::closed){
@@ -177,6 +249,22 @@ protected:
                 }
             }
 
+            if(!kernel_filters_.empty() && !applyKernelFilters(sc)){
+                ROSCANOPEN_WARN("socketcan_interface", "kernel filters refused, filtering in user space");
+                kernel_filters_.clear();
+            }
+
+            // every received frame carries the kernel receive time in Frame::stamp
+            int timestamp = 1;
+            ret = setsockopt(sc, SOL_SOCKET, SO_TIMESTAMP, &timestamp, sizeof(timestamp));
+
+            if(ret != 0){
+                setErrorCode(boost::system::error_code(ret,boost::system::system_category()));
+                close(sc);
+                return false;
+            }
+            prepareReceive();
+
             struct sockaddr_can addr = {0};
             addr.can_family = AF_CAN;
             addr.can_ifindex = ifr.ifr_ifindex;
@@ -207,19 +295,19 @@ protected:
 
     virtual void triggerReadSome(){
         boost::mutex::scoped_lock lock(send_mutex_);
-        socket_.async_read_some(boost::asio::buffer(&frame_, sizeof(frame_)), boost::bind( &SocketCANInterface::readFrame,this, boost::asio::placeholders::error));
+        if(receive_batch_ > 1){
+            // wait until readable, readFrames() takes all that is queued
+            socket_.async_read_some(boost::asio::null_buffers(), boost::bind( &SocketCANInterface::readFrames,this, boost::asio::placeholders::error));
+        }else{
+            // wait until readable, readFrame() takes one frame with recvmsg() for its timestamp
+            socket_.async_read_some(boost::asio::null_buffers(), boost::bind( &SocketCANInterface::readFrame,this, boost::asio::placeholders::error));
+        }
     }
 
     virtual bool enqueue(const Frame & msg){
         boost::mutex::scoped_lock lock(send_mutex_); //TODO: timed try lock
 
-        can_frame frame = {0};
-        frame.can_id = msg.id | (msg.is_extended?CAN_EFF_FLAG:0) | (msg.is_rtr?CAN_RTR_FLAG:0);;
-        frame.can_dlc = msg.dlc;
-
-
-        for(int i=0; i < frame.can_dlc;++i)
-            frame.data[i] = msg.data[i];
+        can_frame frame = toCanFrame(msg);
 
         boost::system::error_code ec;
         boost::asio::write(socket_, boost::asio::buffer(&frame, sizeof(frame)),boost::asio::transfer_all(), ec);
@@ -233,32 +321,168 @@ protected:
         return true;
     }
 
-    void readFrame(const boost::system::error_code& error){
-        if(!error){
-            input_.dlc = frame_.can_dlc;
-            for(int i=0;i<frame_.can_dlc && i < 8; ++i){
-                input_.data[i] = frame_.data[i];
-            }
-
-            if(frame_.can_id & CAN_ERR_FLAG){ // error message
-                input_.id = frame_.can_id & CAN_EFF_MASK;
-                input_.is_error = 1;
+    bool enqueue(const Frame *msgs, size_t count){
+        boost::mutex::scoped_lock lock(send_mutex_);
 
-                if (frame_.can_id & fatal_error_mask_) {
-                    ROSCANOPEN_ERROR("socketcan_interface", "internal error: " << input_.id);
-                    setInternalError(input_.id);
+        const size_t CHUNK = 32;
+        can_frame frames[CHUNK];
+        iovec iov[CHUNK];
+        mmsghdr hdrs[CHUNK];
+        for(size_t done = 0; done < count;){
+            const size_t n = std::min(CHUNK, count - done);
+            for(size_t i = 0; i < n; ++i){
+                frames[i] = toCanFrame(msgs[done + i]);
+                iov[i].iov_base = &frames[i];
+                iov[i].iov_len = sizeof(can_frame);
+                hdrs[i] = mmsghdr();
+                hdrs[i].msg_hdr.msg_iov = &iov[i];
+                hdrs[i].msg_hdr.msg_iovlen = 1;
+            }
+            for(size_t sent = 0; sent < n;){
+                int ret = sendmmsg(sc_, hdrs + sent, n - sent, 0);
+                if(ret < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)){
+                    // like boost::asio::write(), wait for room on a socket asio made non-blocking
+                    pollfd pfd = {sc_, POLLOUT, 0};
+                    poll(&pfd, 1, -1);
+                    continue;
+                }
+                if(ret < 0){
+                    boost::system::error_code ec(errno, boost::system::system_category());
+                    ROSCANOPEN_ERROR("socketcan_interface", "FAILED " << ec);
+                    setErrorCode(ec);
                     setNotReady();
+                    return false;
                 }
-            }else{
-                input_.is_extended = (frame_.can_id & CAN_EFF_FLAG) ? 1 :0;
-                input_.id = frame_.can_id & (input_.is_extended ? CAN_EFF_MASK : CAN_SFF_MASK);
-                input_.is_error = 0;
-                input_.is_rtr = (frame_.can_id & CAN_RTR_FLAG) ? 1 : 0;
+                sent += ret;
+            }
+            done += n;
+        }
+        return true;
+    }
+
+    static can_frame toCanFrame(const Frame &msg){
+        can_frame frame = {0};
+        frame.can_id = msg.id | (msg.is_extended?CAN_EFF_FLAG:0) | (msg.is_rtr?CAN_RTR_FLAG:0);
+        frame.can_dlc = msg.dlc;
+
+        for(int i=0; i < frame.can_dlc;++i)
+            frame.data[i] = msg.data[i];
+        return frame;
+    }
+
+    void fromCanFrame(const can_frame &frame, Frame &msg){
+        msg.dlc = frame.can_dlc;
+        for(int i=0;i<frame.can_dlc && i < 8; ++i){
+            msg.data[i] = frame.data[i];
+        }
+
+        if(frame.can_id & CAN_ERR_FLAG){ // error message
+            msg.id = frame.can_id & CAN_EFF_MASK;
+            msg.is_error = 1;
+
+            if (frame.can_id & fatal_error_mask_) {
+                ROSCANOPEN_ERROR("socketcan_interface", "internal error: " << msg.id);
+                setInternalError(msg.id);
+                setNotReady();
             }
+        }else{
+            msg.is_extended = (frame.can_id & CAN_EFF_FLAG) ? 1 :0;
+            msg.id = frame.can_id & (msg.is_extended ? CAN_EFF_MASK : CAN_SFF_MASK);
+            msg.is_error = 0;
+            msg.is_rtr = (frame.can_id & CAN_RTR_FLAG) ? 1 : 0;
+        }
+    }
 
+    void readFrame(const boost::system::error_code& error){
+        if(error){
+            frameReceived(error);
+            return;
+        }
+        frame_msg_.msg_controllen = frame_control_.size(); // the kernel shrinks it to what it wrote
+        if(recvmsg(sc_, &frame_msg_, MSG_DONTWAIT) < 0){
+            if(errno == EAGAIN || errno == EWOULDBLOCK){
+                triggerReadSome();
+                return;
+            }
+            frameReceived(boost::system::error_code(errno, boost::system::system_category()));
+            return;
         }
+        fromCanFrame(frame_, input_);
+        readTimestamp(frame_msg_, input_);
         frameReceived(error);
     }
+
+    static void readTimestamp(msghdr &hdr, Frame &msg){
+        msg.stamp = std::chrono::system_clock::time_point(); // unset unless the kernel sent one
+        for(cmsghdr *c = CMSG_FIRSTHDR(&hdr); c; c = CMSG_NXTHDR(&hdr, c)){
+            if(c->cmsg_level == SOL_SOCKET && c->cmsg_type == SCM_TIMESTAMP){
+                timeval tv;
+                std::memcpy(&tv, CMSG_DATA(c), sizeof(tv));
+                msg.stamp = std::chrono::system_clock::time_point(
+                    std::chrono::seconds(tv.tv_sec) + std::chrono::microseconds(tv.tv_usec));
+            }
+        }
+    }
+
+    void readFrames(const boost::system::error_code& error){
+        if(error){
+            frameReceived(error);
+            return;
+        }
+        for(mmsghdr &m : batch_msgs_){
+            m.msg_hdr.msg_controllen = CONTROL_SIZE; // the kernel shrinks it to what it wrote
+        }
+        int n = recvmmsg(sc_, batch_msgs_.data(), batch_msgs_.size(), MSG_DONTWAIT, nullptr);
+        if(n < 0){
+            if(errno != EAGAIN && errno != EWOULDBLOCK){
+                frameReceived(boost::system::error_code(errno, boost::system::system_category()));
+                return;
+            }
+            n = 0;
+        }
+
+        std::vector<Frame> msgs(n);
+        for(int i = 0; i < n; ++i){
+            fromCanFrame(batch_frames_[i], msgs[i]);
+            readTimestamp(batch_msgs_[i].msg_hdr, msgs[i]);
+        }
+        if(n > 0){
+            dispatchFrames(std::move(msgs));
+        }
+        triggerReadSome();
+    }
+
+    void prepareReceive(){
+        frame_iov_.iov_base = &frame_;
+        frame_iov_.iov_len = sizeof(frame_);
+        frame_control_.assign(CONTROL_SIZE, 0);
+        frame_msg_ = msghdr();
+        frame_msg_.msg_iov = &frame_iov_;
+        frame_msg_.msg_iovlen = 1;
+        frame_msg_.msg_control = frame_control_.data();
+        if(receive_batch_ <= 1){
+            return;
+        }
+        batch_frames_.resize(receive_batch_);
+        batch_iov_.resize(receive_batch_);
+        batch_msgs_.assign(receive_batch_, mmsghdr());
+        batch_control_.assign(receive_batch_ * CONTROL_SIZE, 0);
+        for(int i = 0; i < receive_batch_; ++i){
+            batch_iov_[i].iov_base = &batch_frames_[i];
+            batch_iov_[i].iov_len = sizeof(can_frame);
+            batch_msgs_[i].msg_hdr.msg_iov = &batch_iov_[i];
+            batch_msgs_[i].msg_hdr.msg_iovlen = 1;
+            batch_msgs_[i].msg_hdr.msg_control = &batch_control_[i * CONTROL_SIZE];
+        }
+    }
+
+    bool applyKernelFilters(int sc){
+        // no filters at all is the kernel default, one filter passing everything
+        can_filter pass_all = {0, 0};
+        const can_filter *filters = kernel_filters_.empty() ? &pass_all : kernel_filters_.data();
+        const size_t count = kernel_filters_.empty() ? 1 : kernel_filters_.size();
+        return setsockopt(sc, SOL_CAN_RAW, CAN_RAW_FILTER, filters, count * sizeof(can_filter)) == 0;
+    }
 private:
     boost::mutex send_mutex_;
 };
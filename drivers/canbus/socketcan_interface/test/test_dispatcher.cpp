@@ -4,6 +4,10 @@
 // Bring in gtest
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <memory>
+#include <thread>
+
 class Counter {
 public:
     size_t counter_;
@@ -77,6 +81,64 @@ TEST(DispatcherTest, testDelegateOnly)
 
 }
 
+// dispatch from several threads while another one keeps creating and destroying listeners
+TEST(DispatcherTest, testConcurrentListeners)
+{
+    can::FilteredDispatcher<unsigned int, can::CommInterface::FrameListener> dispatcher;
+    const size_t max_id = 64;
+    const size_t num_threads = 4;
+    const size_t num = 250000;
+
+    std::atomic<size_t> counter(0);
+    std::vector<can::CommInterface::FrameListenerConstSharedPtr> listeners;
+    for(size_t i=0; i < max_id; ++i) {
+        listeners.push_back(dispatcher.createListener(can::MsgHeader(i), [&counter](const can::Frame &) { ++counter; }));
+    }
+
+    // a churned listener must not be called once its shared pointer was reset
+    const size_t num_slots = 16;
+    std::atomic<size_t> late_calls(0), churned(0);
+    std::atomic<bool> done(false);
+    std::thread churn([&]() {
+        std::vector<can::CommInterface::FrameListenerConstSharedPtr> churn_listeners(num_slots);
+        std::vector<std::shared_ptr<std::atomic<bool> > > alive(num_slots);
+        for(size_t i=0; !done; ++i) {
+            const size_t slot = i % num_slots;
+            if(churn_listeners[slot]) {
+                churn_listeners[slot].reset();
+                *alive[slot] = false; // never set again, each listener has its own flag
+            }
+            std::shared_ptr<std::atomic<bool> > flag = std::make_shared<std::atomic<bool> >(true);
+            alive[slot] = flag;
+            churn_listeners[slot] = dispatcher.createListener(can::MsgHeader(i % (2 * max_id)), [flag, &late_calls](const can::Frame &) {
+                if(!*flag) ++late_calls;
+            });
+            ++churned;
+        }
+    });
+
+    boost::chrono::steady_clock::time_point start = boost::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for(size_t t=0; t < num_threads; ++t) {
+        threads.emplace_back([&dispatcher, t, max_id, num]() {
+            for(size_t i=0; i < num; ++i) {
+                can::Frame frame(can::MsgHeader((i + t) % max_id));
+                dispatcher.dispatch(frame.key(), frame);
+            }
+        });
+    }
+    for(std::thread &thread : threads) thread.join();
+    boost::chrono::steady_clock::time_point now = boost::chrono::steady_clock::now();
+    done = true;
+    churn.join();
+    double diff = boost::chrono::duration_cast<boost::chrono::duration<double> >(now-start).count();
+
+    EXPECT_EQ(num_threads * num, counter);
+    EXPECT_EQ(0, late_calls);
+    std::cout << std::fixed << diff << "\t" <<  num_threads * num << "\t" << num_threads * num / diff
+              << "\t" << churned << " listeners churned" << std::endl;
+}
+
 // Run all the tests that were declared with TEST()
 int main(int argc, char **argv){
 testing::InitGoogleTest(&argc, argv);
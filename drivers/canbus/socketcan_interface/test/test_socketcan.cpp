@@ -0,0 +1,65 @@
+// Bring in my package's API, which is what I'm testing
+#include <socketcan_interface/socketcan.h>
+#include <socketcan_interface/string.h>
+
+// Bring in gtest
+#include <gtest/gtest.h>
+
+class SocketCANTestInterface : public can::SocketCANInterface {
+public:
+    using can::SocketCANInterface::toCanFrame;
+};
+
+// what the kernel does with CAN_RAW_FILTER for a frame that is not an error frame
+bool kernelPass(const std::vector<can_filter> &filters, const can::Frame &frame) {
+    const canid_t can_id = SocketCANTestInterface::toCanFrame(frame).can_id;
+    for (const can_filter &f : filters) {
+        const bool invert = (f.can_id & CAN_INV_FILTER) != 0;
+        const canid_t id = f.can_id & ~CAN_INV_FILTER;
+        if (((can_id & f.can_mask) == (id & f.can_mask)) != invert) return true;
+    }
+    return false;
+}
+
+TEST(SocketCANTest, kernelFiltersPassLikeMaskFilters)
+{
+    const std::vector<std::string> filter_strings{"123", "300:ffe", "18F02501", "400~7ff", "701:700"};
+    const std::vector<std::string> frames{"123#", "124#", "300#11", "301#", "302#", "18F02501#0102",
+                                          "18F02502#", "00000123#", "123#R", "400#", "401#", "7FF#"};
+
+    for (const std::string &filter_string : filter_strings) {
+        can::FilteredFrameListener::FilterVector filters{can::tofilter(filter_string)};
+        std::vector<can_filter> kernel_filters;
+        ASSERT_TRUE(can::SocketCANInterface::toKernelFilters(filters, kernel_filters));
+        ASSERT_EQ(1u, kernel_filters.size());
+        for (const std::string &frame_string : frames) {
+            const can::Frame frame = can::toframe(frame_string);
+            EXPECT_EQ(filters.front()->pass(frame), kernelPass(kernel_filters, frame))
+                << filter_string << " " << frame_string;
+        }
+    }
+}
+
+TEST(SocketCANTest, kernelFiltersAnyPasses)
+{
+    can::FilteredFrameListener::FilterVector filters{can::tofilter("123"), can::tofilter("18F02501")};
+    std::vector<can_filter> kernel_filters;
+    ASSERT_TRUE(can::SocketCANInterface::toKernelFilters(filters, kernel_filters));
+
+    EXPECT_TRUE(kernelPass(kernel_filters, can::toframe("123#")));
+    EXPECT_TRUE(kernelPass(kernel_filters, can::toframe("18F02501#")));
+    EXPECT_FALSE(kernelPass(kernel_filters, can::toframe("124#")));
+}
+
+TEST(SocketCANTest, rangeFiltersStayInUserSpace)
+{
+    can::FilteredFrameListener::FilterVector filters{can::tofilter("123"), can::tofilter("120-125")};
+    std::vector<can_filter> kernel_filters;
+    EXPECT_FALSE(can::SocketCANInterface::toKernelFilters(filters, kernel_filters));
+}
+
+// Run all the tests that were declared with TEST()
+int main(int argc, char **argv){
+testing::InitGoogleTest(&argc, argv);
+return RUN_ALL_TESTS();
+}
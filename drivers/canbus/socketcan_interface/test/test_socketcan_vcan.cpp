@@ -0,0 +1,230 @@
+// Bring in my package's API, which is what I'm testing
+#include <socketcan_interface/socketcan.h>
+#include <socketcan_interface/string.h>
+#include <socketcan_interface/threading.h>
+
+// Bring in gtest
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// needs a vcan0 interface, see socketcan_bridge/test/initialize_vcan.sh; the tests pass without checking anything if there is none
+namespace {
+const char DEVICE[] = "vcan0";
+
+bool vcanAvailable() {
+    int sc = socket(PF_CAN, SOCK_RAW, CAN_RAW);
+    if (sc < 0) return false;
+    close(sc);
+    if (if_nametoindex(DEVICE) == 0) return false;
+    return true;
+}
+
+#define REQUIRE_VCAN() \
+    if (!vcanAvailable()) { \
+        std::cerr << "[ SKIPPED  ] no " << DEVICE << std::endl; \
+        return; \
+    }
+
+// the other end of the bus, a plain raw socket
+class RawSocket {
+    int sc_;
+public:
+    RawSocket() : sc_(socket(PF_CAN, SOCK_RAW, CAN_RAW)) {
+        struct ifreq ifr;
+        strcpy(ifr.ifr_name, DEVICE);
+        ioctl(sc_, SIOCGIFINDEX, &ifr);
+        struct sockaddr_can addr = {0};
+        addr.can_family = AF_CAN;
+        addr.can_ifindex = ifr.ifr_ifindex;
+        bind(sc_, (struct sockaddr*)&addr, sizeof(addr));
+        timeval timeout = {1, 0};
+        setsockopt(sc_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    }
+    ~RawSocket() { close(sc_); }
+    bool write(const std::string &frame) {
+        const can_frame f = toCanFrame(can::toframe(frame));
+        return ::write(sc_, &f, sizeof(f)) == sizeof(f);
+    }
+    bool write(uint32_t counter) {
+        can::Frame frame = can::toframe("18F02501#");
+        frame.dlc = 4;
+        std::memcpy(frame.data.data(), &counter, sizeof(counter));
+        const can_frame f = toCanFrame(frame);
+        return ::write(sc_, &f, sizeof(f)) == sizeof(f);
+    }
+    bool read(can_frame &f) {
+        return ::read(sc_, &f, sizeof(f)) == sizeof(f);
+    }
+    static can_frame toCanFrame(const can::Frame &frame) {
+        can_frame f = {0};
+        f.can_id = frame.id | (frame.is_extended ? CAN_EFF_FLAG : 0) | (frame.is_rtr ? CAN_RTR_FLAG : 0);
+        f.can_dlc = frame.dlc;
+        std::memcpy(f.data, frame.data.data(), frame.dlc);
+        return f;
+    }
+};
+
+class FrameCollector {
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::vector<can::Frame> frames_;
+public:
+    void handle(const can::Frame &frame) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        frames_.push_back(frame);
+        cond_.notify_all();
+    }
+    std::vector<can::Frame> waitFor(size_t count) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cond_.wait_for(lock, std::chrono::seconds(2), [this, count]{ return frames_.size() >= count; });
+        return frames_;
+    }
+};
+
+uint32_t counterOf(const can::Frame &frame) {
+    uint32_t counter;
+    std::memcpy(&counter, frame.data.data(), sizeof(counter));
+    return counter;
+}
+
+can::SettingsConstSharedPtr receiveSettings(int receive_batch) {
+    std::shared_ptr<can::SettingsMap> settings = can::SettingsMap::create();
+    settings->set("receive_batch", receive_batch);
+    return settings;
+}
+
+// sends in bursts, each burst is queued in the driver socket at once and read in batches
+void checkReceive(int receive_batch) {
+    can::ThreadedSocketCANInterface driver;
+    ASSERT_TRUE(driver.init(DEVICE, false, receiveSettings(receive_batch)));
+    FrameCollector collector;
+    can::FrameListenerConstSharedPtr listener = driver.createMsgListenerM(&collector, &FrameCollector::handle);
+
+    RawSocket raw;
+    const uint32_t bursts = 20, burst = 64;
+    const std::chrono::system_clock::time_point before = std::chrono::system_clock::now();
+    std::vector<can::Frame> frames;
+    for (uint32_t b = 0; b < bursts; ++b) {
+        for (uint32_t i = 0; i < burst; ++i) {
+            ASSERT_TRUE(raw.write(b * burst + i));
+        }
+        frames = collector.waitFor((b + 1) * burst);
+    }
+    const std::chrono::system_clock::time_point after = std::chrono::system_clock::now();
+
+    ASSERT_EQ(bursts * burst, frames.size());
+    for (uint32_t i = 0; i < frames.size(); ++i) {
+        EXPECT_EQ(0x18F02501u, frames[i].id);
+        EXPECT_EQ(i, counterOf(frames[i])) << "out of order";
+        // the kernel receive time, whichever receive path
+        EXPECT_TRUE(frames[i].stamp >= before && frames[i].stamp <= after) << "frame " << i << " not stamped";
+        if (i > 0) {
+            EXPECT_TRUE(frames[i].stamp >= frames[i - 1].stamp);
+        }
+    }
+    driver.shutdown();
+}
+}
+
+TEST(SocketCANVcanTest, receiveOneByOne)
+{
+    REQUIRE_VCAN();
+    checkReceive(1);
+}
+
+TEST(SocketCANVcanTest, receiveBatched)
+{
+    REQUIRE_VCAN();
+    checkReceive(32);
+}
+
+TEST(SocketCANVcanTest, kernelFilters)
+{
+    REQUIRE_VCAN();
+    for (int receive_batch : {1, 32}) {
+        can::ThreadedSocketCANInterface driver;
+        // set before init, applied to the new socket
+        ASSERT_TRUE(driver.setKernelFilters({can::tofilter("123"), can::tofilter("18F02501")}));
+        ASSERT_TRUE(driver.init(DEVICE, false, receiveSettings(receive_batch)));
+        FrameCollector collector;
+        can::FrameListenerConstSharedPtr listener = driver.createMsgListenerM(&collector, &FrameCollector::handle);
+
+        RawSocket raw;
+        for (const char *frame : {"124#01", "123#02", "18F02502#03", "18F02501#04", "123#06"}) {
+            ASSERT_TRUE(raw.write(frame));
+        }
+        std::vector<can::Frame> frames = collector.waitFor(3);
+        // the last one passes, so everything sent before it has been through the kernel
+        ASSERT_EQ(3u, frames.size());
+        EXPECT_EQ("123#02", can::tostring(frames[0], true));
+        EXPECT_EQ("18F02501#04", can::tostring(frames[1], true));
+        EXPECT_EQ("123#06", can::tostring(frames[2], true));
+
+        // changed on the open socket
+        ASSERT_TRUE(driver.setKernelFilters({can::tofilter("124")}));
+        ASSERT_TRUE(raw.write("123#07"));
+        ASSERT_TRUE(raw.write("124#08"));
+        frames = collector.waitFor(4);
+        ASSERT_EQ(4u, frames.size());
+        EXPECT_EQ("124#08", can::tostring(frames[3], true));
+
+        // range filters have no mask form, the kernel drops the old filters and passes everything
+        EXPECT_FALSE(driver.setKernelFilters({can::tofilter("120-125")}));
+        ASSERT_TRUE(raw.write("123#09"));
+        ASSERT_TRUE(raw.write("124#0A"));
+        frames = collector.waitFor(6);
+        ASSERT_EQ(6u, frames.size());
+        EXPECT_EQ("123#09", can::tostring(frames[4], true));
+        EXPECT_EQ("124#0A", can::tostring(frames[5], true));
+        driver.shutdown();
+    }
+}
+
+TEST(SocketCANVcanTest, sendChunkedWithFullBuffer)
+{
+    REQUIRE_VCAN();
+    can::ThreadedSocketCANInterface driver;
+    ASSERT_TRUE(driver.init(DEVICE, false, can::NoSettings::create()));
+    // the smallest send buffer the kernel allows, a few frames, so sendmmsg() runs into EAGAIN
+    int sndbuf = 1;
+    ASSERT_EQ(0, setsockopt(driver.getInternalSocket(), SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf)));
+
+    const uint32_t count = 2000;   // 63 chunks of 32
+    std::vector<can::Frame> frames(count, can::toframe("18F02501#"));
+    for (uint32_t i = 0; i < count; ++i) {
+        frames[i].dlc = 4;
+        std::memcpy(frames[i].data.data(), &i, sizeof(i));
+    }
+
+    RawSocket raw;
+    uint32_t received = 0;
+    bool in_order = true;
+    std::thread reader([&raw, &received, &in_order, count]{
+        can_frame f;
+        while (received < count && raw.read(f)) {
+            uint32_t counter;
+            std::memcpy(&counter, f.data, sizeof(counter));
+            in_order = in_order && counter == received;
+            received++;
+        }
+    });
+    EXPECT_TRUE(driver.send(frames));
+    reader.join();
+
+    EXPECT_EQ(count, received);
+    EXPECT_TRUE(in_order);
+    EXPECT_TRUE(driver.getState().isReady());
+    driver.shutdown();
+}
+
+// Run all the tests that were declared with TEST()
+int main(int argc, char **argv){
+testing::InitGoogleTest(&argc, argv);
+return RUN_ALL_TESTS();
+}
@@ -0,0 +1,180 @@
+/*
+    Formula Student Driverless Project (FSD-Project).
+    Copyright (c) 2019:
+     - chentairan <killasipilin@gmail.com>
+
+    FSD-Project is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FSD-Project is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FSD-Project.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+// Throughput of the in-place NMEA parser against the string based parser it
+// replaced in GPS::serialInfoParse(), on a typical GPCHC sentence.
+//   rosrun gps nmea_parser_benchmark [iterations]
+
+#include "nmea_parser.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+const int GPCHC_FIELDS[] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 21, 23};
+const int GPCHC_FIELD_NUM = sizeof(GPCHC_FIELDS) / sizeof(GPCHC_FIELDS[0]);
+
+std::string makeSentence() {
+  std::string body = "GPCHC,2093,368123.30,254.68,-0.41,0.87,0.01,-0.02,0.03,0.0012,-0.0023,1.0011,"
+                     "40.01234567,116.34567891,52.37,0.012,-0.034,0.001,0.045,12,14,42,0.0,2";
+  unsigned char check_sum = 0;
+  for (size_t i = 0; i < body.size(); i++) {
+    check_sum ^= static_cast<unsigned char>(body[i]);
+  }
+  char tail[8];
+  snprintf(tail, sizeof(tail), "*%02X\r\n", check_sum);
+  return "$" + body + tail;
+}
+
+// The previous implementation: trim, stringstream checksum, substr split, stod
+namespace legacy {
+std::string &trim(std::string &s, std::string e) {
+  if (!s.empty()) {
+    s = s.erase(0, s.find_first_not_of(e));
+    s = s.erase(s.find_last_not_of(e) + 1);
+  } else {
+    return s;
+  }
+  if (!s.empty()) {
+    std::string::size_type i = 0;
+    while ((i = s.find(e)) != std::string::npos) {
+      s.erase(i, 1);
+    }
+  }
+  return s;
+}
+
+bool check(std::string s, std::vector<std::string> &buffer) {
+  buffer.clear();
+  std::stringstream sstream;
+  int check_sum = 0;
+  std::string::size_type pos = 0;
+  std::string::size_type pos_1 = s.find("*");
+  std::string::size_type pos_2 = s.find("$");
+  if (pos_1 == std::string::npos) {
+    return false;
+  }
+  std::string check_value_str = s.substr(pos_1 + 1, 2);
+  std::string ss = s.substr(pos_2 + 1, pos_1 - pos_2 - 1);
+  for (size_t i = 0; i < ss.size(); i++) {
+    check_sum ^= int(ss[i]);
+  }
+  sstream << std::hex << std::setfill('0') << std::setw(2) << check_sum;
+  std::string check_sum_str = sstream.str();
+  std::transform(check_sum_str.begin(), check_sum_str.end(), check_sum_str.begin(), ((int (*)(int))(std::toupper)));
+  if (check_sum_str != check_value_str) {
+    return false;
+  }
+  s = s + ",";
+  while ((pos = s.find(',')) != std::string::npos) {
+    buffer.push_back(s.substr(0, pos));
+    s = s.substr(pos + 1);
+  }
+  return true;
+}
+
+double safeDouble(const std::string &s) {
+  try {
+    return std::stod(s);
+  } catch (...) {
+    return 0;
+  }
+}
+
+bool parse(const std::string &sentence, std::vector<std::string> &buffer, double *values) {
+  std::string s = sentence;
+  s = trim(s, " ");
+  s = trim(s, "+");
+  if (!check(s, buffer)) {
+    return false;
+  }
+  for (int i = 0; i < GPCHC_FIELD_NUM; i++) {
+    values[i] = safeDouble(buffer[GPCHC_FIELDS[i]]);
+  }
+  return true;
+}
+}
+
+bool parseInPlace(const std::string &sentence, ns_gps::NmeaSentenceView &view, double *values) {
+  if (ns_gps::parseNmeaSentence(sentence.data(), sentence.size(), view) != ns_gps::NmeaParseResult::OK) {
+    return false;
+  }
+  for (int i = 0; i < GPCHC_FIELD_NUM; i++) {
+    values[i] = view.getDouble(GPCHC_FIELDS[i]);
+  }
+  return true;
+}
+}
+
+int main(int argc, char **argv) {
+  const int iterations = (argc > 1) ? std::atoi(argv[1]) : 100000;
+  const std::string sentence = makeSentence();
+
+  double legacy_values[GPCHC_FIELD_NUM];
+  double values[GPCHC_FIELD_NUM];
+  std::vector<std::string> buffer;
+  ns_gps::NmeaSentenceView view;
+
+  // both parsers have to agree before their speed is compared
+  if (!legacy::parse(sentence, buffer, legacy_values) || !parseInPlace(sentence, view, values)) {
+    printf("parse failed: %s\n", sentence.c_str());
+    return 1;
+  }
+  for (int i = 0; i < GPCHC_FIELD_NUM; i++) {
+    if (values[i] != legacy_values[i]) {
+      printf("field %d differs: %.17g != %.17g\n", GPCHC_FIELDS[i], values[i], legacy_values[i]);
+      return 1;
+    }
+  }
+
+  // best of several rounds, so a busy machine does not decide the result
+  const int rounds = 5;
+  double legacy_ns = 1e300;
+  double in_place_ns = 1e300;
+  double sink = 0;
+  for (int round = 0; round < rounds; round++) {
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    for (int n = 0; n < iterations; n++) {
+      legacy::parse(sentence, buffer, legacy_values);
+      sink += legacy_values[n % GPCHC_FIELD_NUM];
+    }
+    std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+    for (int n = 0; n < iterations; n++) {
+      parseInPlace(sentence, view, values);
+      sink += values[n % GPCHC_FIELD_NUM];
+    }
+    std::chrono::steady_clock::time_point t3 = std::chrono::steady_clock::now();
+    legacy_ns = std::min(legacy_ns, std::chrono::duration<double, std::nano>(t2 - t1).count() / iterations);
+    in_place_ns = std::min(in_place_ns, std::chrono::duration<double, std::nano>(t3 - t2).count() / iterations);
+  }
+
+  printf("sentence: %s", sentence.c_str());
+  printf("string parser:   %8.1f ns/sentence, %10.0f sentences/s\n", legacy_ns, 1e9 / legacy_ns);
+  printf("in-place parser: %8.1f ns/sentence, %10.0f sentences/s\n", in_place_ns, 1e9 / in_place_ns);
+  printf("speedup: %.1fx (checksum %g)\n", legacy_ns / in_place_ns, sink);
+  return 0;
+}
@@ -7,7 +7,9 @@
 #include "nmea_msgs/Sentence.h"
 #include "nav_msgs/Odometry.h"
 #include "common_msgs/GpsInfo.h"
+#include "nmea_parser.hpp"
 #include <cmath>
+#include <cstdint>
 
 #include <sstream>
 #include <string>
@@ -17,6 +19,13 @@
 
 namespace ns_gps {
 
+// Parts of the gps state filled in by the sentences of the current epoch
+const uint32_t GPS_FIELD_POSITION = 1 << 0;
+const uint32_t GPS_FIELD_VELOCITY = 1 << 1;
+const uint32_t GPS_FIELD_HEADING  = 1 << 2;
+const uint32_t GPS_FIELD_ATTITUDE = 1 << 3;
+const uint32_t GPS_FIELD_IMU      = 1 << 4;
+
 struct Para{
   std::string protocol_name;
   bool record_to_file;
@@ -30,10 +39,14 @@ class GPS {
   GPS(ros::NodeHandle &nh);
 
   // Getters
-  common_msgs::GpsInfo getGpsState();
+  const common_msgs::GpsInfo &getGpsState() const;
+  uint32_t getEpochFields() const;
 
   // Setters
-  void setSerialInfo(nmea_msgs::Sentence msg);
+  // Decodes the sentence right away, so that no sentence of an epoch is lost.
+  // Returns true if the sentence was decoded into the gps state, false for
+  // sentences without valid data, which leave the stamp of the state alone.
+  bool setSerialInfo(const nmea_msgs::Sentence &msg);
   void setGpsParameters(Para msg);
 
   // Methods
@@ -44,22 +57,51 @@ class GPS {
 
   ros::NodeHandle &nh_;
 
-  nmea_msgs::Sentence serial_info;
   common_msgs::GpsInfo gps_state;
   Para gps_para;
-  std::vector<std::string> gps_buffer;
-
-  void serialInfoParse();
-  bool serialInfoCheck(std::string s);
-
-  void parseGPGGA(std::string s);
-  void parseGPRMC(std::string s);
-  void parseGPCHC(std::string s);
+  // fields of the last sentence, pointing into the received message
+  NmeaSentenceView nmea_sentence;
+
+  // Epoch fusion: every sentence carrying the same time of fix (or no time
+  // at all, like VTG/HDT) writes its fields into the same gps_state
+  bool epoch_flag = false;
+  double epoch_time = 0;
+  // receive time of the first sentence of the epoch, gps_state takes it once a sentence decodes valid data
+  ros::Time epoch_stamp;
+  uint32_t epoch_fields = 0;
+  double east_vel = 0;
+  double north_vel = 0;
+  double heading = 0;
+  // once a true heading (HDT/CHC) is seen the course over ground is no longer used as heading
+  bool true_heading_flag = false;
+
+  // One entry per supported sentence formatter, the talker id (GP, GN, ...) is ignored
+  struct SentenceDecoder {
+    const char *type;
+    int min_fields;
+    int time_field;     // -1 if the sentence carries no time of fix
+    bool time_hhmmss;   // utc hhmmss.ss instead of plain seconds
+    // false if the sentence holds no valid data, e.g. GGA without fix
+    bool (GPS::*parse)(const NmeaSentenceView &s);
+  };
+  static const SentenceDecoder SENTENCE_DECODERS[];
+
+  bool serialInfoParse(const std::string &sentence, const ros::Time &stamp);
+  void beginEpoch(const SentenceDecoder &decoder, const NmeaSentenceView &s, const ros::Time &stamp);
+  void setCourseVelocity(double speed, double course);
+  void setHeading(double heading_deg);
+  void updateTwist();
+
+  bool parseGPGGA(const NmeaSentenceView &s);
+  bool parseGPRMC(const NmeaSentenceView &s);
+  bool parseGPVTG(const NmeaSentenceView &s);
+  bool parseGPHDT(const NmeaSentenceView &s);
+  bool parseGPCHC(const NmeaSentenceView &s);
 
   double deg2rad (double deg);
-  double safe_double(const std::string& s);
-  int safe_int(const std::string& s);
-  std::string &trim(std::string &s, std::string e); // clear the string e in string s
+  double safe_double(const NmeaSentenceView &s, int idx);
+  double safe_coordinate(const NmeaSentenceView &s, int idx);
+  int safe_int(const NmeaSentenceView &s, int idx);
   void write2File(std::string filename);
 };
 }
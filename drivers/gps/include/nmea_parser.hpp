@@ -0,0 +1,52 @@
+#ifndef NMEA_PARSER_HPP
+#define NMEA_PARSER_HPP
+
+#include <cstddef>
+
+namespace ns_gps {
+
+const int MAX_NMEA_FIELDS = 64;
+
+// Non-owning piece of a sentence, the C++11 stand-in for std::string_view
+struct NmeaField {
+  const char *data;
+  size_t size;
+
+  bool empty() const { return size == 0; }
+  bool equals(const char *s) const;
+};
+
+/*
+  Fields of one "$<address>,<f1>,...,<fn>*<checksum>" sentence. The fields point
+  into the parsed buffer, which has to outlive the view. fields[0] is the
+  address, e.g. "GPCHC", the checksum is not part of the last field.
+*/
+struct NmeaSentenceView {
+  NmeaField fields[MAX_NMEA_FIELDS];
+  int field_num;
+
+  // Sentence formatter, the last three characters of the address, e.g. "CHC"
+  NmeaField getType() const;
+  // Empty and malformed fields read as 0 and set ok to false
+  double getDouble(int idx, bool *ok = nullptr) const;
+  int getInt(int idx, bool *ok = nullptr) const;
+};
+
+enum class NmeaParseResult {
+  OK,
+  NO_START,         // no '$'
+  NO_CHECKSUM,      // no '*' followed by two hex digits
+  BAD_CHECKSUM,
+  TOO_MANY_FIELDS
+};
+
+// Single pass over the buffer: checksum and field split, no allocation
+NmeaParseResult parseNmeaSentence(const char *data, size_t size, NmeaSentenceView &view);
+const char *getNmeaParseError(NmeaParseResult result);
+
+// Locale independent number parsing without allocation, false if the field is not a number
+bool parseNmeaDouble(const NmeaField &field, double &value);
+bool parseNmeaInt(const NmeaField &field, int &value);
+}
+
+#endif //NMEA_PARSER_HPP
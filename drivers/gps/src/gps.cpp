@@ -2,17 +2,37 @@
 #include "gps.hpp"
 #include <sstream>
 
+namespace {
+const double KNOT_TO_MPS = 1852.0 / 3600.0;
+const double KMH_TO_MPS = 1.0 / 3.6;
+// below this speed the course over ground is too noisy to stand in for the heading
+const double MIN_COURSE_SPEED = 1.0;
+}
+
 namespace ns_gps {
+
+const GPS::SentenceDecoder GPS::SENTENCE_DECODERS[] = {
+  // type, min fields, time field, hhmmss, parser
+  {"GGA", 10, 1, true,  &GPS::parseGPGGA},
+  {"RMC", 9,  1, true,  &GPS::parseGPRMC},
+  {"VTG", 8,  -1, false, &GPS::parseGPVTG},
+  {"HDT", 2,  -1, false, &GPS::parseGPHDT},
+  {"CHC", 24, 2, false, &GPS::parseGPCHC},
+};
+
 // Constructor
 GPS::GPS(ros::NodeHandle &nh) : nh_(nh) {
-
+  gps_state.header.frame_id = "world";
 };
 // Getters
-common_msgs::GpsInfo GPS::getGpsState() {return gps_state;}
+const common_msgs::GpsInfo &GPS::getGpsState() const {return gps_state;}
+uint32_t GPS::getEpochFields() const {return epoch_fields;}
 
 // Setters
-void GPS::setSerialInfo(nmea_msgs::Sentence msg){
-  serial_info = msg;
+bool GPS::setSerialInfo(const nmea_msgs::Sentence &msg){
+  serialInfoFlag = true;
+  // stamped at receipt by serial_com, fall back to now for sources that do not stamp
+  return serialInfoParse(msg.sentence, msg.header.stamp.isZero() ? ros::Time::now() : msg.header.stamp);
 }
 void GPS::setGpsParameters(Para msg){
   gps_para = msg;
@@ -20,112 +40,197 @@ void GPS::setGpsParameters(Para msg){
 
 // Methods
 void GPS::runAlgorithm() {
-  if (serialInfoFlag){
-    serialInfoParse();
-  }
-  else{
+  if (!serialInfoFlag){
    ROS_WARN("Waiting for serial info...");
   }
 }
 
-void GPS::serialInfoParse(){
-  // Trim and check the serial data
-  std::string s = serial_info.sentence;
-  s = trim(s," ");
-  s = trim(s,"+");
-  
-  if (!serialInfoCheck(s)){
-    ROS_WARN_STREAM("GPS info check failed!");
+bool GPS::serialInfoParse(const std::string &sentence, const ros::Time &stamp){
+  // Check and split the serial data in place
+  NmeaParseResult result = parseNmeaSentence(sentence.data(), sentence.size(), nmea_sentence);
+  if (result != NmeaParseResult::OK){
+    ROS_WARN_STREAM("GPS info check failed: " << getNmeaParseError(result));
+    return false;
+  }
+
+  // protocol_name restricts the decoder to one sentence type, ALL fuses every supported one
+  NmeaField type = nmea_sentence.getType();
+  const std::string &protocol = gps_para.protocol_name;
+  if (protocol != "ALL" && (protocol.size() < 3 || !type.equals(protocol.c_str() + protocol.size() - 3))){
+    ROS_WARN_STREAM_THROTTLE(1, "Protocol received is " << std::string(type.data, type.size));
+    return false;
   }
 
-  // Parse serial info according to the protocol type
-  std::string protocol_recv = s.substr(3,3);
-  if (gps_para.protocol_name == "GPGGA"){
-      if (!(protocol_recv=="GGA")){
-        ROS_WARN_STREAM("Protocol received is "<<protocol_recv);
-      } else {
-        parseGPGGA(s);
-      }
+  for (const SentenceDecoder &decoder : SENTENCE_DECODERS){
+    if (!type.equals(decoder.type)){
+      continue;
+    }
+    if (nmea_sentence.field_num < decoder.min_fields){
+      ROS_WARN("GP%s sentence too short: %d fields.", decoder.type, nmea_sentence.field_num);
+      return false;
     }
-  else{
-    if (gps_para.protocol_name == "GPRMC"){
-      if (!(protocol_recv=="RMC")){
-        ROS_WARN_STREAM("Protocol received is "<<protocol_recv);
-      } else {
-        parseGPRMC(s);
-      }
+    beginEpoch(decoder, nmea_sentence, stamp);
+    uint32_t fields = epoch_fields;
+    if (!(this->*decoder.parse)(nmea_sentence)){
+      // the state still holds the data of an earlier sentence, it keeps that stamp
+      return false;
     }
-    else{
-      if (gps_para.protocol_name == "GPCHC"){
-        if (!(protocol_recv=="CHC")){
-          ROS_WARN_STREAM("Protocol received is "<<protocol_recv);
-        } else {
-          parseGPCHC(s);
-        }
-      }
-      else{
-        ROS_WARN_STREAM("Wrong protocol name: " << gps_para.protocol_name << " !");
-      }
+    gps_state.header.stamp = epoch_stamp;
+
+    if (gps_para.record_to_file && !(fields & GPS_FIELD_POSITION) && (epoch_fields & GPS_FIELD_POSITION)){
+      write2File(gps_para.filename);
     }
+    return true;
+  }
+  ROS_WARN_STREAM_THROTTLE(1, "Unsupported sentence: " << std::string(type.data, type.size));
+  return false;
+}
+
+void GPS::beginEpoch(const SentenceDecoder &decoder, const NmeaSentenceView &s, const ros::Time &stamp){
+  if (decoder.time_field < 0){
+    return;
+  }
+  bool ok;
+  double time = s.getDouble(decoder.time_field, &ok);
+  if (!ok){
+    return;
+  }
+  if (decoder.time_hhmmss){
+    double hours = std::floor(time / 10000);
+    double minutes = std::floor((time - hours * 10000) / 100);
+    time = hours * 3600 + minutes * 60 + (time - hours * 10000 - minutes * 100);
+  }
+  // fields of the previous epoch stay in gps_state until overwritten
+  if (!epoch_flag || time != epoch_time){
+    epoch_flag = true;
+    epoch_time = time;
+    epoch_fields = 0;
+    epoch_stamp = stamp;
+  }
+}
+
+void GPS::setCourseVelocity(double speed, double course){
+  east_vel = speed * sin(course * M_PI / 180.0);
+  north_vel = speed * cos(course * M_PI / 180.0);
+  epoch_fields |= GPS_FIELD_VELOCITY;
+  if (!true_heading_flag && speed > MIN_COURSE_SPEED){
+    heading = course;
+    gps_state.rpy.z = 90 - heading;
+    epoch_fields |= GPS_FIELD_HEADING;
+  }
+  updateTwist();
+}
+
+void GPS::setHeading(double heading_deg){
+  true_heading_flag = true;
+  heading = heading_deg;
+  gps_state.rpy.z = 90 - heading;
+  epoch_fields |= GPS_FIELD_HEADING;
+  updateTwist();
+}
+
+void GPS::updateTwist(){
+  // velocity in the vehicle frame
+  double yaw = heading * M_PI / 180.0;
+  gps_state.twist.linear.x = east_vel * sin(yaw) + north_vel * cos(yaw);
+  gps_state.twist.linear.y = east_vel * cos(yaw) - north_vel * sin(yaw);
+}
+
+bool GPS::parseGPGGA(const NmeaSentenceView &s){
+  int quality = safe_int(s, 6);
+  if (quality == 0){
+    // no position for this epoch, the last one is not republished as new
+    gps_state.fix.status.status = sensor_msgs::NavSatStatus::STATUS_NO_FIX;
+    return false;
   }
+  // 1 gps, 2 dgps, 4 rtk fixed, 5 rtk float
+  if (quality == 4 || quality == 5){
+    gps_state.fix.status.status = sensor_msgs::NavSatStatus::STATUS_GBAS_FIX;
+  } else if (quality == 2){
+    gps_state.fix.status.status = sensor_msgs::NavSatStatus::STATUS_SBAS_FIX;
+  } else {
+    gps_state.fix.status.status = sensor_msgs::NavSatStatus::STATUS_FIX;
+  }
+  gps_state.fix.latitude  = safe_coordinate(s, 2);
+  gps_state.fix.longitude = safe_coordinate(s, 4);
+  gps_state.fix.altitude  = safe_double(s, 9);
+  epoch_fields |= GPS_FIELD_POSITION;
+  return true;
 }
 
-void GPS::parseGPGGA(std::string s){
-  //TODO: supplement GPGGA parse
+bool GPS::parseGPRMC(const NmeaSentenceView &s){
+  if (!s.fields[2].equals("A")){
+    // V: navigation receiver warning, position and velocity are not valid
+    return false;
+  }
+  // GGA carries the altitude and fix quality, RMC only fills in a missing position
+  if (!(epoch_fields & GPS_FIELD_POSITION)){
+    gps_state.fix.latitude  = safe_coordinate(s, 3);
+    gps_state.fix.longitude = safe_coordinate(s, 5);
+    epoch_fields |= GPS_FIELD_POSITION;
+  }
+  if (!s.fields[7].empty()){
+    setCourseVelocity(safe_double(s, 7) * KNOT_TO_MPS, s.getDouble(8));
+  }
+  return true;
+}
+
+bool GPS::parseGPVTG(const NmeaSentenceView &s){
+  // the course is empty while standing still
+  if (!s.fields[7].empty()){
+    setCourseVelocity(safe_double(s, 7) * KMH_TO_MPS, s.getDouble(1));
+  } else if (!s.fields[5].empty()){
+    setCourseVelocity(safe_double(s, 5) * KNOT_TO_MPS, s.getDouble(1));
+  } else {
+    return false;
+  }
+  return true;
 }
 
-void GPS::parseGPRMC(std::string s){
-  //TODO: supplement GPRMC parse
+bool GPS::parseGPHDT(const NmeaSentenceView &s){
+  if (s.fields[1].empty()){
+    // no heading solution
+    return false;
+  }
+  setHeading(safe_double(s, 1));
+  return true;
 }
 
-void GPS::parseGPCHC(std::string s){
+bool GPS::parseGPCHC(const NmeaSentenceView &s){
   //ROS_INFO("GPCHC parse");
-  // header
-  gps_state.header.frame_id = "world";
-  gps_state.header.stamp = ros::Time::now();
   // fix
-  gps_state.fix.latitude  = safe_double(gps_buffer[12]);
-  gps_state.fix.longitude = safe_double(gps_buffer[13]);
-  gps_state.fix.altitude  = safe_double(gps_buffer[14]);
+  gps_state.fix.latitude  = safe_double(s, 12);
+  gps_state.fix.longitude = safe_double(s, 13);
+  gps_state.fix.altitude  = safe_double(s, 14);
   // ROS_INFO("current lat: %lf, lon: %lf",gps_state.fix.latitude,gps_state.fix.longitude);
   // rpy deg
-  double roll = safe_double(gps_buffer[5]);
-  double pitch = safe_double(gps_buffer[4]);
-  double yaw = safe_double(gps_buffer[3]);
-  gps_state.rpy.x = roll;
-  gps_state.rpy.y = pitch;
-  gps_state.rpy.z = 90 - yaw;
+  gps_state.rpy.x = safe_double(s, 5);
+  gps_state.rpy.y = safe_double(s, 4);
   // twist m/s
-  double east_vel = safe_double(gps_buffer[15]);// east velocity
-  double north_vel = safe_double(gps_buffer[16]);// north velocity
-  gps_state.twist.linear.x  = east_vel * sin(yaw*M_PI/180.0) + north_vel * cos(yaw*M_PI/180.0); 
-  gps_state.twist.linear.y  = east_vel * cos(yaw*M_PI/180.0) - north_vel * sin(yaw*M_PI/180.0); 
-  gps_state.twist.linear.z  = safe_double(gps_buffer[17]);
-  gps_state.twist.angular.x = safe_double(gps_buffer[6]);
-  gps_state.twist.angular.y = safe_double(gps_buffer[7]);
-  gps_state.twist.angular.z = safe_double(gps_buffer[8]);
+  east_vel = safe_double(s, 15);// east velocity
+  north_vel = safe_double(s, 16);// north velocity
+  setHeading(safe_double(s, 3));
+  gps_state.twist.linear.z  = safe_double(s, 17);
+  gps_state.twist.angular.x = safe_double(s, 6);
+  gps_state.twist.angular.y = safe_double(s, 7);
+  gps_state.twist.angular.z = safe_double(s, 8);
   // acc
-  gps_state.acc.x = safe_double(gps_buffer[9]);
-  gps_state.acc.y = safe_double(gps_buffer[10]);
-  gps_state.acc.z = safe_double(gps_buffer[11]);
+  gps_state.acc.x = safe_double(s, 9);
+  gps_state.acc.y = safe_double(s, 10);
+  gps_state.acc.z = safe_double(s, 11);
+  epoch_fields |= GPS_FIELD_POSITION | GPS_FIELD_VELOCITY | GPS_FIELD_ATTITUDE | GPS_FIELD_IMU;
   // status
-  int gps_status = safe_int(gps_buffer[21]);
+  int gps_status = safe_int(s, 21);
   int gps_sys_status = gps_status % 10;
   int gps_sat_status = gps_status / 10;
 
-  if (gps_para.record_to_file){
-    // ROS_INFO("recording...");
-    // ROS_INFO_STREAM("filename:" << gps_para.filename);
-    write2File(gps_para.filename);
-  }
-
   if (gps_sys_status == 2 && gps_sat_status == 4){
     // working correctly
   }else{
     ROS_WARN("GPS system status: %d, satellite status: %d.",gps_sys_status,gps_sat_status);
   }
   // warning
-  int warning = safe_int(gps_buffer[23]);
+  int warning = safe_int(s, 23);
   if ((GET_BIT(warning,0))==1){
     // No gps message
     ROS_WARN("No GPS message!");
@@ -143,103 +248,36 @@ void GPS::parseGPCHC(std::string s){
     ROS_WARN("No acc message!");
   }
   //ROS_INFO("GPCHC parse end");
+  return true;
 }
 
-std::string& GPS::trim(std::string &s, std::string e){
-  // delete the string in the front and rear
-  if (!s.empty()){
-    s = s.erase(0, s.find_first_not_of(e));
-    s = s.erase(s.find_last_not_of(e) + 1);
-  }
-  else{
-    return s;
-  }
-  // delete the string inside of the string
-  if (!s.empty()){
-    std::string::size_type i = 0;
-    while ((i = s.find(e)) != std::string::npos){
-      s.erase(i,1);
-    }
-  }
-  else{
-    return s;
+int GPS::safe_int(const NmeaSentenceView &s, int idx) {
+  bool ok;
+  int result = s.getInt(idx, &ok);
+  if (!ok) {
+    ROS_WARN_STREAM("wrong in stoi() no sentence data in field " << idx);
   }
-  return s; 
+  return result;
 }
 
-bool GPS::serialInfoCheck(std::string s){
-  gps_buffer.clear();
-
-	std::stringstream sstream;
-	std::string check_value_str;
-	std::string check_sum_str;
-	int check_sum = 0;
-	std::string ss;
-	std::string sp_1 = "*";
-	std::string sp_2 = "$";
-	std::string sp_3 = ",";
-	std::string::size_type pos = 0;
-	std::string::size_type pos_1 = s.find(sp_1);
-	std::string::size_type pos_2 = s.find(sp_2);
-	
-  // modify sentence no $ *
-	if (pos_1 != std::string::npos) {
-		check_value_str = s.substr(pos_1 + 1, 2);
-		ss = s.substr(pos_2 + 1, pos_1 - pos_2 - 1);
-	}
-	else
-	{
-		ROS_WARN_STREAM("[GPS parse] No * found in sentence data_check()");	
-		return false;
-	}
-	// Check the sum of the serial info
-	for (int i = 0; i < ss.size(); i++) {
-		check_sum ^= int(ss[i]);
-	}
-	sstream << std::hex << std::setfill('0') << std::setw(2) << check_sum;
-	check_sum_str = sstream.str();
-	std::transform(check_sum_str.begin(), check_sum_str.end(), check_sum_str.begin(), ((int(*)(int)) (std::toupper)) );// std::toupper in <cctype> use int(*)(int) form
-	if (check_sum_str == check_value_str) {
-    s = s + ",";
-		// split sentence into a vector
-		while ((pos = s.find(',')) != std::string::npos){
-      gps_buffer.push_back(s.substr(0, pos));
-      s = s.substr(pos + 1);
-		}
-		return true;
-	}
-	else
-	{
-		ROS_WARN_STREAM("[GPS parse] Check wrong");
-		return false;
-	}
-}
-
-int GPS::safe_int(const std::string &s) {
-	int result;
-	try {
-		result = std::stoi(s);
-		return result;
-	}
-	catch (...) {
-		result = 0;
-		ROS_WARN_STREAM("wrong in stoi() no sentence data");
-		return result;
-	}
-
+double GPS::safe_double(const NmeaSentenceView &s, int idx) {
+  bool ok;
+  double result = s.getDouble(idx, &ok);
+  if (!ok) {
+    ROS_WARN_STREAM("wrong in stod() no sentence data in field " << idx);
+  }
+  return result;
 }
 
-double GPS::safe_double(const std::string& s) {
-	double result;
-	try {
-		result = std::stod(s);
-		return result;
-	}
-	catch (...) {
-		result = 0;
-		ROS_WARN_STREAM("wrong in stod() no sentence data");
-		return result;
-	}
+// ddmm.mmmm in field idx, hemisphere N/S or E/W in field idx + 1
+double GPS::safe_coordinate(const NmeaSentenceView &s, int idx) {
+  double value = safe_double(s, idx);
+  double degrees = std::floor(value / 100);
+  degrees += (value - degrees * 100) / 60.0;
+  if (s.fields[idx + 1].equals("S") || s.fields[idx + 1].equals("W")) {
+    degrees = -degrees;
+  }
+  return degrees;
 }
 
 double GPS::deg2rad (double deg) {
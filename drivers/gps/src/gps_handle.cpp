@@ -50,7 +50,7 @@ void GPSHandle::loadParameters() {
 void GPSHandle::subscribeToTopics() {
   ROS_INFO("subscribe to topics");
   serialInfoSubscriber_ =
-      nodeHandle_.subscribe(serial_info_topic_name_, 1, &GPSHandle::serialInfoCallback, this);
+      nodeHandle_.subscribe(serial_info_topic_name_, 32, &GPSHandle::serialInfoCallback, this);
 }
 
 void GPSHandle::publishToTopics() {
@@ -69,7 +69,6 @@ void GPSHandle::sendMsg() {
 }
 
 void GPSHandle::serialInfoCallback(const nmea_msgs::Sentence &msg) {
-  gps_.serialInfoFlag = true;
   gps_.setSerialInfo(msg);
 }
 }
@@ -0,0 +1,285 @@
+/*
+    Formula Student Driverless Project (FSD-Project).
+    Copyright (c) 2019:
+     - chentairan <killasipilin@gmail.com>
+
+    FSD-Project is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FSD-Project is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FSD-Project.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "nmea_parser.hpp"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace ns_gps {
+
+namespace {
+// powers of ten that are exact doubles
+const double POW10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+// largest mantissa that converts to double exactly, 2^53
+const uint64_t MAX_EXACT_MANTISSA = 9007199254740992ULL;
+
+int hexValue(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  return -1;
+}
+
+const uint64_t COMMA_BYTES = 0x2C2C2C2C2C2C2C2CULL;
+const uint64_t LOW_7_BITS = 0x7F7F7F7F7F7F7F7FULL;
+
+bool addField(NmeaSentenceView &view, const char *begin, const char *end) {
+  if (view.field_num == MAX_NMEA_FIELDS) {
+    return false;
+  }
+  view.fields[view.field_num].data = begin;
+  view.fields[view.field_num].size = end - begin;
+  view.field_num += 1;
+  return true;
+}
+
+bool isBlank(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// strtod over all of a terminated copy, out of range values are no number, as for std::stod
+bool parseTerminatedDouble(const char *s, size_t size, double &value) {
+  char *end;
+  errno = 0;
+  value = std::strtod(s, &end);
+  return end == s + size && errno != ERANGE;
+}
+
+// Slow path for numbers the fast path cannot round exactly, copies to the stack for strtod
+bool parseDoubleFallback(const char *p, size_t size, double &value) {
+  char buffer[64];
+  if (size >= sizeof(buffer)) {
+    // no NMEA number is that long, but it still reads like strtod
+    std::string copy(p, size);
+    return parseTerminatedDouble(copy.c_str(), size, value);
+  }
+  std::memcpy(buffer, p, size);
+  buffer[size] = '\0';
+  return parseTerminatedDouble(buffer, size, value);
+}
+}
+
+bool NmeaField::equals(const char *s) const {
+  size_t n = std::strlen(s);
+  return n == size && std::memcmp(data, s, n) == 0;
+}
+
+NmeaField NmeaSentenceView::getType() const {
+  NmeaField type = {"", 0};
+  if (field_num > 0 && fields[0].size >= 3) {
+    type.data = fields[0].data + fields[0].size - 3;
+    type.size = 3;
+  }
+  return type;
+}
+
+double NmeaSentenceView::getDouble(int idx, bool *ok) const {
+  double value = 0;
+  bool parsed = idx >= 0 && idx < field_num && parseNmeaDouble(fields[idx], value);
+  if (ok != nullptr) {
+    *ok = parsed;
+  }
+  return parsed ? value : 0.0;
+}
+
+int NmeaSentenceView::getInt(int idx, bool *ok) const {
+  int value = 0;
+  bool parsed = idx >= 0 && idx < field_num && parseNmeaInt(fields[idx], value);
+  if (ok != nullptr) {
+    *ok = parsed;
+  }
+  return parsed ? value : 0;
+}
+
+NmeaParseResult parseNmeaSentence(const char *data, size_t size, NmeaSentenceView &view) {
+  view.field_num = 0;
+  const char *p = static_cast<const char *>(std::memchr(data, '$', size));
+  if (p == nullptr) {
+    return NmeaParseResult::NO_START;
+  }
+  const char *end = data + size;
+  p += 1;
+  const char *star = static_cast<const char *>(std::memchr(p, '*', end - p));
+  if (star == nullptr || end - star < 3) {
+    return NmeaParseResult::NO_CHECKSUM;
+  }
+  int high = hexValue(star[1]);
+  int low = hexValue(star[2]);
+  if (high < 0 || low < 0) {
+    return NmeaParseResult::NO_CHECKSUM;
+  }
+
+  // one pass, eight bytes at a time: xor of every character between '$' and '*'
+  // for the checksum, and a mask of the ',' bytes to split the fields
+  uint64_t check_word = 0;
+  const char *field_begin = p;
+  const char *q = p;
+  for (; star - q >= 8; q += 8) {
+    uint64_t word;
+    std::memcpy(&word, q, sizeof(word));
+    check_word ^= word;
+    uint64_t commas = word ^ COMMA_BYTES;
+    commas = ~(((commas & LOW_7_BITS) + LOW_7_BITS) | commas | LOW_7_BITS);
+    while (commas != 0) {
+      // little endian, the lowest byte comes first in the sentence
+      const char *comma = q + (__builtin_ctzll(commas) >> 3);
+      if (!addField(view, field_begin, comma)) {
+        return NmeaParseResult::TOO_MANY_FIELDS;
+      }
+      field_begin = comma + 1;
+      commas &= commas - 1;
+    }
+  }
+  check_word ^= check_word >> 32;
+  check_word ^= check_word >> 16;
+  check_word ^= check_word >> 8;
+  unsigned char check_sum = static_cast<unsigned char>(check_word);
+  for (; q < star; q++) {
+    check_sum ^= static_cast<unsigned char>(*q);
+    if (*q == ',') {
+      if (!addField(view, field_begin, q)) {
+        return NmeaParseResult::TOO_MANY_FIELDS;
+      }
+      field_begin = q + 1;
+    }
+  }
+  if (!addField(view, field_begin, star)) {
+    return NmeaParseResult::TOO_MANY_FIELDS;
+  }
+  if (check_sum != ((high << 4) | low)) {
+    return NmeaParseResult::BAD_CHECKSUM;
+  }
+  return NmeaParseResult::OK;
+}
+
+const char *getNmeaParseError(NmeaParseResult result) {
+  switch (result) {
+    case NmeaParseResult::OK:
+      return "ok";
+    case NmeaParseResult::NO_START:
+      return "no $ found in sentence";
+    case NmeaParseResult::NO_CHECKSUM:
+      return "no * checksum found in sentence";
+    case NmeaParseResult::BAD_CHECKSUM:
+      return "checksum wrong";
+    case NmeaParseResult::TOO_MANY_FIELDS:
+      return "too many fields";
+  }
+  return "unknown";
+}
+
+bool parseNmeaDouble(const NmeaField &field, double &value) {
+  const char *p = field.data;
+  const char *end = field.data + field.size;
+  while (p < end && isBlank(*p)) {
+    p++;
+  }
+  // trimmed before the slow path too, strtod would stop at a trailing blank
+  while (end > p && isBlank(end[-1])) {
+    end--;
+  }
+  if (p == end) {
+    return false;
+  }
+  const char *begin = p;
+
+  bool negative = false;
+  if (*p == '+' || *p == '-') {
+    negative = (*p == '-');
+    p++;
+  }
+  // decimal digits as an integer mantissa and a power of ten
+  uint64_t mantissa = 0;
+  const char *digits_begin = p;
+  for (; p < end && static_cast<unsigned int>(*p - '0') < 10; p++) {
+    mantissa = mantissa * 10 + (*p - '0');
+  }
+  int digit_num = static_cast<int>(p - digits_begin);
+  int fraction_digits = 0;
+  if (p < end && *p == '.') {
+    const char *fraction_begin = ++p;
+    for (; p < end && static_cast<unsigned int>(*p - '0') < 10; p++) {
+      mantissa = mantissa * 10 + (*p - '0');
+    }
+    fraction_digits = static_cast<int>(p - fraction_begin);
+    digit_num += fraction_digits;
+  }
+  if (digit_num == 0) {
+    return false;
+  }
+  // exponents, long mantissas and anything unusual take the slow path
+  if (p != end || digit_num > 19 || mantissa > MAX_EXACT_MANTISSA || fraction_digits > 22) {
+    return parseDoubleFallback(begin, end - begin, value);
+  }
+  // both operands are exact, so the division is correctly rounded like strtod
+  value = static_cast<double>(mantissa) / POW10[fraction_digits];
+  if (negative) {
+    value = -value;
+  }
+  return true;
+}
+
+bool parseNmeaInt(const NmeaField &field, int &value) {
+  const char *p = field.data;
+  const char *end = field.data + field.size;
+  while (p < end && isBlank(*p)) {
+    p++;
+  }
+  while (end > p && isBlank(end[-1])) {
+    end--;
+  }
+  bool negative = false;
+  if (p < end && (*p == '+' || *p == '-')) {
+    negative = (*p == '-');
+    p++;
+  }
+  if (p == end) {
+    return false;
+  }
+  const char *digits_begin = p;
+  int64_t result = 0;
+  for (; p < end && *p >= '0' && *p <= '9'; p++) {
+    result = result * 10 + (*p - '0');
+    if (result > 2147483648LL) {
+      return false;
+    }
+  }
+  // like stoi, trailing characters after the digits are ignored
+  if (p == digits_begin) {
+    return false;
+  }
+  result = negative ? -result : result;
+  if (result > 2147483647LL) {
+    return false;
+  }
+  value = static_cast<int>(result);
+  return true;
+}
+}
@@ -0,0 +1,200 @@
+/*
+    Formula Student Driverless Project (FSD-Project).
+    Copyright (c) 2019:
+     - chentairan <killasipilin@gmail.com>
+
+    FSD-Project is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FSD-Project is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FSD-Project.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <gtest/gtest.h>
+#include <ros/ros.h>
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+
+#include "gps.hpp"
+
+namespace ns_gps {
+
+namespace {
+const double KNOT = 1852.0 / 3600.0;
+
+std::string withChecksum(const std::string &body) {
+  unsigned char check_sum = 0;
+  for (char c : body) {
+    check_sum ^= static_cast<unsigned char>(c);
+  }
+  char suffix[8];
+  snprintf(suffix, sizeof(suffix), "*%02X\r\n", check_sum);
+  return "$" + body + suffix;
+}
+
+class GpsTest : public ::testing::Test {
+ protected:
+  ros::NodeHandle nh;
+  GPS gps;
+
+  GpsTest() : gps(nh) {
+    setProtocol("ALL");
+  }
+  void setProtocol(const std::string &protocol) {
+    Para para;
+    para.protocol_name = protocol;
+    para.record_to_file = false;
+    gps.setGpsParameters(para);
+  }
+  // received at stamp seconds
+  bool feed(const std::string &body, double stamp) {
+    nmea_msgs::Sentence msg;
+    msg.header.stamp = ros::Time(stamp);
+    msg.sentence = withChecksum(body);
+    return gps.setSerialInfo(msg);
+  }
+  const common_msgs::GpsInfo &state() const { return gps.getGpsState(); }
+};
+}
+
+TEST_F(GpsTest, gga) {
+  ASSERT_TRUE(feed("GPGGA,092750.000,5321.6802,N,00630.3372,W,1,8,1.03,61.7,M,55.2,M,,", 10.0));
+  ASSERT_NEAR(53.0 + 21.6802 / 60.0, state().fix.latitude, 1e-9);
+  ASSERT_NEAR(-(6.0 + 30.3372 / 60.0), state().fix.longitude, 1e-9);
+  ASSERT_DOUBLE_EQ(61.7, state().fix.altitude);
+  ASSERT_EQ(sensor_msgs::NavSatStatus::STATUS_FIX, state().fix.status.status);
+  ASSERT_EQ(GPS_FIELD_POSITION, gps.getEpochFields());
+  ASSERT_DOUBLE_EQ(10.0, state().header.stamp.toSec());
+
+  // southern and eastern hemisphere, rtk and dgps quality
+  ASSERT_TRUE(feed("GNGGA,092751.000,3351.3000,S,15112.6000,E,4,20,0.6,40.0,M,20.0,M,1.0,0000", 11.0));
+  ASSERT_NEAR(-(33.0 + 51.3 / 60.0), state().fix.latitude, 1e-9);
+  ASSERT_NEAR(151.0 + 12.6 / 60.0, state().fix.longitude, 1e-9);
+  ASSERT_EQ(sensor_msgs::NavSatStatus::STATUS_GBAS_FIX, state().fix.status.status);
+  ASSERT_TRUE(feed("GNGGA,092752.000,3351.3000,S,15112.6000,E,2,20,0.6,40.0,M,20.0,M,1.0,0000", 12.0));
+  ASSERT_EQ(sensor_msgs::NavSatStatus::STATUS_SBAS_FIX, state().fix.status.status);
+}
+
+TEST_F(GpsTest, ggaWithoutFix) {
+  ASSERT_TRUE(feed("GPGGA,092750.000,5321.6802,N,00630.3372,W,1,8,1.03,61.7,M,55.2,M,,", 10.0));
+  const double latitude = state().fix.latitude;
+
+  // the next epoch has no fix: the old position is not stamped as new
+  ASSERT_FALSE(feed("GPGGA,092751.000,,,,,0,0,,,M,,M,,", 11.0));
+  ASSERT_EQ(sensor_msgs::NavSatStatus::STATUS_NO_FIX, state().fix.status.status);
+  ASSERT_DOUBLE_EQ(10.0, state().header.stamp.toSec());
+  ASSERT_DOUBLE_EQ(latitude, state().fix.latitude);
+  ASSERT_EQ(0u, gps.getEpochFields() & GPS_FIELD_POSITION);
+
+  // RMC of the same epoch without a valid position either
+  ASSERT_FALSE(feed("GPRMC,092751.000,V,,,,,,,280511,,,N", 11.0));
+  ASSERT_DOUBLE_EQ(10.0, state().header.stamp.toSec());
+
+  // the fix is back
+  ASSERT_TRUE(feed("GPGGA,092752.000,5321.6900,N,00630.3372,W,1,8,1.03,61.7,M,55.2,M,,", 12.0));
+  ASSERT_DOUBLE_EQ(12.0, state().header.stamp.toSec());
+  ASSERT_NEAR(53.0 + 21.69 / 60.0, state().fix.latitude, 1e-9);
+}
+
+TEST_F(GpsTest, rmc) {
+  ASSERT_TRUE(feed("GPRMC,092750.000,A,5321.6802,N,00630.3372,W,10.0,45.0,280511,,,A", 10.0));
+  ASSERT_NEAR(53.0 + 21.6802 / 60.0, state().fix.latitude, 1e-9);
+  ASSERT_NEAR(-(6.0 + 30.3372 / 60.0), state().fix.longitude, 1e-9);
+  ASSERT_EQ(GPS_FIELD_POSITION | GPS_FIELD_VELOCITY | GPS_FIELD_HEADING, gps.getEpochFields());
+  // the course over ground stands in for the heading, all of the speed is forward
+  ASSERT_NEAR(45.0, state().rpy.z, 1e-9);
+  ASSERT_NEAR(10.0 * KNOT, state().twist.linear.x, 1e-9);
+  ASSERT_NEAR(0.0, state().twist.linear.y, 1e-9);
+
+  // too slow for a course: velocity, but the heading is kept
+  ASSERT_TRUE(feed("GPRMC,092751.000,A,5321.6802,N,00630.3372,W,1.0,270.0,280511,,,A", 11.0));
+  ASSERT_EQ(GPS_FIELD_POSITION | GPS_FIELD_VELOCITY, gps.getEpochFields());
+  ASSERT_NEAR(45.0, state().rpy.z, 1e-9);
+}
+
+TEST_F(GpsTest, vtg) {
+  // km/h first
+  ASSERT_TRUE(feed("GPVTG,90.0,T,,M,5.0,N,36.0,K,A", 10.0));
+  ASSERT_NEAR(0.0, state().rpy.z, 1e-9);
+  ASSERT_NEAR(10.0, state().twist.linear.x, 1e-9);
+  ASSERT_NEAR(0.0, state().twist.linear.y, 1e-9);
+  // knots if there is no km/h speed
+  ASSERT_TRUE(feed("GPVTG,0.0,T,,M,5.0,N,,K,A", 11.0));
+  ASSERT_NEAR(90.0, state().rpy.z, 1e-9);
+  ASSERT_NEAR(5.0 * KNOT, state().twist.linear.x, 1e-9);
+  // no speed at all
+  ASSERT_FALSE(feed("GPVTG,,T,,M,,N,,K,N", 12.0));
+}
+
+TEST_F(GpsTest, hdt) {
+  ASSERT_TRUE(feed("GPHDT,180.0,T", 10.0));
+  ASSERT_NEAR(-90.0, state().rpy.z, 1e-9);
+  ASSERT_EQ(GPS_FIELD_HEADING, gps.getEpochFields() & GPS_FIELD_HEADING);
+  ASSERT_FALSE(feed("GPHDT,,T", 10.1));
+
+  // with a true heading the course no longer moves it, the velocity is turned into the vehicle frame
+  ASSERT_TRUE(feed("GPVTG,90.0,T,,M,,N,36.0,K,A", 10.2));
+  ASSERT_NEAR(-90.0, state().rpy.z, 1e-9);
+  ASSERT_NEAR(0.0, state().twist.linear.x, 1e-9);
+  ASSERT_NEAR(-10.0, state().twist.linear.y, 1e-9);
+}
+
+TEST_F(GpsTest, epochFusion) {
+  // one epoch: GGA, RMC and VTG received one after another
+  ASSERT_TRUE(feed("GPGGA,092750.000,5321.6802,N,00630.3372,W,4,8,1.03,61.7,M,55.2,M,,", 10.00));
+  ASSERT_TRUE(feed("GPRMC,092750.000,A,5321.6900,N,00630.3300,W,10.0,45.0,280511,,,A", 10.02));
+  ASSERT_TRUE(feed("GPVTG,45.0,T,,M,10.0,N,18.52,K,A", 10.04));
+  ASSERT_EQ(GPS_FIELD_POSITION | GPS_FIELD_VELOCITY | GPS_FIELD_HEADING, gps.getEpochFields());
+  // GGA keeps the position, RMC does not overwrite it
+  ASSERT_NEAR(53.0 + 21.6802 / 60.0, state().fix.latitude, 1e-9);
+  ASSERT_DOUBLE_EQ(61.7, state().fix.altitude);
+  ASSERT_EQ(sensor_msgs::NavSatStatus::STATUS_GBAS_FIX, state().fix.status.status);
+  // stamped with the receipt of the first sentence of the epoch
+  ASSERT_DOUBLE_EQ(10.0, state().header.stamp.toSec());
+  ASSERT_NEAR(18.52 / 3.6, state().twist.linear.x, 1e-9);
+
+  // RMC starting the next epoch fills in the position
+  ASSERT_TRUE(feed("GPRMC,092751.000,A,5321.6900,N,00630.3300,W,10.0,45.0,280511,,,A", 11.00));
+  ASSERT_NEAR(53.0 + 21.69 / 60.0, state().fix.latitude, 1e-9);
+  ASSERT_DOUBLE_EQ(11.0, state().header.stamp.toSec());
+  // a GGA of that epoch then overwrites it
+  ASSERT_TRUE(feed("GPGGA,092751.000,5321.6802,N,00630.3372,W,4,8,1.03,61.7,M,55.2,M,,", 11.02));
+  ASSERT_NEAR(53.0 + 21.6802 / 60.0, state().fix.latitude, 1e-9);
+  ASSERT_DOUBLE_EQ(11.0, state().header.stamp.toSec());
+  // the time of fix wraps at midnight, a new epoch all the same
+  ASSERT_TRUE(feed("GPGGA,000000.000,5321.6802,N,00630.3372,W,4,8,1.03,61.7,M,55.2,M,,", 12.0));
+  ASSERT_EQ(GPS_FIELD_POSITION, gps.getEpochFields());
+  ASSERT_DOUBLE_EQ(12.0, state().header.stamp.toSec());
+}
+
+TEST_F(GpsTest, rejectedSentences) {
+  // wrong checksum
+  nmea_msgs::Sentence msg;
+  msg.header.stamp = ros::Time(10.0);
+  msg.sentence = "$GPHDT,180.0,T*00\r\n";
+  ASSERT_FALSE(gps.setSerialInfo(msg));
+  // too short for its type
+  ASSERT_FALSE(feed("GPGGA,092750.000,5321.6802,N", 10.0));
+  // unsupported
+  ASSERT_FALSE(feed("GPGSV,3,1,11,03,03,111,00", 10.0));
+  // one protocol only
+  setProtocol("GPGGA");
+  ASSERT_FALSE(feed("GPHDT,180.0,T", 10.0));
+  ASSERT_TRUE(feed("GNGGA,092750.000,5321.6802,N,00630.3372,W,1,8,1.03,61.7,M,55.2,M,,", 10.0));
+}
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  ros::init(argc, argv, "TestNode");
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,289 @@
+/*
+    Formula Student Driverless Project (FSD-Project).
+    Copyright (c) 2019:
+     - chentairan <killasipilin@gmail.com>
+
+    FSD-Project is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FSD-Project is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FSD-Project.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <gtest/gtest.h>
+#include <ros/ros.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "nmea_parser.hpp"
+
+namespace ns_gps {
+
+namespace {
+std::string withChecksum(const std::string &body) {
+  unsigned char check_sum = 0;
+  for (char c : body) {
+    check_sum ^= static_cast<unsigned char>(c);
+  }
+  char suffix[8];
+  snprintf(suffix, sizeof(suffix), "*%02X\r\n", check_sum);
+  return "$" + body + suffix;
+}
+
+NmeaParseResult parse(const std::string &sentence, NmeaSentenceView &view) {
+  return parseNmeaSentence(sentence.data(), sentence.size(), view);
+}
+
+std::string toString(const NmeaField &field) {
+  return std::string(field.data, field.size);
+}
+
+NmeaField toField(const std::string &s) {
+  NmeaField field = {s.data(), s.size()};
+  return field;
+}
+
+// what std::stod makes of the whole field, false if it does not read all of it
+bool referenceDouble(const std::string &s, double &value) {
+  size_t begin = s.find_first_not_of(" \t\r\n");
+  size_t end = s.find_last_not_of(" \t\r\n");
+  if (begin == std::string::npos) {
+    return false;
+  }
+  std::string trimmed = s.substr(begin, end - begin + 1);
+  try {
+    size_t pos;
+    value = std::stod(trimmed, &pos);
+    return pos == trimmed.size();
+  } catch (const std::exception &) {
+    return false;
+  }
+}
+
+bool referenceInt(const std::string &s, int &value) {
+  try {
+    value = std::stoi(s);
+    return true;
+  } catch (const std::exception &) {
+    return false;
+  }
+}
+
+std::string randomString(std::mt19937 &rng, const std::string &alphabet, size_t max_size) {
+  std::uniform_int_distribution<size_t> size(0, max_size);
+  std::uniform_int_distribution<size_t> pick(0, alphabet.size() - 1);
+  std::string s(size(rng), ' ');
+  for (char &c : s) {
+    c = alphabet[pick(rng)];
+  }
+  return s;
+}
+}
+
+TEST(NmeaParser, sentence) {
+  std::string sentence = "$GPGGA,092750.000,5321.6802,N,00630.3372,W,1,8,1.03,61.7,M,55.2,M,,*76\r\n";
+  NmeaSentenceView view;
+  ASSERT_EQ(NmeaParseResult::OK, parse(sentence, view));
+  ASSERT_EQ(15, view.field_num);
+  ASSERT_EQ("GPGGA", toString(view.fields[0]));
+  ASSERT_TRUE(view.getType().equals("GGA"));
+  ASSERT_EQ("092750.000", toString(view.fields[1]));
+  ASSERT_EQ("W", toString(view.fields[5]));
+  ASSERT_TRUE(view.fields[13].empty());
+  // the checksum is not part of the last field
+  ASSERT_TRUE(view.fields[14].empty());
+  ASSERT_DOUBLE_EQ(5321.6802, view.getDouble(2));
+  ASSERT_EQ(8, view.getInt(7));
+
+  // anything before the '$' is skipped, lower case checksums are accepted
+  ASSERT_EQ(NmeaParseResult::OK, parse("xx" + withChecksum("GPHDT,274.07,T"), view));
+  ASSERT_EQ(3, view.field_num);
+  ASSERT_EQ(NmeaParseResult::OK, parse("$GPHDT,274.08,T*0c", view));
+}
+
+TEST(NmeaParser, checksumFailures) {
+  NmeaSentenceView view;
+  std::string sentence = withChecksum("GPHDT,274.07,T");
+  ASSERT_EQ(NmeaParseResult::OK, parse(sentence, view));
+
+  // one changed character anywhere between '$' and '*'
+  for (size_t i = 1; i < sentence.find('*'); i++) {
+    std::string changed = sentence;
+    changed[i] ^= 0x01;
+    ASSERT_EQ(NmeaParseResult::BAD_CHECKSUM, parse(changed, view)) << changed;
+  }
+  ASSERT_EQ(NmeaParseResult::NO_START, parse("GPHDT,274.07,T*0A", view));
+  ASSERT_EQ(NmeaParseResult::NO_CHECKSUM, parse("$GPHDT,274.07,T", view));
+  ASSERT_EQ(NmeaParseResult::NO_CHECKSUM, parse("$GPHDT,274.07,T*0", view));
+  ASSERT_EQ(NmeaParseResult::NO_CHECKSUM, parse("$GPHDT,274.07,T*G0", view));
+  ASSERT_EQ(NmeaParseResult::NO_START, parse("", view));
+  ASSERT_STREQ("checksum wrong", getNmeaParseError(NmeaParseResult::BAD_CHECKSUM));
+}
+
+TEST(NmeaParser, emptyFields) {
+  NmeaSentenceView view;
+  ASSERT_EQ(NmeaParseResult::OK, parse(withChecksum("GPRMC,,,,,,,,,,,"), view));
+  ASSERT_EQ(12, view.field_num);
+  for (int i = 1; i < view.field_num; i++) {
+    ASSERT_TRUE(view.fields[i].empty());
+    bool ok = true;
+    ASSERT_DOUBLE_EQ(0.0, view.getDouble(i, &ok));
+    ASSERT_FALSE(ok);
+    ok = true;
+    ASSERT_EQ(0, view.getInt(i, &ok));
+    ASSERT_FALSE(ok);
+  }
+  // indices past the sentence read as empty
+  bool ok = true;
+  ASSERT_DOUBLE_EQ(0.0, view.getDouble(12, &ok));
+  ASSERT_FALSE(ok);
+  ASSERT_EQ(0, view.getInt(-1, &ok));
+  ASSERT_FALSE(ok);
+
+  ASSERT_EQ(NmeaParseResult::OK, parse(withChecksum(""), view));
+  ASSERT_EQ(1, view.field_num);
+  ASSERT_TRUE(view.getType().empty());
+}
+
+TEST(NmeaParser, fieldCountOverflow) {
+  NmeaSentenceView view;
+  std::string body = "GPXXX";
+  for (int i = 1; i < MAX_NMEA_FIELDS; i++) {
+    body += "," + std::to_string(i);
+  }
+  ASSERT_EQ(NmeaParseResult::OK, parse(withChecksum(body), view));
+  ASSERT_EQ(MAX_NMEA_FIELDS, view.field_num);
+  ASSERT_EQ(MAX_NMEA_FIELDS - 1, view.getInt(MAX_NMEA_FIELDS - 1));
+  ASSERT_EQ(NmeaParseResult::TOO_MANY_FIELDS, parse(withChecksum(body + ",64"), view));
+  // found by the eight byte scan as well as by the tail loop
+  ASSERT_EQ(NmeaParseResult::TOO_MANY_FIELDS, parse(withChecksum(body + std::string(20, ',')), view));
+}
+
+// the eight byte scan against a plain split, at every alignment of the sentence
+TEST(NmeaParser, fuzzedSplit) {
+  std::mt19937 rng(1);
+  for (int n = 0; n < 20000; n++) {
+    std::string body = randomString(rng, "GPA,,,.0123456789-", 90);
+    std::vector<std::string> expected(1);
+    for (char c : body) {
+      if (c == ',') {
+        expected.push_back("");
+      } else {
+        expected.back() += c;
+      }
+    }
+    std::string sentence = std::string(n % 16, 'x') + withChecksum(body);
+    NmeaSentenceView view;
+    NmeaParseResult result = parse(sentence, view);
+    if (expected.size() > static_cast<size_t>(MAX_NMEA_FIELDS)) {
+      ASSERT_EQ(NmeaParseResult::TOO_MANY_FIELDS, result) << sentence;
+      continue;
+    }
+    ASSERT_EQ(NmeaParseResult::OK, result) << sentence;
+    ASSERT_EQ(expected.size(), static_cast<size_t>(view.field_num)) << sentence;
+    for (size_t i = 0; i < expected.size(); i++) {
+      ASSERT_EQ(expected[i], toString(view.fields[i])) << sentence;
+    }
+  }
+}
+
+TEST(NmeaParser, doubleEdgeCases) {
+  struct Case {
+    const char *field;
+    bool ok;
+    double value;
+  };
+  const Case cases[] = {
+      {"12.5", true, 12.5}, {"-12.5", true, -12.5}, {"+12.5", true, 12.5}, {"12", true, 12.0},
+      {"12.", true, 12.0}, {".5", true, 0.5}, {"-.5", true, -0.5}, {"0", true, 0.0},
+      {" 4.25 ", true, 4.25}, {"1e3", true, 1000.0}, {"1e3 ", true, 1000.0}, {"-2.5E-1", true, -0.25},
+      {"5321.68020000000000000000001", true, 5321.6802}, {"12345678901234567890", true, 12345678901234567890.0},
+      {"", false, 0}, {" ", false, 0}, {".", false, 0}, {"-", false, 0}, {"+-1", false, 0},
+      {"1.2.3", false, 0}, {"12a", false, 0}, {"a12", false, 0}, {"1 2", false, 0}, {"e5", false, 0},
+      {"nan", false, 0}, {"inf", false, 0}, {"1e400", false, 0},
+  };
+  for (const Case &c : cases) {
+    double value = -1;
+    ASSERT_EQ(c.ok, parseNmeaDouble(toField(c.field), value)) << c.field;
+    if (c.ok) {
+      ASSERT_DOUBLE_EQ(c.value, value) << c.field;
+    }
+  }
+  // longer than the stack copy of the slow path
+  std::string zeros = "1." + std::string(80, '0') + "1";
+  double value = 0;
+  ASSERT_TRUE(parseNmeaDouble(toField(zeros), value));
+  ASSERT_DOUBLE_EQ(1.0, value);
+}
+
+TEST(NmeaParser, intEdgeCases) {
+  struct Case {
+    const char *field;
+    bool ok;
+    int value;
+  };
+  const Case cases[] = {
+      {"8", true, 8}, {"-8", true, -8}, {"+8", true, 8}, {" 42 ", true, 42}, {"007", true, 7},
+      {"2147483647", true, 2147483647}, {"-2147483648", true, -2147483647 - 1},
+      // like stoi, what follows the digits is ignored
+      {"12.5", true, 12}, {"3abc", true, 3},
+      {"", false, 0}, {" ", false, 0}, {"-", false, 0}, {"+", false, 0}, {"abc", false, 0}, {".5", false, 0},
+      {"2147483648", false, 0}, {"-2147483649", false, 0}, {"99999999999999999999", false, 0},
+  };
+  for (const Case &c : cases) {
+    int value = -1;
+    ASSERT_EQ(c.ok, parseNmeaInt(toField(c.field), value)) << c.field;
+    if (c.ok) {
+      ASSERT_EQ(c.value, value) << c.field;
+    }
+  }
+}
+
+TEST(NmeaParser, fuzzedNumbers) {
+  std::mt19937 rng(2);
+  std::uniform_real_distribution<double> coordinate(-18000.0, 18000.0);
+  std::uniform_int_distribution<int> decimals(0, 12);
+  for (int n = 0; n < 200000; n++) {
+    std::string s;
+    if (n % 2 == 0) {
+      // well formed fields as receivers print them
+      char buffer[64];
+      snprintf(buffer, sizeof(buffer), "%.*f", decimals(rng), coordinate(rng));
+      s = buffer;
+    } else {
+      s = randomString(rng, "0123456789012345678901234567890123456789..--+eE ", 24);
+    }
+    double value = 0, expected_value = 0;
+    bool expected = referenceDouble(s, expected_value);
+    ASSERT_EQ(expected, parseNmeaDouble(toField(s), value)) << "\"" << s << "\"";
+    if (expected) {
+      // correctly rounded, bit for bit
+      ASSERT_EQ(expected_value, value) << "\"" << s << "\"";
+    }
+    int int_value = 0, expected_int = 0;
+    bool int_expected = referenceInt(s, expected_int);
+    ASSERT_EQ(int_expected, parseNmeaInt(toField(s), int_value)) << "\"" << s << "\"";
+    if (int_expected) {
+      ASSERT_EQ(expected_int, int_value) << "\"" << s << "\"";
+    }
+  }
+}
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  ros::init(argc, argv, "TestNode");
+  return RUN_ALL_TESTS();
+}
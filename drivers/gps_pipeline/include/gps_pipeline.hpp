@@ -0,0 +1,60 @@
+#ifndef GPS_PIPELINE_HPP
+#define GPS_PIPELINE_HPP
+
+#include "serial_com.hpp"
+#include "gps.hpp"
+#include "localization_adapter.hpp"
+
+#include <functional>
+
+namespace ns_gps_pipeline {
+
+// Called on the serial reader thread after every decoded sentence
+typedef std::function<void(const common_msgs::GpsInfo &, const nav_msgs::Odometry &)> PoseCallback;
+
+/*
+  serial_com -> gps -> localization_adapter in one process. Each sentence
+  is handed by reference from the serial reader thread through the gps
+  decoder to the utm conversion, without serialisation and without waiting
+  for a timer tick.
+*/
+class GpsPipeline {
+
+ public:
+  // Constructor
+  GpsPipeline(ros::NodeHandle &nh);
+  ~GpsPipeline();
+
+  // Getters
+  const common_msgs::GpsInfo &getGpsState() const;
+  const nav_msgs::Odometry &getUTMPose() const;
+  ns_serial_com::SerialStats takeStats();
+
+  // Setters
+  void setSerialParameters(const ns_serial_com::Para &msg);
+  void setGpsParameters(const ns_gps::Para &msg);
+  void setGpsOrigin(const utm::Gps_point &msg);
+  void setGpsPara(const utm::Gps_para &msg);
+  void setLocalFrame(const std::string &msg);
+
+  // Methods
+  void startReading(const PoseCallback &callback);
+  void stopReading();
+  // Returns true if the sentence updated the utm pose
+  bool processSentence(const nmea_msgs::Sentence &msg);
+
+ private:
+
+  ros::NodeHandle &nh_;
+
+  ns_serial_com::SerialCom serial_com;
+  ns_gps::GPS gps;
+  ns_localization_adapter::Localization_adapter localization_adapter;
+
+  PoseCallback pose_callback;
+
+  void serialInfoCallback(const nmea_msgs::Sentence &msg);
+};
+}
+
+#endif //GPS_PIPELINE_HPP
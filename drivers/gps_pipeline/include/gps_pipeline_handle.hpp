@@ -0,0 +1,47 @@
+#ifndef GPS_PIPELINE_HANDLE_HPP
+#define GPS_PIPELINE_HANDLE_HPP
+
+#include "gps_pipeline.hpp"
+
+namespace ns_gps_pipeline {
+
+class GpsPipelineHandle {
+
+ public:
+  // Constructor
+  GpsPipelineHandle(ros::NodeHandle &nodeHandle);
+
+  // Getters
+  int getNodeRate() const;
+
+  // Methods
+  void loadParameters();
+  void subscribeToTopics();
+  void publishToTopics();
+  void run();
+
+ private:
+  ros::NodeHandle nodeHandle_;
+  ros::Publisher gpsStatePublisher_;
+  ros::Publisher utmPosePublisher_;
+
+  void poseCallback(const common_msgs::GpsInfo &gps_state, const nav_msgs::Odometry &utm_pose);
+
+  std::string gps_state_topic_name_;
+  std::string localization_utm_topic_name_;
+  bool publish_gps_state_;
+  std::string local_frame_;
+
+  int node_rate_;
+  ros::Time last_report_time_;
+
+  GpsPipeline gps_pipeline_;
+  ns_serial_com::Para serial_para_;
+  ns_gps::Para gps_para_;
+  utm::Gps_point origin_;
+  utm::Gps_para range_;
+
+};
+}
+
+#endif //GPS_PIPELINE_HANDLE_HPP
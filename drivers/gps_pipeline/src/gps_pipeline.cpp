@@ -0,0 +1,65 @@
+#include <ros/ros.h>
+#include "gps_pipeline.hpp"
+
+namespace ns_gps_pipeline {
+// Constructor
+GpsPipeline::GpsPipeline(ros::NodeHandle &nh) : nh_(nh),
+    serial_com(nh),
+    gps(nh),
+    localization_adapter(nh) {
+  localization_adapter.setRunMode("real_car");
+};
+
+GpsPipeline::~GpsPipeline() {
+  // the reader thread calls into gps and localization_adapter
+  stopReading();
+}
+
+// Getters
+const common_msgs::GpsInfo &GpsPipeline::getGpsState() const { return gps.getGpsState(); }
+const nav_msgs::Odometry &GpsPipeline::getUTMPose() const { return localization_adapter.getUTMPose(); }
+ns_serial_com::SerialStats GpsPipeline::takeStats() { return serial_com.takeStats(); }
+
+// Setters
+void GpsPipeline::setSerialParameters(const ns_serial_com::Para &msg) {
+  serial_com.setSerialParameters(msg);
+}
+void GpsPipeline::setGpsParameters(const ns_gps::Para &msg) {
+  gps.setGpsParameters(msg);
+}
+void GpsPipeline::setGpsOrigin(const utm::Gps_point &msg) {
+  localization_adapter.setGpsOrigin(msg);
+}
+void GpsPipeline::setGpsPara(const utm::Gps_para &msg) {
+  localization_adapter.setGpsPara(msg);
+}
+void GpsPipeline::setLocalFrame(const std::string &msg) {
+  localization_adapter.setLocalFrame(msg);
+}
+
+// Methods
+void GpsPipeline::startReading(const PoseCallback &callback) {
+  pose_callback = callback;
+  serial_com.initializeSerial();
+  serial_com.startReading(std::bind(&GpsPipeline::serialInfoCallback, this, std::placeholders::_1));
+}
+
+void GpsPipeline::stopReading() {
+  serial_com.stopReading();
+}
+
+bool GpsPipeline::processSentence(const nmea_msgs::Sentence &msg) {
+  if (!gps.setSerialInfo(msg)) {
+    return false;
+  }
+  localization_adapter.updateGpsPose(gps.getGpsState());
+  return true;
+}
+
+void GpsPipeline::serialInfoCallback(const nmea_msgs::Sentence &msg) {
+  if (processSentence(msg) && pose_callback) {
+    pose_callback(gps.getGpsState(), localization_adapter.getUTMPose());
+  }
+}
+
+}
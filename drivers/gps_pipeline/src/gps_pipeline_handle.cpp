@@ -0,0 +1,103 @@
+#include <ros/ros.h>
+#include "gps_pipeline_handle.hpp"
+#include "register.h"
+#include <functional>
+
+namespace ns_gps_pipeline {
+
+// Constructor
+GpsPipelineHandle::GpsPipelineHandle(ros::NodeHandle &nodeHandle) :
+    nodeHandle_(nodeHandle),
+    gps_pipeline_(nodeHandle) {
+  ROS_INFO("Constructing Handle");
+  last_report_time_ = ros::Time::now();
+  loadParameters();
+  gps_pipeline_.setSerialParameters(serial_para_);
+  gps_pipeline_.setGpsParameters(gps_para_);
+  gps_pipeline_.setGpsOrigin(origin_);
+  gps_pipeline_.setGpsPara(range_);
+  gps_pipeline_.setLocalFrame(local_frame_);
+  subscribeToTopics();
+  publishToTopics();
+  gps_pipeline_.startReading(std::bind(&GpsPipelineHandle::poseCallback, this,
+                                       std::placeholders::_1, std::placeholders::_2));
+}
+
+// Getters
+int GpsPipelineHandle::getNodeRate() const { return node_rate_; }
+
+// Methods
+void GpsPipelineHandle::loadParameters() {
+  ROS_INFO("loading handle parameters");
+  if (!nodeHandle_.param<std::string>("gps_state_topic_name",
+                                      gps_state_topic_name_,
+                                      "/drivers/gps")) {
+    ROS_WARN_STREAM("Did not load gps_state_topic_name. Standard value is: " << gps_state_topic_name_);
+  }
+  if (!nodeHandle_.param<std::string>("localization_utm_topic_name",
+                                      localization_utm_topic_name_,
+                                      "/localization/utmpose")) {
+    ROS_WARN_STREAM("Did not load localization_utm_topic_name. Standard value is: " << localization_utm_topic_name_);
+  }
+  if (!nodeHandle_.param("node_rate", node_rate_, 1)) {
+    ROS_WARN_STREAM("Did not load node_rate. Standard value is: " << node_rate_);
+  }
+  nodeHandle_.param<bool>("publish_gps_state", publish_gps_state_, true);
+
+  // serial_com
+  nodeHandle_.param("baud", serial_para_.baud, 115200);
+  nodeHandle_.param<std::string>("port", serial_para_.port, "ttyTHS2");
+  ROS_INFO_STREAM("[Serial Parameters] port: " << serial_para_.port
+                << ", baud: " << serial_para_.baud);
+
+  // gps
+  nodeHandle_.param<std::string>("protocol_name", gps_para_.protocol_name, "GPCHC");
+  ROS_INFO_STREAM("[GPS parameters] protocol_name: " << gps_para_.protocol_name);
+  nodeHandle_.param<bool>("record_to_file", gps_para_.record_to_file, false);
+  nodeHandle_.param<std::string>("record_filename", gps_para_.filename, "~/log/gps.csv");
+
+  // localization_adapter
+  nodeHandle_.param<std::string>("local_frame", local_frame_, "utm");
+  nodeHandle_.param<double>("Gps_origin/x", origin_.x, 274083.3651381);
+  nodeHandle_.param<double>("Gps_origin/y", origin_.y, 4006502.509805);
+  nodeHandle_.param<double>("Gps_origin/z", origin_.z, 74.80);
+  ROS_INFO_STREAM("Gps origin: x: " << origin_.x << ", y: " << origin_.y << ", z: " << origin_.z);
+  nodeHandle_.param<double>("Gps_range/lat_min", range_.lat_min, 30);
+  nodeHandle_.param<double>("Gps_range/lat_max", range_.lat_max, 50);
+  nodeHandle_.param<double>("Gps_range/lon_min", range_.lon_min, 100);
+  nodeHandle_.param<double>("Gps_range/lon_max", range_.lon_max, 120);
+}
+
+void GpsPipelineHandle::subscribeToTopics() {// No topics to subscribe, sentences come from the serial reader
+}
+
+void GpsPipelineHandle::publishToTopics() {
+  ROS_INFO("publish to topics");
+  gpsStatePublisher_ = nodeHandle_.advertise<common_msgs::GpsInfo>(gps_state_topic_name_, 32);
+  utmPosePublisher_ = nodeHandle_.advertise<nav_msgs::Odometry>(localization_utm_topic_name_, 32);
+}
+
+void GpsPipelineHandle::run() {
+  // Report the serial byte to utm pose latency once per second
+  ros::Time now = ros::Time::now();
+  if ((now - last_report_time_).toSec() < 1.0) {
+    return;
+  }
+  last_report_time_ = now;
+  ns_serial_com::SerialStats stats = gps_pipeline_.takeStats();
+  if (stats.sentences == 0) {
+    ROS_WARN("No serial sentence received.");
+    return;
+  }
+  ROS_INFO("GPS pipeline: %lu sentences, %lu dropped, receive to utm pose latency mean %.3f ms, max %.3f ms.",
+           (unsigned long)stats.sentences, (unsigned long)stats.dropped,
+           stats.latency_sum / stats.sentences * 1e3, stats.latency_max * 1e3);
+}
+
+void GpsPipelineHandle::poseCallback(const common_msgs::GpsInfo &gps_state, const nav_msgs::Odometry &utm_pose) {
+  utmPosePublisher_.publish(utm_pose);
+  if (publish_gps_state_) {
+    gpsStatePublisher_.publish(gps_state);
+  }
+}
+}
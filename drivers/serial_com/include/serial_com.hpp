@@ -5,6 +5,12 @@
 #include "nmea_msgs/Sentence.h"
 #include "serial/serial.h"
 
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
 namespace ns_serial_com {
 
 struct Para{
@@ -12,29 +18,59 @@ struct Para{
   std::string port;
 };
 
+// Counters since the last takeStats()
+struct SerialStats{
+  uint64_t sentences = 0;
+  uint64_t dropped = 0;       // lines longer than MAX_SENTENCE_LENGTH
+  uint64_t bytes = 0;
+  double latency_sum = 0;     // receipt to callback return [s]
+  double latency_max = 0;
+};
+
+typedef std::function<void(const nmea_msgs::Sentence &)> SentenceCallback;
+
 class SerialCom {
 
  public:
   // Constructor
   SerialCom(ros::NodeHandle &nh);
+  ~SerialCom();
 
   // Getters
-  nmea_msgs::Sentence getSerialInfo();
+  SerialStats takeStats();
 
   // Setters
   void setSerialParameters(const Para &msg);
 
   // Methods
-  void runAlgorithm();
   void initializeSerial();
+  // Reads the port on a dedicated thread and calls callback for every
+  // sentence as soon as its line ending arrives, stamped at receipt
+  void startReading(const SentenceCallback &callback);
+  void stopReading();
 
  private:
 
   ros::NodeHandle &nh_;
   Para serial_para;
   serial::Serial sp;
+
+  std::thread reader_thread;
+  std::atomic<bool> reading;
+  SentenceCallback sentence_callback;
+
+  // line being framed, only touched by the reader thread
+  std::string line;
+  bool line_overflow = false;
   nmea_msgs::Sentence sentence;
-  std::string &trim(std::string &s);
+
+  std::mutex stats_mutex;
+  SerialStats stats;
+
+  void openSerial();
+  void readLoop();
+  void frameBytes(const uint8_t *data, size_t size, const ros::Time &stamp);
+  void publishLine(const ros::Time &stamp);
 };
 }
 
@@ -19,7 +19,7 @@ class SerialComHandle {
   void subscribeToTopics();
   void publishToTopics();
   void run();
-  void sendMsg();
+  void serialInfoCallback(const nmea_msgs::Sentence &msg);
 
 
  private:
@@ -29,6 +29,7 @@ class SerialComHandle {
   std::string serial_info_topic_name_;
 
   int node_rate_;
+  ros::Time last_report_time_;
 
   SerialCom serial_com_;
   Para serial_para_;
@@ -1,15 +1,37 @@
 #include <ros/ros.h>
 #include "serial_com.hpp"
 #include <sstream>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace {
+// select() timeout of the reader thread, bounds how long stopReading() waits
+const uint32_t READ_TIMEOUT_MS = 100;
+const size_t READ_BUFFER_SIZE = 4096;
+// longer lines are line noise, not NMEA sentences
+const size_t MAX_SENTENCE_LENGTH = 1024;
+const std::chrono::milliseconds REOPEN_PERIOD(1000);
+}
 
 namespace ns_serial_com {
 // Constructor
-SerialCom::SerialCom(ros::NodeHandle &nh) : nh_(nh) {
-
+SerialCom::SerialCom(ros::NodeHandle &nh) : nh_(nh), reading(false) {
+  line.reserve(MAX_SENTENCE_LENGTH);
+  sentence.header.frame_id = "/drivers/serial_info";
 };
 
+SerialCom::~SerialCom() {
+  stopReading();
+}
+
 // Getters
-nmea_msgs::Sentence SerialCom::getSerialInfo(){return sentence;}
+SerialStats SerialCom::takeStats(){
+  std::lock_guard<std::mutex> lock(stats_mutex);
+  SerialStats result = stats;
+  stats = SerialStats();
+  return result;
+}
 
 // Setters
 void SerialCom::setSerialParameters(const Para &msg){
@@ -19,11 +41,21 @@ void SerialCom::setSerialParameters(const Para &msg){
 // Methods
 void SerialCom::initializeSerial(){
   // Parameters initialization
-  serial::Timeout to = serial::Timeout::simpleTimeout(1000);
+  serial::Timeout to = serial::Timeout::simpleTimeout(READ_TIMEOUT_MS);
   sp.setPort(serial_para.port);
   sp.setBaudrate(serial_para.baud);
   sp.setTimeout(to);
 
+  openSerial();
+  if(sp.isOpen()){
+    ROS_INFO("Serial initialized success!");
+  }
+  else{
+    ROS_WARN("Serial initialization failed, not open!");
+  }
+}
+
+void SerialCom::openSerial(){
   // Check the serial port
   try{
     sp.open();
@@ -31,54 +63,92 @@ void SerialCom::initializeSerial(){
   catch(serial::IOException &e){
     ROS_WARN_STREAM("Fail to open serial!");
   }
+}
 
-  if(sp.isOpen()){
-    ROS_INFO("Serial initialized success!");
-  }
-  else{
-    ROS_WARN("Serial initialization failed, not open!");
+void SerialCom::startReading(const SentenceCallback &callback){
+  stopReading();
+  sentence_callback = callback;
+  reading = true;
+  reader_thread = std::thread(&SerialCom::readLoop, this);
+}
+
+void SerialCom::stopReading(){
+  reading = false;
+  if (reader_thread.joinable()){
+    reader_thread.join();
   }
 }
 
-void SerialCom::runAlgorithm() {
-  if(sp.isOpen()){
-    // Read serial data
-    std::string data;
-    data = sp.readline();
-    data = trim(data);
+void SerialCom::readLoop(){
+  std::vector<uint8_t> buffer(READ_BUFFER_SIZE);
+  while (reading){
+    if (!sp.isOpen()){
+      std::this_thread::sleep_for(REOPEN_PERIOD);
+      ROS_WARN_STREAM("Serial not opened, reopening " << serial_para.port);
+      openSerial();
+      continue;
+    }
+    try{
+      // Sleep in select() until bytes arrive
+      if (!sp.waitReadable()){
+        continue;
+      }
+      size_t size = std::min(std::max<size_t>(sp.available(), 1), buffer.size());
+      size = sp.read(buffer.data(), size);
+      ros::Time stamp = ros::Time::now();
+      frameBytes(buffer.data(), size, stamp);
+    }
+    catch(std::exception &e){
+      ROS_WARN_STREAM("Serial read failed: " << e.what());
+      sp.close();
+      ROS_WARN_STREAM("Serial is closed.");
+    }
+  }
+}
 
-    // Decode data
-    sentence.sentence = data;
-    sentence.header.frame_id = "/drivers/serial_info";
-    sentence.header.stamp = ros::Time::now();
+void SerialCom::frameBytes(const uint8_t *data, size_t size, const ros::Time &stamp){
+  {
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    stats.bytes += size;
   }
-  else{
-    ROS_WARN_STREAM("Serial not opened.");
-    sp.close();
-    ROS_WARN_STREAM("Serial is closed.");
+  for (size_t i = 0; i < size; i++){
+    char c = static_cast<char>(data[i]);
+    if (c == '\n'){
+      if (line_overflow){
+        std::lock_guard<std::mutex> lock(stats_mutex);
+        stats.dropped++;
+      }
+      else if (!line.empty()){
+        publishLine(stamp);
+      }
+      line.clear();
+      line_overflow = false;
+    }
+    else if (c == ' ' || c == '\r'){
+      // blanks are never part of a sentence
+      continue;
+    }
+    else if (line.size() < MAX_SENTENCE_LENGTH){
+      line.push_back(c);
+    }
+    else{
+      line_overflow = true;
+    }
   }
 }
 
-std::string& SerialCom::trim(std::string &s){
-	if (!s.empty()) {
-		s = s.erase(0, s.find_first_not_of(" "));
-		s = s.erase(s.find_last_not_of(" ") + 1);
-	}
-	else {
-		return s;
-	}
-	// blank inside string 
-	if (!s.empty()) {
-		std::string::size_type i = 0;
-		while ( (i = s.find(' ')) != std::string::npos ) {
-			s.erase(i, 1);
-		}
-	}
-	else {
-		return s;
-	}
-	return s;
+void SerialCom::publishLine(const ros::Time &stamp){
+  sentence.header.stamp = stamp;
+  sentence.sentence.assign(line);
+  if (sentence_callback){
+    sentence_callback(sentence);
+  }
+
+  double latency = (ros::Time::now() - stamp).toSec();
+  std::lock_guard<std::mutex> lock(stats_mutex);
+  stats.sentences++;
+  stats.latency_sum += latency;
+  stats.latency_max = std::max(stats.latency_max, latency);
 }
 
-// TODO:whether add function to shut the port down
 }
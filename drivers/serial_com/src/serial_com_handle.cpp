@@ -21,6 +21,7 @@
 #include "serial_com_handle.hpp"
 #include "register.h"
 #include <chrono>
+#include <functional>
 
 namespace ns_serial_com {
 
@@ -29,11 +30,14 @@ SerialComHandle::SerialComHandle(ros::NodeHandle &nodeHandle) :
     nodeHandle_(nodeHandle),
     serial_com_(nodeHandle) {
   ROS_INFO("Constructing Handle");
+  last_report_time_ = ros::Time::now();
   loadParameters();
   serial_com_.setSerialParameters(serial_para_);
   serial_com_.initializeSerial();
   subscribeToTopics();
   publishToTopics();
+  // Sentences are published from the reader thread as they arrive
+  serial_com_.startReading(std::bind(&SerialComHandle::serialInfoCallback, this, std::placeholders::_1));
 }
 
 // Getters
@@ -62,19 +66,27 @@ void SerialComHandle::subscribeToTopics() {// No topics to subscribe
 
 void SerialComHandle::publishToTopics() {
   ROS_INFO("publish to topics");
-  serialInfoPublisher_ = nodeHandle_.advertise<nmea_msgs::Sentence>(serial_info_topic_name_, 1);
+  serialInfoPublisher_ = nodeHandle_.advertise<nmea_msgs::Sentence>(serial_info_topic_name_, 32);
 }
 
 void SerialComHandle::run() {
-  //std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
-  serial_com_.runAlgorithm();
-  // std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
-  // double time_round = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1).count();
-  // std::cout << "time cost = " << time_round << ", frequency = " << 1 / time_round << std::endl;
-  sendMsg();
+  // Report the reader statistics once per second
+  ros::Time now = ros::Time::now();
+  if ((now - last_report_time_).toSec() < 1.0){
+    return;
+  }
+  last_report_time_ = now;
+  SerialStats stats = serial_com_.takeStats();
+  if (stats.sentences == 0){
+    ROS_WARN("No serial sentence received.");
+    return;
+  }
+  ROS_INFO("Serial: %lu sentences, %lu bytes, %lu dropped, receive to publish latency mean %.3f ms, max %.3f ms.",
+           (unsigned long)stats.sentences, (unsigned long)stats.bytes, (unsigned long)stats.dropped,
+           stats.latency_sum / stats.sentences * 1e3, stats.latency_max * 1e3);
 }
 
-void SerialComHandle::sendMsg() {
-  serialInfoPublisher_.publish(serial_com_.getSerialInfo());
+void SerialComHandle::serialInfoCallback(const nmea_msgs::Sentence &msg) {
+  serialInfoPublisher_.publish(msg);
+}
 }
-}
\ No newline at end of file
@@ -0,0 +1,80 @@
+#ifndef EKF_LOCALIZER_HPP
+#define EKF_LOCALIZER_HPP
+
+#include "nav_msgs/Odometry.h"
+#include "common_msgs/ChassisState.h"
+#include "amathutils_lib/time_delay_kalman_filter_n.hpp"
+
+namespace ns_ekf_localizer {
+
+struct Para {
+  double predict_frequency;         // [Hz], the node rate
+  int extend_state_step;            // longest measurement delay kept, in prediction steps
+  double gps_additional_delay;      // [s] receiver latency not covered by the header stamp
+  double gps_pose_stddev;           // [m]
+  double gps_yaw_stddev;            // [rad]
+  double gps_gate_dist;             // mahalanobis distance beyond which a fix is rejected
+  int gps_max_rejects;              // consecutive rejected fixes before the filter restarts
+  double chassis_speed_stddev;      // [m/s]
+  double chassis_yaw_rate_stddev;   // [rad/s]
+  double proc_stddev_yaw_c;         // [rad/s]
+  double proc_stddev_vx_c;          // [m/s^2]
+  double proc_stddev_wz_c;          // [rad/s^2]
+};
+
+/*
+  Pose estimator on a kinematic model with state (x, y, yaw, vx, wz). The
+  state is predicted at the node rate, chassis speed and yaw rate are fused
+  at the step they were measured and gps poses at the step they were stamped,
+  which is several steps in the past by the time they arrive. The published
+  pose is the one at the latest prediction step.
+*/
+class EkfLocalizer {
+
+ public:
+  // Constructor
+  EkfLocalizer(ros::NodeHandle &nh);
+
+  // Getters
+  const nav_msgs::Odometry &getEkfPose() const;
+  bool isInitialized() const;
+
+  // Setters
+  void setParameters(const Para &msg);
+  void setGpsPose(const nav_msgs::Odometry &msg);
+  void setChassisState(const common_msgs::ChassisState &msg);
+
+  // Methods
+  void runAlgorithm();
+
+ private:
+  enum IDX { X = 0, Y = 1, YAW = 2, VX = 3, WZ = 4 };
+  static const int DIM_X = 5;
+
+  ros::NodeHandle &nh_;
+
+  Para para;
+  double dt;
+
+  typedef TimeDelayKalmanFilterN<DIM_X> Ekf;
+  Ekf ekf;
+  bool initialized = false;
+  int gps_rejects = 0;
+
+  bool gps_flag = false;
+  bool chassis_flag = false;
+  nav_msgs::Odometry gps_pose;
+  common_msgs::ChassisState chassis_state;
+
+  nav_msgs::Odometry ekf_pose;
+
+  void initEkf(const nav_msgs::Odometry &pose);
+  void predictKinematicsModel();
+  void measurementUpdateGpsPose(const nav_msgs::Odometry &pose);
+  void measurementUpdateChassis(const common_msgs::ChassisState &msg);
+  int delayStep(const ros::Time &stamp, double additional_delay) const;
+  void updateEkfPose();
+};
+}
+
+#endif //EKF_LOCALIZER_HPP
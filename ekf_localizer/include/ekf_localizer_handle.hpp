@@ -0,0 +1,64 @@
+/*
+    Formula Student Driverless Project (FSD-Project).
+    Copyright (c) 2019:
+     - chentairan <killasipilin@gmail.com>
+
+    FSD-Project is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FSD-Project is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FSD-Project.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef EKF_LOCALIZER_HANDLE_HPP
+#define EKF_LOCALIZER_HANDLE_HPP
+
+#include "ekf_localizer.hpp"
+
+namespace ns_ekf_localizer {
+
+class EkfLocalizerHandle {
+
+ public:
+  // Constructor
+  EkfLocalizerHandle(ros::NodeHandle &nodeHandle);
+
+  // Getters
+  int getNodeRate() const;
+
+  // Methods
+  void loadParameters();
+  void subscribeToTopics();
+  void publishToTopics();
+  void run();
+  void sendMsg();
+
+ private:
+  ros::NodeHandle nodeHandle_;
+  ros::Subscriber gpsPoseSubscriber_;
+  ros::Subscriber chassisStateSubscriber_;
+  ros::Publisher ekfPosePublisher_;
+
+  void gpsPoseCallback(const nav_msgs::Odometry &msg);
+  void chassisStateCallback(const common_msgs::ChassisState &msg);
+
+  std::string gps_pose_topic_name_;
+  std::string chassis_state_topic_name_;
+  std::string ekf_pose_topic_name_;
+
+  int node_rate_;
+
+  EkfLocalizer ekf_localizer_;
+  Para para_;
+
+};
+}
+
+#endif //EKF_LOCALIZER_HANDLE_HPP
@@ -0,0 +1,234 @@
+#include <ros/ros.h>
+#include "ekf_localizer.hpp"
+#include "amathutils_lib/amathutils.hpp"
+#include <cmath>
+
+namespace ns_ekf_localizer {
+
+namespace {
+// initial velocity uncertainty when the filter starts from a gps pose alone
+const double INIT_VX_STDDEV = 5.0;   // [m/s]
+const double INIT_WZ_STDDEV = 1.0;   // [rad/s]
+}
+
+// Constructor
+EkfLocalizer::EkfLocalizer(ros::NodeHandle &nh) : nh_(nh) {
+  ekf_pose.header.frame_id = "world";
+  ekf_pose.child_frame_id = "base_link";
+};
+
+// Getters
+const nav_msgs::Odometry &EkfLocalizer::getEkfPose() const { return ekf_pose; }
+bool EkfLocalizer::isInitialized() const { return initialized; }
+
+// Setters
+void EkfLocalizer::setParameters(const Para &msg) {
+  para = msg;
+  dt = 1.0 / para.predict_frequency;
+}
+void EkfLocalizer::setGpsPose(const nav_msgs::Odometry &msg) {
+  // localization_adapter republishes the last fix every cycle, only a new stamp is a new fix
+  if (!msg.header.stamp.isZero() && msg.header.stamp == gps_pose.header.stamp) {
+    return;
+  }
+  gps_pose = msg;
+  gps_flag = true;
+}
+void EkfLocalizer::setChassisState(const common_msgs::ChassisState &msg) {
+  chassis_state = msg;
+  chassis_flag = true;
+}
+
+// Methods
+void EkfLocalizer::runAlgorithm() {
+  if (!initialized) {
+    if (gps_flag) {
+      initEkf(gps_pose);
+      gps_flag = false;
+    }
+    return;
+  }
+
+  predictKinematicsModel();
+  if (chassis_flag) {
+    measurementUpdateChassis(chassis_state);
+    chassis_flag = false;
+  }
+  if (gps_flag) {
+    measurementUpdateGpsPose(gps_pose);
+    gps_flag = false;
+  }
+  updateEkfPose();
+}
+
+void EkfLocalizer::initEkf(const nav_msgs::Odometry &pose) {
+  Ekf::StateVector X_init = Ekf::StateVector::Zero();
+  X_init(X) = pose.pose.pose.position.x;
+  X_init(Y) = pose.pose.pose.position.y;
+  X_init(YAW) = amathutils::getPoseYawAngle(pose.pose.pose);
+  X_init(VX) = chassis_state.vehicle_speed;
+  X_init(WZ) = chassis_state.vehicle_yaw_rate;
+
+  Ekf::StateMatrix P = Ekf::StateMatrix::Zero();
+  P(X, X) = para.gps_pose_stddev * para.gps_pose_stddev;
+  P(Y, Y) = para.gps_pose_stddev * para.gps_pose_stddev;
+  P(YAW, YAW) = para.gps_yaw_stddev * para.gps_yaw_stddev;
+  P(VX, VX) = INIT_VX_STDDEV * INIT_VX_STDDEV;
+  P(WZ, WZ) = INIT_WZ_STDDEV * INIT_WZ_STDDEV;
+
+  ekf.init(X_init, P, para.extend_state_step);
+  // the pose is from its stamp, carry it forward to now so that later poses meet it at their own step
+  const int delay_step = std::min(delayStep(pose.header.stamp, para.gps_additional_delay), para.extend_state_step - 1);
+  for (int i = 0; i < delay_step; i++) {
+    predictKinematicsModel();
+  }
+  initialized = true;
+  gps_rejects = 0;
+  updateEkfPose();
+  ROS_INFO("[EKF] initialized at x: %.3f, y: %.3f, yaw: %.3f", X_init(X), X_init(Y), X_init(YAW));
+}
+
+void EkfLocalizer::predictKinematicsModel() {
+  /*
+   *  x_next   = x + vx * cos(yaw) * dt
+   *  y_next   = y + vx * sin(yaw) * dt
+   *  yaw_next = yaw + wz * dt
+   *  vx_next  = vx
+   *  wz_next  = wz
+   */
+  Ekf::StateVector X_curr;
+  ekf.getLatestX(X_curr);
+  const double yaw = X_curr(YAW);
+  const double vx = X_curr(VX);
+  const double wz = X_curr(WZ);
+
+  Ekf::StateVector X_next;
+  X_next(X) = X_curr(X) + vx * std::cos(yaw) * dt;
+  X_next(Y) = X_curr(Y) + vx * std::sin(yaw) * dt;
+  // yaw is kept continuous so that the delayed copies stay comparable, measurements are unwrapped against it
+  X_next(YAW) = yaw + wz * dt;
+  X_next(VX) = vx;
+  X_next(WZ) = wz;
+
+  Ekf::StateMatrix A = Ekf::StateMatrix::Identity();
+  A(X, YAW) = -vx * std::sin(yaw) * dt;
+  A(X, VX) = std::cos(yaw) * dt;
+  A(Y, YAW) = vx * std::cos(yaw) * dt;
+  A(Y, VX) = std::sin(yaw) * dt;
+  A(YAW, WZ) = dt;
+
+  // x and y are driven by yaw and vx only
+  Ekf::StateMatrix Q = Ekf::StateMatrix::Zero();
+  Q(YAW, YAW) = std::pow(para.proc_stddev_yaw_c * dt, 2);
+  Q(VX, VX) = std::pow(para.proc_stddev_vx_c * dt, 2);
+  Q(WZ, WZ) = std::pow(para.proc_stddev_wz_c * dt, 2);
+
+  ekf.predictWithDelay(X_next, A, Q);
+}
+
+void EkfLocalizer::measurementUpdateGpsPose(const nav_msgs::Odometry &pose) {
+  const int delay_step = delayStep(pose.header.stamp, para.gps_additional_delay);
+  if (delay_step >= para.extend_state_step) {
+    ROS_WARN_STREAM_THROTTLE(1.0, "[EKF] gps pose is " << delay_step * dt << " s old, longer than extend_state_step "
+                             << para.extend_state_step << " covers. Ignored.");
+    return;
+  }
+
+  Ekf::StateVector X_delayed;
+  Ekf::StateMatrix P_delayed;
+  ekf.getDelayedX(X_delayed, delay_step);
+  ekf.getDelayedP(P_delayed, delay_step);
+
+  const double R_pos = para.gps_pose_stddev * para.gps_pose_stddev;
+  Eigen::Vector2d d(pose.pose.pose.position.x - X_delayed(X), pose.pose.pose.position.y - X_delayed(Y));
+  Eigen::Matrix2d S = P_delayed.topLeftCorner<2, 2>() + R_pos * Eigen::Matrix2d::Identity();
+  const double mahalanobis = std::sqrt(d.dot(S.inverse() * d));
+  if (mahalanobis > para.gps_gate_dist) {
+    gps_rejects += 1;
+    ROS_WARN_STREAM_THROTTLE(1.0, "[EKF] gps pose rejected, mahalanobis distance " << mahalanobis);
+    if (gps_rejects >= para.gps_max_rejects) {
+      ROS_WARN("[EKF] %d gps poses rejected in a row, restarting from the gps pose.", gps_rejects);
+      initEkf(pose);
+    }
+    return;
+  }
+  gps_rejects = 0;
+
+  // unwrap the measured yaw against the yaw at the step it was taken
+  const double yaw_delayed = X_delayed(YAW);
+  const double yaw = yaw_delayed + amathutils::normalizeRadian(amathutils::getPoseYawAngle(pose.pose.pose) - yaw_delayed);
+
+  Eigen::Vector3d y;
+  y << pose.pose.pose.position.x, pose.pose.pose.position.y, yaw;
+
+  Eigen::Matrix<double, 3, DIM_X> C = Eigen::Matrix<double, 3, DIM_X>::Zero();
+  C(0, X) = 1.0;
+  C(1, Y) = 1.0;
+  C(2, YAW) = 1.0;
+
+  Eigen::Matrix3d R = Eigen::Matrix3d::Zero();
+  R(0, 0) = R_pos;
+  R(1, 1) = R_pos;
+  R(2, 2) = para.gps_yaw_stddev * para.gps_yaw_stddev;
+
+  ekf.updateWithDelay<3>(y, C, R, delay_step);
+  ekf_pose.pose.pose.position.z = pose.pose.pose.position.z;
+}
+
+void EkfLocalizer::measurementUpdateChassis(const common_msgs::ChassisState &msg) {
+  const int delay_step = delayStep(msg.header.stamp, 0.0);
+  if (delay_step >= para.extend_state_step) {
+    ROS_WARN_STREAM_THROTTLE(1.0, "[EKF] chassis state is " << delay_step * dt << " s old. Ignored.");
+    return;
+  }
+
+  Eigen::Vector2d y;
+  y << msg.vehicle_speed, msg.vehicle_yaw_rate;
+
+  Eigen::Matrix<double, 2, DIM_X> C = Eigen::Matrix<double, 2, DIM_X>::Zero();
+  C(0, VX) = 1.0;
+  C(1, WZ) = 1.0;
+
+  Eigen::Matrix2d R = Eigen::Matrix2d::Zero();
+  R(0, 0) = para.chassis_speed_stddev * para.chassis_speed_stddev;
+  R(1, 1) = para.chassis_yaw_rate_stddev * para.chassis_yaw_rate_stddev;
+
+  ekf.updateWithDelay<2>(y, C, R, delay_step);
+}
+
+int EkfLocalizer::delayStep(const ros::Time &stamp, double additional_delay) const {
+  if (stamp.isZero()) {
+    return 0;
+  }
+  // a stamp slightly ahead of this clock counts as current
+  const double delay = std::max((ros::Time::now() - stamp).toSec() + additional_delay, 0.0);
+  return static_cast<int>(std::round(delay / dt));
+}
+
+void EkfLocalizer::updateEkfPose() {
+  Ekf::StateVector X_latest;
+  Ekf::StateMatrix P;
+  ekf.getLatestX(X_latest);
+  ekf.getLatestP(P);
+
+  ekf_pose.header.stamp = ros::Time::now();
+  ekf_pose.pose.pose.position.x = X_latest(X);
+  ekf_pose.pose.pose.position.y = X_latest(Y);
+  ekf_pose.pose.pose.orientation = tf::createQuaternionMsgFromYaw(amathutils::normalizeRadian(X_latest(YAW)));
+  ekf_pose.twist.twist.linear.x = X_latest(VX);
+  ekf_pose.twist.twist.angular.z = X_latest(WZ);
+
+  // row-major 6x6 over (x, y, z, roll, pitch, yaw)
+  ekf_pose.pose.covariance[0] = P(X, X);
+  ekf_pose.pose.covariance[1] = P(X, Y);
+  ekf_pose.pose.covariance[5] = P(X, YAW);
+  ekf_pose.pose.covariance[6] = P(Y, X);
+  ekf_pose.pose.covariance[7] = P(Y, Y);
+  ekf_pose.pose.covariance[11] = P(Y, YAW);
+  ekf_pose.pose.covariance[30] = P(YAW, X);
+  ekf_pose.pose.covariance[31] = P(YAW, Y);
+  ekf_pose.pose.covariance[35] = P(YAW, YAW);
+  ekf_pose.twist.covariance[0] = P(VX, VX);
+  ekf_pose.twist.covariance[35] = P(WZ, WZ);
+}
+}
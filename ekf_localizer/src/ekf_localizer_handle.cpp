@@ -0,0 +1,89 @@
+#include <ros/ros.h>
+#include "ekf_localizer_handle.hpp"
+#include "register.h"
+
+namespace ns_ekf_localizer {
+
+// Constructor
+EkfLocalizerHandle::EkfLocalizerHandle(ros::NodeHandle &nodeHandle) :
+    nodeHandle_(nodeHandle),
+    ekf_localizer_(nodeHandle) {
+  ROS_INFO("Constructing Handle");
+  loadParameters();
+  ekf_localizer_.setParameters(para_);
+  subscribeToTopics();
+  publishToTopics();
+}
+
+// Getters
+int EkfLocalizerHandle::getNodeRate() const { return node_rate_; }
+
+// Methods
+void EkfLocalizerHandle::loadParameters() {
+  ROS_INFO("loading handle parameters");
+  if (!nodeHandle_.param<std::string>("gps_pose_topic_name",
+                                      gps_pose_topic_name_,
+                                      "/localization/utmpose")) {
+    ROS_WARN_STREAM("Did not load gps_pose_topic_name. Standard value is: " << gps_pose_topic_name_);
+  }
+  if (!nodeHandle_.param<std::string>("chassis_state_topic_name",
+                                      chassis_state_topic_name_,
+                                      "/chassis_state")) {
+    ROS_WARN_STREAM("Did not load chassis_state_topic_name. Standard value is: " << chassis_state_topic_name_);
+  }
+  if (!nodeHandle_.param<std::string>("ekf_pose_topic_name",
+                                      ekf_pose_topic_name_,
+                                      "/localization/ekf_pose")) {
+    ROS_WARN_STREAM("Did not load ekf_pose_topic_name. Standard value is: " << ekf_pose_topic_name_);
+  }
+  if (!nodeHandle_.param("node_rate", node_rate_, 50)) {
+    ROS_WARN_STREAM("Did not load node_rate. Standard value is: " << node_rate_);
+  }
+  para_.predict_frequency = node_rate_;
+  nodeHandle_.param("extend_state_step", para_.extend_state_step, 50);
+  nodeHandle_.param("gps_additional_delay", para_.gps_additional_delay, 0.0);
+  nodeHandle_.param("gps_pose_stddev", para_.gps_pose_stddev, 0.05);
+  nodeHandle_.param("gps_yaw_stddev", para_.gps_yaw_stddev, 0.02);
+  nodeHandle_.param("gps_gate_dist", para_.gps_gate_dist, 10.0);
+  nodeHandle_.param("gps_max_rejects", para_.gps_max_rejects, 10);
+  nodeHandle_.param("chassis_speed_stddev", para_.chassis_speed_stddev, 0.2);
+  nodeHandle_.param("chassis_yaw_rate_stddev", para_.chassis_yaw_rate_stddev, 0.02);
+  nodeHandle_.param("proc_stddev_yaw_c", para_.proc_stddev_yaw_c, 0.005);
+  nodeHandle_.param("proc_stddev_vx_c", para_.proc_stddev_vx_c, 2.0);
+  nodeHandle_.param("proc_stddev_wz_c", para_.proc_stddev_wz_c, 0.2);
+}
+
+void EkfLocalizerHandle::subscribeToTopics() {
+  ROS_INFO("subscribe to topics");
+  gpsPoseSubscriber_ =
+      nodeHandle_.subscribe(gps_pose_topic_name_, 1, &EkfLocalizerHandle::gpsPoseCallback, this);
+  chassisStateSubscriber_ =
+      nodeHandle_.subscribe(chassis_state_topic_name_, 1, &EkfLocalizerHandle::chassisStateCallback, this);
+}
+
+void EkfLocalizerHandle::publishToTopics() {
+  ROS_INFO("publish to topics");
+  ekfPosePublisher_ = nodeHandle_.advertise<nav_msgs::Odometry>(ekf_pose_topic_name_, 1);
+}
+
+void EkfLocalizerHandle::run() {
+  ekf_localizer_.runAlgorithm();
+  sendMsg();
+}
+
+void EkfLocalizerHandle::sendMsg() {
+  if (!ekf_localizer_.isInitialized()) {
+    ROS_WARN_STREAM_THROTTLE(1.0, "Waiting for " << gps_pose_topic_name_ << " to initialize the EKF...");
+    return;
+  }
+  ekfPosePublisher_.publish(ekf_localizer_.getEkfPose());
+}
+
+void EkfLocalizerHandle::gpsPoseCallback(const nav_msgs::Odometry &msg) {
+  ekf_localizer_.setGpsPose(msg);
+}
+
+void EkfLocalizerHandle::chassisStateCallback(const common_msgs::ChassisState &msg) {
+  ekf_localizer_.setChassisState(msg);
+}
+}
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include <ros/ros.h>
+
+#include "ekf_localizer.hpp"
+#include "amathutils_lib/amathutils.hpp"
+
+namespace ns_ekf_localizer {
+
+namespace {
+const double RATE = 50.0;         // [Hz]
+const double SPEED = 5.0;         // [m/s]
+const double GPS_PERIOD = 0.1;    // [s]
+const double GPS_DELAY = 0.2;     // [s] between the fix stamp and its arrival
+const double START_TIME = 1000.0; // [s] sim clock at the first cycle
+
+Para makePara() {
+  Para para;
+  para.predict_frequency = RATE;
+  para.extend_state_step = 50;
+  para.gps_additional_delay = 0.0;
+  para.gps_pose_stddev = 0.05;
+  para.gps_yaw_stddev = 0.02;
+  para.gps_gate_dist = 10.0;
+  para.gps_max_rejects = 3;
+  para.chassis_speed_stddev = 0.1;
+  para.chassis_yaw_rate_stddev = 0.01;
+  para.proc_stddev_yaw_c = 0.005;
+  para.proc_stddev_vx_c = 2.0;
+  para.proc_stddev_wz_c = 0.1;
+  return para;
+}
+
+// straight drive along x at SPEED, starting at x = 0 at START_TIME
+nav_msgs::Odometry makeGpsPose(double stamp) {
+  nav_msgs::Odometry pose;
+  pose.header.stamp = ros::Time(stamp);
+  pose.pose.pose.position.x = SPEED * (stamp - START_TIME);
+  pose.pose.pose.orientation = tf::createQuaternionMsgFromYaw(0.0);
+  return pose;
+}
+
+common_msgs::ChassisState makeChassisState(double stamp) {
+  common_msgs::ChassisState chassis;
+  chassis.header.stamp = ros::Time(stamp);
+  chassis.vehicle_speed = SPEED;
+  chassis.vehicle_yaw_rate = 0.0;
+  return chassis;
+}
+}
+
+class EkfLocalizerTestSuite : public ::testing::Test {
+ public:
+  EkfLocalizerTestSuite() : localizer(nh), republishing_localizer(nh) {}
+
+  ros::NodeHandle nh;
+  // gets every fix once
+  EkfLocalizer localizer;
+  // gets the latest fix every cycle, as localization_adapter republishes it
+  EkfLocalizer republishing_localizer;
+
+  void run(double duration) {
+    const double dt = 1.0 / RATE;
+    const int cycles = static_cast<int>(duration * RATE);
+    const int gps_cycles = static_cast<int>(GPS_PERIOD * RATE + 0.5);
+    const int delay_cycles = static_cast<int>(GPS_DELAY * RATE + 0.5);
+    nav_msgs::Odometry last_fix;
+    bool have_fix = false;
+    for (int i = 0; i <= cycles; i++) {
+      const double now = START_TIME + i * dt;
+      ros::Time::setNow(ros::Time(now));
+      localizer.setChassisState(makeChassisState(now));
+      republishing_localizer.setChassisState(makeChassisState(now));
+      // a fix taken every GPS_PERIOD arrives GPS_DELAY later
+      if (i >= delay_cycles && (i - delay_cycles) % gps_cycles == 0) {
+        last_fix = makeGpsPose(now - GPS_DELAY);
+        have_fix = true;
+        localizer.setGpsPose(last_fix);
+      }
+      if (have_fix) {
+        republishing_localizer.setGpsPose(last_fix);
+      }
+      localizer.runAlgorithm();
+      republishing_localizer.runAlgorithm();
+    }
+  }
+};
+
+TEST_F(EkfLocalizerTestSuite, delayedGpsPose) {
+  localizer.setParameters(makePara());
+  republishing_localizer.setParameters(makePara());
+  run(5.0);
+  ASSERT_TRUE(localizer.isInitialized());
+
+  // the fused pose is at the current time, not at the GPS_DELAY old stamp of the last fix
+  const nav_msgs::Odometry &pose = localizer.getEkfPose();
+  const double x_true = SPEED * (ros::Time::now().toSec() - START_TIME);
+  EXPECT_NEAR(x_true, pose.pose.pose.position.x, 0.05);
+  EXPECT_NEAR(0.0, pose.pose.pose.position.y, 0.05);
+  EXPECT_NEAR(0.0, amathutils::getPoseYawAngle(pose.pose.pose), 0.01);
+  EXPECT_NEAR(SPEED, pose.twist.twist.linear.x, 0.05);
+  EXPECT_GT(pose.pose.covariance[0], 0.0);
+  EXPECT_LT(pose.pose.covariance[0], 0.05 * 0.05);
+}
+
+TEST_F(EkfLocalizerTestSuite, republishedGpsPose) {
+  localizer.setParameters(makePara());
+  republishing_localizer.setParameters(makePara());
+  run(3.0);
+  ASSERT_TRUE(republishing_localizer.isInitialized());
+
+  // a republished fix has the stamp of the last one and must not be fused again
+  const nav_msgs::Odometry &pose = localizer.getEkfPose();
+  const nav_msgs::Odometry &republished = republishing_localizer.getEkfPose();
+  EXPECT_DOUBLE_EQ(pose.pose.pose.position.x, republished.pose.pose.position.x);
+  EXPECT_DOUBLE_EQ(pose.pose.pose.position.y, republished.pose.pose.position.y);
+  for (int i = 0; i < 36; i++) {
+    EXPECT_DOUBLE_EQ(pose.pose.covariance[i], republished.pose.covariance[i]);
+  }
+}
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  ros::init(argc, argv, "TestNode");
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,96 @@
+/*
+    Formula Student Driverless Project (FSD-Project).
+    Copyright (c) 2019:
+     - chentairan <killasipilin@gmail.com>
+
+    FSD-Project is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FSD-Project is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FSD-Project.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+// Accuracy and throughput of the batch UTM projection against the scalar
+// utm::lla2utm(), on a synthetic track around the default Gps_origin, and
+// the round trip error of the inverse projection.
+//   rosrun localization_adapter utm_benchmark [points]
+
+#include "gps2utm.hpp"
+#include "utm_batch.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+int main(int argc, char **argv) {
+  const size_t n = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+
+  // a random walk of about 10 km around the test track
+  std::mt19937 rng(42);
+  std::normal_distribution<double> step(0.0, 1e-5);
+  std::vector<double> lat(n), lon(n);
+  double la = 36.18, lo = 116.43;
+  for (size_t i = 0; i < n; i++) {
+    la += step(rng);
+    lo += step(rng);
+    lat[i] = la;
+    lon[i] = lo;
+  }
+  const utm::UtmZone zone = utm::makeUtmZone(utm::longitude_zone_number(lat[0], lon[0]));
+
+  std::vector<double> e_scalar(n), n_scalar(n), e_batch(n), n_batch(n), lat_back(n), lon_back(n);
+  sensor_msgs::NavSatFix fix;
+
+  // best of several rounds, so a busy machine does not decide the result
+  const int rounds = 5;
+  double scalar_ns = 1e300;
+  double batch_ns = 1e300;
+  double inverse_ns = 1e300;
+  for (int round = 0; round < rounds; round++) {
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < n; i++) {
+      fix.latitude = lat[i];
+      fix.longitude = lon[i];
+      geometry_msgs::Point p = utm::lla2utm(fix);
+      e_scalar[i] = p.x;
+      n_scalar[i] = p.y;
+    }
+    std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+    utm::lla2utm(zone, lat.data(), lon.data(), n, e_batch.data(), n_batch.data());
+    std::chrono::steady_clock::time_point t3 = std::chrono::steady_clock::now();
+    utm::utm2lla(zone, lat[0] >= 0, e_batch.data(), n_batch.data(), n, lat_back.data(), lon_back.data());
+    std::chrono::steady_clock::time_point t4 = std::chrono::steady_clock::now();
+    scalar_ns = std::min(scalar_ns, std::chrono::duration<double, std::nano>(t2 - t1).count() / n);
+    batch_ns = std::min(batch_ns, std::chrono::duration<double, std::nano>(t3 - t2).count() / n);
+    inverse_ns = std::min(inverse_ns, std::chrono::duration<double, std::nano>(t4 - t3).count() / n);
+  }
+
+  double max_error = 0;
+  double max_round_trip = 0;
+  for (size_t i = 0; i < n; i++) {
+    max_error = std::max(max_error, std::hypot(e_batch[i] - e_scalar[i], n_batch[i] - n_scalar[i]));
+    // degrees to metres, roughly
+    double dlat = (lat_back[i] - lat[i]) * 111320.0;
+    double dlon = (lon_back[i] - lon[i]) * 111320.0 * std::cos(lat[i] * M_PI / 180.0);
+    max_round_trip = std::max(max_round_trip, std::hypot(dlat, dlon));
+  }
+
+  printf("points: %lu, zone %d\n", (unsigned long)n, zone.number);
+  printf("scalar lla2utm: %8.1f ns/point, %10.0f points/s\n", scalar_ns, 1e9 / scalar_ns);
+  printf("batch lla2utm:  %8.1f ns/point, %10.0f points/s\n", batch_ns, 1e9 / batch_ns);
+  printf("batch utm2lla:  %8.1f ns/point, %10.0f points/s\n", inverse_ns, 1e9 / inverse_ns);
+  printf("speedup: %.1fx\n", scalar_ns / batch_ns);
+  printf("max batch - scalar difference: %.3g m, max round trip error: %.3g m\n", max_error, max_round_trip);
+  return 0;
+}
@@ -38,12 +38,12 @@ const double UTM_E4 = (UTM_E2 * UTM_E2);		// e^4
 const double UTM_E6 = (UTM_E4 * UTM_E2);		// e^6
 const double UTM_EP2 = (UTM_E2 / (1 - UTM_E2));	// e'^2
 
-nav_msgs::Odometry gps2odom(common_msgs::GpsInfo gps_info);
-geometry_msgs::Point lla2utm(sensor_msgs::NavSatFix fix);
+nav_msgs::Odometry gps2odom(const common_msgs::GpsInfo &gps_info);
+geometry_msgs::Point lla2utm(const sensor_msgs::NavSatFix &fix);
 
 char latitude_zone_letter(const double &lat);
 int longitude_zone_number(const double &lat, const double &lon);
 double deg2rad(double deg);
-geometry_msgs::Quaternion rpy2qtn(geometry_msgs::Vector3 rpy);
+geometry_msgs::Quaternion rpy2qtn(const geometry_msgs::Vector3 &rpy);
 
 }
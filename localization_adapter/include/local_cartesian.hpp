@@ -0,0 +1,41 @@
+#pragma once
+
+namespace utm{
+
+/*
+  East/north/up coordinates relative to a fixed origin. The origin's ECEF
+  position and the ECEF->ENU rotation are computed once in setOrigin();
+  per fix, sin/cos of the latitude and longitude come from the cached origin
+  values by angle addition with short polynomials of the small offsets, so
+  a fix costs one sqrt and a few dozen multiply-adds.
+
+  forwardFloat() evaluates a precomputed second order expansion around the
+  origin in single precision, within about a millimetre up to 5 km from the
+  origin.
+*/
+class LocalCartesian{
+ public:
+    LocalCartesian();
+
+    void setOrigin(double lat, double lon, double alt);
+    bool isInitialized() const;
+
+    // lat/lon in degrees, alt and the results in metres
+    void forward(double lat, double lon, double alt, double &east, double &north, double &up) const;
+    void forwardFloat(double lat, double lon, double alt, float &east, float &north, float &up) const;
+
+ private:
+    bool initialized;
+    double lat0, lon0, alt0;    // degrees, metres
+    double sin_lat0, cos_lat0, sin_lon0, cos_lon0;
+    double origin_ecef[3];
+    double rotation[3][3];      // ECEF -> ENU
+    // f_i(q) = sum_j linear[i][j] q_j + sum_{j<=k} quadratic[i][jk] q_j q_k,
+    // q = (dlat [rad], dlon [rad], dalt [m])
+    float linear[3][3];
+    float quadratic[3][6];
+
+    void toEcef(double dlat, double dlon, double alt, double ecef[3]) const;
+};
+
+}
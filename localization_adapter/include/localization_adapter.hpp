@@ -6,10 +6,19 @@
 #include "sensor_msgs/NavSatFix.h"
 #include "geometry_msgs/PoseStamped.h"
 #include "gps2utm.hpp"
+#include "utm_batch.hpp"
+#include "local_cartesian.hpp"
 #include "common_msgs/GpsInfo.h"
 
 namespace ns_localization_adapter {
 
+// Frame of the real_car pose, relative to Gps_origin
+enum class LocalFrame {
+  UTM,        // utm grid, Gps_origin subtracted
+  ENU,        // east/north/up tangent plane at Gps_origin
+  ENU_FLOAT   // ENU from a single precision expansion, for tracks within a few km
+};
+
 class Localization_adapter {
 
  public:
@@ -17,7 +26,7 @@ class Localization_adapter {
   Localization_adapter(ros::NodeHandle &nh);
 
   // Getters
-  nav_msgs::Odometry getUTMPose();
+  const nav_msgs::Odometry &getUTMPose() const;
 
   // Setters
   void setSimulationPose(const geometry_msgs::PoseStamped &msg);
@@ -25,9 +34,13 @@ class Localization_adapter {
   void setRunMode(const std::string &msg);
   void setGpsOrigin(const utm::Gps_point &msg);
   void setGpsPara(const utm::Gps_para &msg);
+  // utm, enu or enu_float
+  void setLocalFrame(const std::string &msg);
 
   // Methods
   void runAlgorithm();
+  // Converts a fix straight into the utm pose, for callers that own the gps state
+  void updateGpsPose(const common_msgs::GpsInfo &msg);
   bool rawLocFlag = false;
 
  private:
@@ -38,6 +51,9 @@ class Localization_adapter {
   utm::Gps_para para;
 
   std::string run_mode;
+  LocalFrame local_frame = LocalFrame::UTM;
+  // origin cached on the first fix, Gps_origin is given in utm
+  utm::LocalCartesian enu;
 
   common_msgs::GpsInfo gps_info;
   nav_msgs::Odometry utm_pose;
@@ -56,6 +56,7 @@ class Localization_adapterHandle {
 
   int node_rate_;
   std::string run_mode_;
+  std::string local_frame_;
 
   Localization_adapter localization_adapter_;
   utm::Gps_point origin_;
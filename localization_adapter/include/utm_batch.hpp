@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+
+namespace utm{
+
+// Constants of one UTM zone, computed once and shared by every point of a batch
+struct UtmZone{
+    int number;
+    double lon_origin;  // central meridian [rad]
+};
+
+UtmZone makeUtmZone(int number);
+
+/*
+  Batch projection of n points into one fixed zone (the zone of the first
+  point of a log keeps the track continuous across zone borders). Only
+  sin/cos of the latitude are evaluated per point, with polynomials that
+  run on SSE2, or AVX when compiled with -mavx; the rest of the series is
+  computed with multiply-adds. Matches lla2utm() to well below a millimetre.
+  Northings south of the equator get the 10000 km false northing, as in
+  lla2utm().
+*/
+void lla2utm(const UtmZone &zone, const double *lat, const double *lon, size_t n,
+             double *easting, double *northing);
+
+// Inverse projection, north selects the hemisphere of the northings
+void utm2lla(const UtmZone &zone, bool north, const double *easting, const double *northing, size_t n,
+             double *lat, double *lon);
+
+}
@@ -2,7 +2,7 @@
 
 namespace utm{
 
-nav_msgs::Odometry gps2odom(common_msgs::GpsInfo gps_info){
+nav_msgs::Odometry gps2odom(const common_msgs::GpsInfo &gps_info){
     nav_msgs::Odometry utm;
     utm.header = gps_info.header;
     utm.pose.pose.position = lla2utm(gps_info.fix);
@@ -11,7 +11,7 @@ nav_msgs::Odometry gps2odom(common_msgs::GpsInfo gps_info){
     return utm;
 }
 
-geometry_msgs::Point lla2utm(sensor_msgs::NavSatFix fix){
+geometry_msgs::Point lla2utm(const sensor_msgs::NavSatFix &fix){
 
     double lat = fix.latitude;
     double lon = fix.longitude;
@@ -63,7 +63,7 @@ geometry_msgs::Point lla2utm(sensor_msgs::NavSatFix fix){
     return position;
 }
 
-geometry_msgs::Quaternion rpy2qtn(geometry_msgs::Vector3 rpy){
+geometry_msgs::Quaternion rpy2qtn(const geometry_msgs::Vector3 &rpy){
     geometry_msgs::Quaternion qtn;
     //qtn.setRPY(rpy.x,rpy.y,rpy.z);
     //qtn.setRPY(deg2rad(rpy.x),deg2rad(rpy.y),deg2rad(rpy.z));
@@ -0,0 +1,136 @@
+#include "local_cartesian.hpp"
+#include "gps2utm.hpp"
+
+#include <cmath>
+
+namespace utm{
+
+namespace {
+
+const double DEG_TO_RAD = M_PI / 180.0;
+// beyond this offset from the origin (about 600 km) the polynomials below lose accuracy
+const double MAX_SMALL_ANGLE = 0.1;
+// central difference steps of the float expansion
+const double ANGLE_STEP = 1e-4;
+const double ALT_STEP = 10.0;
+
+// |x| <= 0.1: truncation error below 1e-16, larger offsets fall back to libm
+inline void smallSinCos(double x, double &s, double &c){
+    if (std::fabs(x) > MAX_SMALL_ANGLE){
+        s = std::sin(x);
+        c = std::cos(x);
+        return;
+    }
+    double x2 = x * x;
+    s = x * (1 - x2 / 6 * (1 - x2 / 20 * (1 - x2 / 42 * (1 - x2 / 72))));
+    c = 1 - x2 / 2 * (1 - x2 / 12 * (1 - x2 / 30 * (1 - x2 / 56)));
+}
+
+// longitude offsets are within (-2pi, 2pi)
+inline double wrapAngle(double x){
+    if (x > M_PI) return x - 2 * M_PI;
+    if (x < -M_PI) return x + 2 * M_PI;
+    return x;
+}
+
+}
+
+LocalCartesian::LocalCartesian() : initialized(false), lat0(0), lon0(0), alt0(0) {}
+
+bool LocalCartesian::isInitialized() const { return initialized; }
+
+void LocalCartesian::setOrigin(double lat, double lon, double alt){
+    lat0 = lat;
+    lon0 = lon;
+    alt0 = alt;
+    sin_lat0 = std::sin(lat * DEG_TO_RAD);
+    cos_lat0 = std::cos(lat * DEG_TO_RAD);
+    sin_lon0 = std::sin(lon * DEG_TO_RAD);
+    cos_lon0 = std::cos(lon * DEG_TO_RAD);
+    initialized = true;
+    toEcef(0, 0, alt, origin_ecef);
+
+    rotation[0][0] = -sin_lon0;
+    rotation[0][1] = cos_lon0;
+    rotation[0][2] = 0;
+    rotation[1][0] = -sin_lat0 * cos_lon0;
+    rotation[1][1] = -sin_lat0 * sin_lon0;
+    rotation[1][2] = cos_lat0;
+    rotation[2][0] = cos_lat0 * cos_lon0;
+    rotation[2][1] = cos_lat0 * sin_lon0;
+    rotation[2][2] = sin_lat0;
+
+    // Second order expansion by central differences of the exact conversion
+    const double step[3] = {ANGLE_STEP, ANGLE_STEP, ALT_STEP};
+    auto eval = [this, &step](int j, int sj, int k, int sk, double out[3]){
+        double q[3] = {0, 0, 0};
+        q[j] += sj * step[j];
+        q[k] += sk * step[k];
+        forward(lat0 + q[0] / DEG_TO_RAD, lon0 + q[1] / DEG_TO_RAD, alt0 + q[2], out[0], out[1], out[2]);
+    };
+    double fp[3], fm[3], fpp[3], fpm[3], fmp[3], fmm[3];
+    int m = 0;
+    for (int j = 0; j < 3; j++){
+        eval(j, 1, j, 0, fp);
+        eval(j, -1, j, 0, fm);
+        for (int i = 0; i < 3; i++)
+            linear[i][j] = static_cast<float>((fp[i] - fm[i]) / (2 * step[j]));
+        for (int k = j; k < 3; k++, m++){
+            if (k == j){
+                // f(0) is 0 at the origin
+                for (int i = 0; i < 3; i++)
+                    quadratic[i][m] = static_cast<float>((fp[i] + fm[i]) / (2 * step[j] * step[j]));
+                continue;
+            }
+            eval(j, 1, k, 1, fpp);
+            eval(j, 1, k, -1, fpm);
+            eval(j, -1, k, 1, fmp);
+            eval(j, -1, k, -1, fmm);
+            for (int i = 0; i < 3; i++)
+                quadratic[i][m] = static_cast<float>((fpp[i] - fpm[i] - fmp[i] + fmm[i]) / (4 * step[j] * step[k]));
+        }
+    }
+}
+
+void LocalCartesian::toEcef(double dlat, double dlon, double alt, double ecef[3]) const{
+    double sd, cd;
+    smallSinCos(dlat, sd, cd);
+    double sin_lat = sin_lat0 * cd + cos_lat0 * sd;
+    double cos_lat = cos_lat0 * cd - sin_lat0 * sd;
+    smallSinCos(dlon, sd, cd);
+    double sin_lon = sin_lon0 * cd + cos_lon0 * sd;
+    double cos_lon = cos_lon0 * cd - sin_lon0 * sd;
+
+    double N = WGS84_A / std::sqrt(1 - UTM_E2 * sin_lat * sin_lat);
+    ecef[0] = (N + alt) * cos_lat * cos_lon;
+    ecef[1] = (N + alt) * cos_lat * sin_lon;
+    ecef[2] = (N * (1 - UTM_E2) + alt) * sin_lat;
+}
+
+void LocalCartesian::forward(double lat, double lon, double alt, double &east, double &north, double &up) const{
+    double ecef[3];
+    toEcef((lat - lat0) * DEG_TO_RAD, wrapAngle((lon - lon0) * DEG_TO_RAD), alt, ecef);
+    double d[3] = {ecef[0] - origin_ecef[0], ecef[1] - origin_ecef[1], ecef[2] - origin_ecef[2]};
+    east = rotation[0][0] * d[0] + rotation[0][1] * d[1];
+    north = rotation[1][0] * d[0] + rotation[1][1] * d[1] + rotation[1][2] * d[2];
+    up = rotation[2][0] * d[0] + rotation[2][1] * d[1] + rotation[2][2] * d[2];
+}
+
+void LocalCartesian::forwardFloat(double lat, double lon, double alt, float &east, float &north, float &up) const{
+    // the offsets are small, so single precision keeps sub-millimetre resolution
+    const float q[3] = {static_cast<float>((lat - lat0) * DEG_TO_RAD),
+                        static_cast<float>(wrapAngle((lon - lon0) * DEG_TO_RAD)),
+                        static_cast<float>(alt - alt0)};
+    const float qq[6] = {q[0] * q[0], q[0] * q[1], q[0] * q[2], q[1] * q[1], q[1] * q[2], q[2] * q[2]};
+    float out[3];
+    for (int i = 0; i < 3; i++){
+        out[i] = linear[i][0] * q[0] + linear[i][1] * q[1] + linear[i][2] * q[2]
+                 + quadratic[i][0] * qq[0] + quadratic[i][1] * qq[1] + quadratic[i][2] * qq[2]
+                 + quadratic[i][3] * qq[3] + quadratic[i][4] * qq[4] + quadratic[i][5] * qq[5];
+    }
+    east = out[0];
+    north = out[1];
+    up = out[2];
+}
+
+}
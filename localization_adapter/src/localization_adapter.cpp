@@ -8,7 +8,7 @@ Localization_adapter::Localization_adapter(ros::NodeHandle &nh) : nh_(nh) {
   utm_pose.header.frame_id = "world";
 };
 // Getters
-nav_msgs::Odometry Localization_adapter::getUTMPose() { return utm_pose; }
+const nav_msgs::Odometry &Localization_adapter::getUTMPose() const { return utm_pose; }
 
 
 // Setters
@@ -37,6 +37,19 @@ void Localization_adapter::setGpsPara(const utm::Gps_para &msg){
   para = msg;
 }
 
+void Localization_adapter::setLocalFrame(const std::string &msg){
+  if (msg == "utm"){
+    local_frame = LocalFrame::UTM;
+  } else if (msg == "enu"){
+    local_frame = LocalFrame::ENU;
+  } else if (msg == "enu_float"){
+    local_frame = LocalFrame::ENU_FLOAT;
+  } else {
+    ROS_WARN_STREAM("No such local frame: " << msg << ", using utm.");
+    local_frame = LocalFrame::UTM;
+  }
+}
+
 void Localization_adapter::runAlgorithm() {
   if (rawLocFlag){
   utm_pose.header.stamp = ros::Time::now();
@@ -45,10 +58,7 @@ void Localization_adapter::runAlgorithm() {
   }
   else{
     if (run_mode == "real_car"){
-      utm_pose = utm::gps2odom(gps_info);
-      utm_pose.pose.pose.position.x -= origin.x;
-      utm_pose.pose.pose.position.y -= origin.y;
-      utm_pose.pose.pose.position.z -= origin.z;
+      updateGpsPose(gps_info);
   }
     else{
       ROS_ERROR_STREAM("No such run mode!");
@@ -59,4 +69,37 @@ void Localization_adapter::runAlgorithm() {
       ROS_WARN_STREAM("Waiting for " << run_mode <<" localization messages..."); 
   }
 }
+
+void Localization_adapter::updateGpsPose(const common_msgs::GpsInfo &msg) {
+  rawLocFlag = true;
+  if (local_frame == LocalFrame::UTM){
+    utm_pose = utm::gps2odom(msg);
+    utm_pose.pose.pose.position.x -= origin.x;
+    utm_pose.pose.pose.position.y -= origin.y;
+    utm_pose.pose.pose.position.z -= origin.z;
+    return;
+  }
+
+  if (!enu.isInitialized()){
+    // the zone of Gps_origin is taken from the first fix
+    utm::UtmZone zone = utm::makeUtmZone(utm::longitude_zone_number(msg.fix.latitude, msg.fix.longitude));
+    double lat, lon;
+    utm::utm2lla(zone, msg.fix.latitude >= 0, &origin.x, &origin.y, 1, &lat, &lon);
+    enu.setOrigin(lat, lon, origin.z);
+    ROS_INFO("ENU origin: lat %.9f, lon %.9f, alt %.3f", lat, lon, origin.z);
+  }
+  utm_pose.header = msg.header;
+  utm_pose.pose.pose.orientation = utm::rpy2qtn(msg.rpy);
+  utm_pose.twist.twist = msg.twist;
+  geometry_msgs::Point &position = utm_pose.pose.pose.position;
+  if (local_frame == LocalFrame::ENU){
+    enu.forward(msg.fix.latitude, msg.fix.longitude, msg.fix.altitude, position.x, position.y, position.z);
+  } else {
+    float east, north, up;
+    enu.forwardFloat(msg.fix.latitude, msg.fix.longitude, msg.fix.altitude, east, north, up);
+    position.x = east;
+    position.y = north;
+    position.z = up;
+  }
+}
 }
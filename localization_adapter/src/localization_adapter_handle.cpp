@@ -14,6 +14,7 @@ Localization_adapterHandle::Localization_adapterHandle(ros::NodeHandle &nodeHand
   localization_adapter_.setRunMode(run_mode_);
   localization_adapter_.setGpsOrigin(origin_);
   localization_adapter_.setGpsPara(para_);
+  localization_adapter_.setLocalFrame(local_frame_);
   subscribeToTopics();
   publishToTopics();
 }
@@ -46,6 +47,9 @@ void Localization_adapterHandle::loadParameters() {
   if (!nodeHandle_.param<std::string>("run_mode", run_mode_, "simulation")){
     ROS_WARN_STREAM("Did not load run_mode. Standard value is: " << run_mode_);
   }
+  if (!nodeHandle_.param<std::string>("local_frame", local_frame_, "utm")){
+    ROS_WARN_STREAM("Did not load local_frame. Standard value is: " << local_frame_);
+  }
   nodeHandle_.param<double>("Gps_origin/x",origin_.x,274083.3651381);
   nodeHandle_.param<double>("Gps_origin/y",origin_.y,4006502.509805);
   nodeHandle_.param<double>("Gps_origin/z",origin_.z,74.80);
@@ -0,0 +1,244 @@
+#include "utm_batch.hpp"
+#include "gps2utm.hpp"
+
+#include <cmath>
+
+#if defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace utm{
+
+namespace {
+
+// Series coefficients of the meridian arc, M = a*(M0*phi - M2*sin(2phi) + M4*sin(4phi) - M6*sin(6phi))
+const double M0 = 1 - UTM_E2 / 4 - 3 * UTM_E4 / 64 - 5 * UTM_E6 / 256;
+const double M2 = 3 * UTM_E2 / 8 + 3 * UTM_E4 / 32 + 45 * UTM_E6 / 1024;
+const double M4 = 15 * UTM_E4 / 256 + 45 * UTM_E6 / 1024;
+const double M6 = 35 * UTM_E6 / 3072;
+
+const double DEG_TO_RAD = M_PI / 180.0;
+const double RAD_TO_DEG = 180.0 / M_PI;
+
+// Vector types share one kernel through these overloads, double is the scalar tail
+inline double vset(double, double x) { return x; }
+inline double vload(double, const double *p) { return *p; }
+inline void vstore(double *p, double x) { *p = x; }
+inline double vsqrt(double x) { return std::sqrt(x); }
+// value where x < 0, else 0
+inline double vifNegative(double x, double value) { return x < 0 ? value : 0; }
+
+#ifdef __SSE2__
+struct Sse2d { __m128d v; };
+inline Sse2d operator+(Sse2d a, Sse2d b) { return {_mm_add_pd(a.v, b.v)}; }
+inline Sse2d operator-(Sse2d a, Sse2d b) { return {_mm_sub_pd(a.v, b.v)}; }
+inline Sse2d operator*(Sse2d a, Sse2d b) { return {_mm_mul_pd(a.v, b.v)}; }
+inline Sse2d operator/(Sse2d a, Sse2d b) { return {_mm_div_pd(a.v, b.v)}; }
+inline Sse2d operator+(Sse2d a, double b) { return {_mm_add_pd(a.v, _mm_set1_pd(b))}; }
+inline Sse2d operator-(Sse2d a, double b) { return {_mm_sub_pd(a.v, _mm_set1_pd(b))}; }
+inline Sse2d operator*(Sse2d a, double b) { return {_mm_mul_pd(a.v, _mm_set1_pd(b))}; }
+inline Sse2d operator/(Sse2d a, double b) { return {_mm_div_pd(a.v, _mm_set1_pd(b))}; }
+inline Sse2d operator+(double a, Sse2d b) { return {_mm_add_pd(_mm_set1_pd(a), b.v)}; }
+inline Sse2d operator-(double a, Sse2d b) { return {_mm_sub_pd(_mm_set1_pd(a), b.v)}; }
+inline Sse2d operator*(double a, Sse2d b) { return {_mm_mul_pd(_mm_set1_pd(a), b.v)}; }
+inline Sse2d operator/(double a, Sse2d b) { return {_mm_div_pd(_mm_set1_pd(a), b.v)}; }
+inline Sse2d vset(Sse2d, double x) { return {_mm_set1_pd(x)}; }
+inline Sse2d vload(Sse2d, const double *p) { return {_mm_loadu_pd(p)}; }
+inline void vstore(double *p, Sse2d x) { _mm_storeu_pd(p, x.v); }
+inline Sse2d vsqrt(Sse2d x) { return {_mm_sqrt_pd(x.v)}; }
+inline Sse2d vifNegative(Sse2d x, double value) {
+    return {_mm_and_pd(_mm_cmplt_pd(x.v, _mm_setzero_pd()), _mm_set1_pd(value))};
+}
+#endif
+
+#ifdef __AVX__
+struct Avx4d { __m256d v; };
+inline Avx4d operator+(Avx4d a, Avx4d b) { return {_mm256_add_pd(a.v, b.v)}; }
+inline Avx4d operator-(Avx4d a, Avx4d b) { return {_mm256_sub_pd(a.v, b.v)}; }
+inline Avx4d operator*(Avx4d a, Avx4d b) { return {_mm256_mul_pd(a.v, b.v)}; }
+inline Avx4d operator/(Avx4d a, Avx4d b) { return {_mm256_div_pd(a.v, b.v)}; }
+inline Avx4d operator+(Avx4d a, double b) { return {_mm256_add_pd(a.v, _mm256_set1_pd(b))}; }
+inline Avx4d operator-(Avx4d a, double b) { return {_mm256_sub_pd(a.v, _mm256_set1_pd(b))}; }
+inline Avx4d operator*(Avx4d a, double b) { return {_mm256_mul_pd(a.v, _mm256_set1_pd(b))}; }
+inline Avx4d operator/(Avx4d a, double b) { return {_mm256_div_pd(a.v, _mm256_set1_pd(b))}; }
+inline Avx4d operator+(double a, Avx4d b) { return {_mm256_add_pd(_mm256_set1_pd(a), b.v)}; }
+inline Avx4d operator-(double a, Avx4d b) { return {_mm256_sub_pd(_mm256_set1_pd(a), b.v)}; }
+inline Avx4d operator*(double a, Avx4d b) { return {_mm256_mul_pd(_mm256_set1_pd(a), b.v)}; }
+inline Avx4d operator/(double a, Avx4d b) { return {_mm256_div_pd(_mm256_set1_pd(a), b.v)}; }
+inline Avx4d vset(Avx4d, double x) { return {_mm256_set1_pd(x)}; }
+inline Avx4d vload(Avx4d, const double *p) { return {_mm256_loadu_pd(p)}; }
+inline void vstore(double *p, Avx4d x) { _mm256_storeu_pd(p, x.v); }
+inline Avx4d vsqrt(Avx4d x) { return {_mm256_sqrt_pd(x.v)}; }
+inline Avx4d vifNegative(Avx4d x, double value) {
+    return {_mm256_and_pd(_mm256_cmp_pd(x.v, _mm256_setzero_pd(), _CMP_LT_OQ), _mm256_set1_pd(value))};
+}
+#endif
+
+/*
+  sin and cos for |x| <= pi/2 (plus the small excess of the footpoint
+  latitude), Taylor series to x^21 / x^22. The truncation error is below
+  1e-17 on that range, so no range reduction is needed for latitudes.
+*/
+template <class V>
+inline void vsincos(V x, V &s, V &c) {
+    V x2 = x * x;
+    // sin: sum (-1)^k x^(2k+1) / (2k+1)!
+    V ps = vset(x, 1.0 / 51090942171709440000.0);
+    ps = ps * x2 - 1.0 / 121645100408832000.0;
+    ps = ps * x2 + 1.0 / 355687428096000.0;
+    ps = ps * x2 - 1.0 / 1307674368000.0;
+    ps = ps * x2 + 1.0 / 6227020800.0;
+    ps = ps * x2 - 1.0 / 39916800.0;
+    ps = ps * x2 + 1.0 / 362880.0;
+    ps = ps * x2 - 1.0 / 5040.0;
+    ps = ps * x2 + 1.0 / 120.0;
+    ps = ps * x2 - 1.0 / 6.0;
+    ps = ps * x2 + 1.0;
+    s = ps * x;
+    // cos: sum (-1)^k x^(2k) / (2k)!
+    V pc = vset(x, -1.0 / 1124000727777607680000.0);
+    pc = pc * x2 + 1.0 / 2432902008176640000.0;
+    pc = pc * x2 - 1.0 / 6402373705728000.0;
+    pc = pc * x2 + 1.0 / 20922789888000.0;
+    pc = pc * x2 - 1.0 / 87178291200.0;
+    pc = pc * x2 + 1.0 / 479001600.0;
+    pc = pc * x2 - 1.0 / 3628800.0;
+    pc = pc * x2 + 1.0 / 40320.0;
+    pc = pc * x2 - 1.0 / 720.0;
+    pc = pc * x2 + 1.0 / 24.0;
+    pc = pc * x2 - 0.5;
+    c = pc * x2 + 1.0;
+}
+
+template <class V>
+inline void lla2utmKernel(const UtmZone &zone, const double *lat, const double *lon,
+                          double *easting, double *northing) {
+    const double a = WGS84_A;
+    const double k0 = UTM_K0;
+    const double ep2 = UTM_EP2;
+
+    V lat_deg = vload(V(), lat);
+    V phi = lat_deg * DEG_TO_RAD;
+    V s, c;
+    vsincos(phi, s, c);
+
+    V N = a / vsqrt(1.0 - UTM_E2 * s * s);
+    V t = s / c;
+    V T = t * t;
+    V C = ep2 * c * c;
+    V A = c * (vload(V(), lon) * DEG_TO_RAD - zone.lon_origin);
+
+    // multiple angles of the meridian arc
+    V s2 = 2.0 * s * c;
+    V c2 = c * c - s * s;
+    V s4 = 2.0 * s2 * c2;
+    V c4 = c2 * c2 - s2 * s2;
+    V s6 = s4 * c2 + c4 * s2;
+    V M = a * (M0 * phi - M2 * s2 + M4 * s4 - M6 * s6);
+
+    V A2 = A * A;
+    V A3 = A2 * A;
+    V A4 = A2 * A2;
+    V e = k0 * N * (A + (1.0 - T + C) * A3 / 6.0
+                    + (5.0 - 18.0 * T + T * T + 72.0 * C - 58.0 * ep2) * A4 * A / 120.0)
+          + UTM_FE;
+    V n = k0 * (M + N * t * (A2 / 2.0 + (5.0 - T + 9.0 * C + 4.0 * C * C) * A4 / 24.0
+                             + (61.0 - 58.0 * T + T * T + 600.0 * C - 330.0 * ep2) * A4 * A2 / 720.0))
+          + vifNegative(lat_deg, UTM_FN_S);
+    vstore(easting, e);
+    vstore(northing, n);
+}
+
+template <class V>
+inline void utm2llaKernel(const UtmZone &zone, double false_northing, const double *easting,
+                          const double *northing, double *lat, double *lon) {
+    const double a = WGS84_A;
+    const double k0 = UTM_K0;
+    const double ep2 = UTM_EP2;
+    const double e2 = UTM_E2;
+    const double r = std::sqrt(1 - e2);
+    const double e1 = (1 - r) / (1 + r);
+    const double e1_2 = e1 * e1;
+    const double e1_3 = e1_2 * e1;
+    const double e1_4 = e1_2 * e1_2;
+
+    V x = vload(V(), easting) - UTM_FE;
+    V mu = (vload(V(), northing) - false_northing) / (k0 * a * M0);
+
+    // footpoint latitude
+    V sm, cm;
+    vsincos(mu, sm, cm);
+    V s2 = 2.0 * sm * cm;
+    V c2 = cm * cm - sm * sm;
+    V s4 = 2.0 * s2 * c2;
+    V c4 = c2 * c2 - s2 * s2;
+    V s6 = s4 * c2 + c4 * s2;
+    V s8 = 2.0 * s4 * c4;
+    V phi1 = mu + (3 * e1 / 2 - 27 * e1_3 / 32) * s2 + (21 * e1_2 / 16 - 55 * e1_4 / 32) * s4
+             + (151 * e1_3 / 96) * s6 + (1097 * e1_4 / 512) * s8;
+
+    V s1, c1;
+    vsincos(phi1, s1, c1);
+    V w = 1.0 - e2 * s1 * s1;
+    V N1 = a / vsqrt(w);
+    V t1 = s1 / c1;
+    V T1 = t1 * t1;
+    V C1 = ep2 * c1 * c1;
+    V D = x / (N1 * k0);
+    V D2 = D * D;
+    V D3 = D2 * D;
+    V D4 = D2 * D2;
+
+    // N1 * tan(phi1) / R1 with R1 = N1 * (1 - e2) / w
+    V q = t1 * w / (1 - e2);
+    V phi = phi1 - q * (D2 / 2.0
+                        - (5.0 + 3.0 * T1 + 10.0 * C1 - 4.0 * C1 * C1 - 9.0 * ep2) * D4 / 24.0
+                        + (61.0 + 90.0 * T1 + 298.0 * C1 + 45.0 * T1 * T1 - 252.0 * ep2 - 3.0 * C1 * C1)
+                          * D4 * D2 / 720.0);
+    V lambda = (D - (1.0 + 2.0 * T1 + C1) * D3 / 6.0
+                + (5.0 - 2.0 * C1 + 28.0 * T1 - 3.0 * C1 * C1 + 8.0 * ep2 + 24.0 * T1 * T1) * D3 * D2 / 120.0)
+               / c1 + zone.lon_origin;
+    vstore(lat, phi * RAD_TO_DEG);
+    vstore(lon, lambda * RAD_TO_DEG);
+}
+
+#if defined(__AVX__)
+typedef Avx4d Packed;
+const size_t PACKED_WIDTH = 4;
+#elif defined(__SSE2__)
+typedef Sse2d Packed;
+const size_t PACKED_WIDTH = 2;
+#else
+typedef double Packed;
+const size_t PACKED_WIDTH = 1;
+#endif
+
+}
+
+UtmZone makeUtmZone(int number){
+    UtmZone zone;
+    zone.number = number;
+    zone.lon_origin = deg2rad((number - 1) * 6 - 180 + 3);
+    return zone;
+}
+
+void lla2utm(const UtmZone &zone, const double *lat, const double *lon, size_t n,
+             double *easting, double *northing){
+    size_t i = 0;
+    for (; i + PACKED_WIDTH <= n; i += PACKED_WIDTH)
+        lla2utmKernel<Packed>(zone, lat + i, lon + i, easting + i, northing + i);
+    for (; i < n; i++)
+        lla2utmKernel<double>(zone, lat + i, lon + i, easting + i, northing + i);
+}
+
+void utm2lla(const UtmZone &zone, bool north, const double *easting, const double *northing, size_t n,
+             double *lat, double *lon){
+    double false_northing = north ? UTM_FN_N : UTM_FN_S;
+    size_t i = 0;
+    for (; i + PACKED_WIDTH <= n; i += PACKED_WIDTH)
+        utm2llaKernel<Packed>(zone, false_northing, easting + i, northing + i, lat + i, lon + i);
+    for (; i < n; i++)
+        utm2llaKernel<double>(zone, false_northing, easting + i, northing + i, lat + i, lon + i);
+}
+
+}
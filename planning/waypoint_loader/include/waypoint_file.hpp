@@ -0,0 +1,105 @@
+/*
+    Formula Student Driverless Project (FSD-Project).
+    Copyright (c) 2019:
+     - chentairan <killasipilin@gmail.com>
+
+    FSD-Project is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FSD-Project is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FSD-Project.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef WAYPOINT_FILE_HPP
+#define WAYPOINT_FILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ns_waypoint_loader {
+
+/*
+  Binary route file, native (little endian) byte order:
+    WaypointFileHeader
+    WaypointRecord[header.count]
+  The records can be used straight from a memory mapping, no parsing needed.
+*/
+const char WAYPOINT_FILE_MAGIC[8] = {'Z', 'Y', 'W', 'P', 'B', 'I', 'N', '\0'};
+const uint32_t WAYPOINT_FILE_VERSION = 1;
+
+struct WaypointFileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t record_size;
+  uint64_t count;
+};
+
+// One row of the "frame,time,x,y,heading,v_x,v_y,yaw_rate" csv written by waypoint_saver
+struct WaypointRecord {
+  int64_t frame;
+  double time;
+  double x;
+  double y;
+  double heading;
+  double v_x;
+  double v_y;
+  double yaw_rate;
+};
+
+static_assert(sizeof(WaypointFileHeader) == 24, "unexpected WaypointFileHeader layout");
+static_assert(sizeof(WaypointRecord) == 64, "unexpected WaypointRecord layout");
+
+class WaypointFile {
+
+ public:
+  // Constructor
+  WaypointFile();
+  ~WaypointFile();
+  WaypointFile(const WaypointFile &) = delete;
+  WaypointFile &operator=(const WaypointFile &) = delete;
+
+  // Getters
+  bool isBinary() const { return binary; }
+  size_t size() const { return count; }
+  size_t fileBytes() const { return file_bytes; }
+  const WaypointRecord *data() const { return records; }
+  const std::string &getError() const { return error; }
+
+  // Methods
+  // Maps a binary route file or parses a csv one, decided by the file magic
+  bool open(const std::string &filename);
+  void close();
+
+ private:
+  bool binary;
+  size_t count;
+  size_t file_bytes;
+  const WaypointRecord *records;
+
+  // binary file mapping
+  void *map_addr;
+  size_t map_length;
+
+  // csv rows
+  std::vector<WaypointRecord> parsed;
+
+  std::string error;
+
+  bool mapBinary(int fd);
+  bool parseCsv(int fd);
+};
+
+bool writeWaypointFile(const std::string &filename, const WaypointRecord *records, size_t count);
+
+}
+
+#endif //WAYPOINT_FILE_HPP
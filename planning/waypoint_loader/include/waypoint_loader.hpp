@@ -36,8 +36,9 @@ class Waypoint_loader {
   Waypoint_loader(ros::NodeHandle &nh);
 
   // Getters
-  autoware_msgs::Lane getGlobalPath();
-  nav_msgs::Path getGlobalPathVisual();
+  autoware_msgs::LaneConstPtr getGlobalPath() const;
+  nav_msgs::PathConstPtr getGlobalPathVisual() const;
+  int getPathVersion() const;
   
   // Methods
   void loadWaypointFile(std::string filename);
@@ -48,11 +49,10 @@ class Waypoint_loader {
  private:
   ros::NodeHandle &nh_;
 
-  std::fstream waypoint_record_file;
-  int line_num;
-
-  autoware_msgs::Lane global_path;
-  nav_msgs::Path global_path_rviz;
+  // rebuilt on every load, published messages are never modified
+  autoware_msgs::LanePtr global_path;
+  nav_msgs::PathPtr global_path_rviz;
+  int path_version;
 
 };
 }
@@ -50,6 +50,7 @@ class Waypoint_loaderHandle {
   std::string waypoint_loader_visual_topic_name_;
 
   int node_rate_;
+  int published_path_version_;
   std::string waypoint_filename_;
 
   Waypoint_loader waypoint_loader_;
@@ -0,0 +1,56 @@
+/*
+    Formula Student Driverless Project (FSD-Project).
+    Copyright (c) 2019:
+     - chentairan <killasipilin@gmail.com>
+
+    FSD-Project is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FSD-Project is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FSD-Project.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+  Offline converter from the waypoint_saver csv to the binary route format:
+    rosrun waypoint_loader waypoint_converter <input.csv> <output.bin>
+*/
+
+#include "waypoint_file.hpp"
+#include <chrono>
+#include <cstdio>
+
+using ns_waypoint_loader::WaypointFile;
+
+int main(int argc, char **argv) {
+  if (argc != 3) {
+    fprintf(stderr, "usage: %s <input.csv> <output.bin>\n", argv[0]);
+    return 1;
+  }
+
+  std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+  WaypointFile input;
+  if (!input.open(argv[1])) {
+    fprintf(stderr, "failed to load %s\n", input.getError().c_str());
+    return 1;
+  }
+  if (input.isBinary()) {
+    fprintf(stderr, "%s is already a binary route file\n", argv[1]);
+    return 1;
+  }
+  if (!ns_waypoint_loader::writeWaypointFile(argv[2], input.data(), input.size())) {
+    fprintf(stderr, "failed to write %s\n", argv[2]);
+    return 1;
+  }
+  std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+  double time_round = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1).count();
+
+  printf("converted %zu waypoints from %s to %s in %.3f s\n", input.size(), argv[1], argv[2], time_round);
+  return 0;
+}
@@ -0,0 +1,201 @@
+/*
+    Formula Student Driverless Project (FSD-Project).
+    Copyright (c) 2019:
+     - chentairan <killasipilin@gmail.com>
+
+    FSD-Project is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FSD-Project is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FSD-Project.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "waypoint_file.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ns_waypoint_loader {
+// Constructor
+WaypointFile::WaypointFile() :
+    binary(false),
+    count(0),
+    file_bytes(0),
+    records(nullptr),
+    map_addr(nullptr),
+    map_length(0) {
+}
+
+WaypointFile::~WaypointFile() {
+  close();
+}
+
+// Methods
+bool WaypointFile::open(const std::string &filename) {
+  close();
+  error.clear();
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    error = "cannot open " + filename + ": " + std::strerror(errno);
+    return false;
+  }
+
+  // Binary files start with the magic, everything else is treated as csv
+  char magic[sizeof(WAYPOINT_FILE_MAGIC)] = {0};
+  bool ok;
+  if (::pread(fd, magic, sizeof(magic), 0) == sizeof(magic) &&
+      std::memcmp(magic, WAYPOINT_FILE_MAGIC, sizeof(magic)) == 0) {
+    ok = mapBinary(fd);
+  } else {
+    ok = parseCsv(fd);
+  }
+  ::close(fd);
+  if (!ok) {
+    error = filename + ": " + error;
+    close();
+  }
+  return ok;
+}
+
+void WaypointFile::close() {
+  if (map_addr != nullptr) {
+    ::munmap(map_addr, map_length);
+  }
+  map_addr = nullptr;
+  map_length = 0;
+  parsed.clear();
+  parsed.shrink_to_fit();
+  records = nullptr;
+  count = 0;
+  file_bytes = 0;
+  binary = false;
+}
+
+bool WaypointFile::mapBinary(int fd) {
+  struct stat st;
+  if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(WaypointFileHeader))) {
+    error = "truncated header";
+    return false;
+  }
+  map_length = st.st_size;
+  map_addr = ::mmap(nullptr, map_length, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (map_addr == MAP_FAILED) {
+    map_addr = nullptr;
+    error = std::string("mmap failed: ") + std::strerror(errno);
+    return false;
+  }
+
+  const WaypointFileHeader *header = static_cast<const WaypointFileHeader *>(map_addr);
+  if (header->version != WAYPOINT_FILE_VERSION || header->record_size != sizeof(WaypointRecord)) {
+    error = "unsupported version " + std::to_string(header->version) +
+            " / record size " + std::to_string(header->record_size);
+    return false;
+  }
+  if (header->count > (map_length - sizeof(WaypointFileHeader)) / sizeof(WaypointRecord)) {
+    error = "truncated records, expected " + std::to_string(header->count);
+    return false;
+  }
+  ::madvise(map_addr, map_length, MADV_SEQUENTIAL);
+
+  binary = true;
+  count = header->count;
+  file_bytes = map_length;
+  records = reinterpret_cast<const WaypointRecord *>(static_cast<const char *>(map_addr) + sizeof(WaypointFileHeader));
+  return true;
+}
+
+bool WaypointFile::parseCsv(int fd) {
+  // Read the whole file at once, strtod needs the trailing '\0'
+  std::string buffer;
+  char chunk[1 << 16];
+  ssize_t n;
+  while ((n = ::read(fd, chunk, sizeof(chunk))) > 0) {
+    buffer.append(chunk, n);
+  }
+  if (n < 0) {
+    error = std::string("read failed: ") + std::strerror(errno);
+    return false;
+  }
+
+  const char *p = buffer.c_str();
+  const char *end = p + buffer.size();
+
+  // skip the header line
+  p = static_cast<const char *>(std::memchr(p, '\n', end - p));
+  p = (p == nullptr) ? end : p + 1;
+
+  while (p < end) {
+    const char *line_end = static_cast<const char *>(std::memchr(p, '\n', end - p));
+    if (line_end == nullptr) {
+      line_end = end;
+    }
+    if (line_end - p > 1 || (line_end - p == 1 && *p != '\r')) {
+      /*
+         0- 3: frame,time,x,y,
+         4- 7: heading,v_x,v_y,yaw_rate
+         missing or malformed fields read as 0, extra columns are ignored
+      */
+      double fields[8] = {0};
+      const char *q = p;
+      for (int i = 0; i < 8 && q < line_end; i++) {
+        char *next;
+        fields[i] = std::strtod(q, &next);
+        if (next == q) {
+          fields[i] = 0;
+        }
+        q = static_cast<const char *>(std::memchr(q, ',', line_end - q));
+        if (q == nullptr) {
+          break;
+        }
+        q += 1;
+      }
+      WaypointRecord r;
+      r.frame = static_cast<int64_t>(fields[0]);
+      r.time = fields[1];
+      r.x = fields[2];
+      r.y = fields[3];
+      r.heading = fields[4];
+      r.v_x = fields[5];
+      r.v_y = fields[6];
+      r.yaw_rate = fields[7];
+      parsed.push_back(r);
+    }
+    p = line_end + 1;
+  }
+
+  binary = false;
+  count = parsed.size();
+  file_bytes = buffer.size();
+  records = parsed.data();
+  return true;
+}
+
+bool writeWaypointFile(const std::string &filename, const WaypointRecord *records, size_t count) {
+  FILE *file = fopen(filename.c_str(), "wb");
+  if (file == nullptr) {
+    return false;
+  }
+  WaypointFileHeader header;
+  std::memcpy(header.magic, WAYPOINT_FILE_MAGIC, sizeof(header.magic));
+  header.version = WAYPOINT_FILE_VERSION;
+  header.record_size = sizeof(WaypointRecord);
+  header.count = count;
+  bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+            (count == 0 || fwrite(records, sizeof(WaypointRecord), count, file) == count);
+  ok = (fclose(file) == 0) && ok;
+  return ok;
+}
+
+}
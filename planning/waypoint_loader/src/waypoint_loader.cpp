@@ -19,17 +19,22 @@
 
 #include <ros/ros.h>
 #include "waypoint_loader.hpp"
+#include "waypoint_file.hpp"
 #include <sstream>
+#include <chrono>
 
 namespace ns_waypoint_loader {
 // Constructor
-Waypoint_loader::Waypoint_loader(ros::NodeHandle &nh) : nh_(nh) {
-    line_num = -1;
+Waypoint_loader::Waypoint_loader(ros::NodeHandle &nh) : nh_(nh),
+    global_path(new autoware_msgs::Lane),
+    global_path_rviz(new nav_msgs::Path) {
+    path_version = 0;
 };
 
 // Getters
-autoware_msgs::Lane Waypoint_loader::getGlobalPath() {return global_path;}
-nav_msgs::Path Waypoint_loader::getGlobalPathVisual() {return global_path_rviz;}
+autoware_msgs::LaneConstPtr Waypoint_loader::getGlobalPath() const {return global_path;}
+nav_msgs::PathConstPtr Waypoint_loader::getGlobalPathVisual() const {return global_path_rviz;}
+int Waypoint_loader::getPathVersion() const {return path_version;}
 
 // Methods
 /*
@@ -80,58 +85,69 @@ void Waypoint_loader::loadWaypointFile(std::string filename){
 */
 void Waypoint_loader::loadWaypointFile(std::string filename){
     // Initialization
-    global_path.header.frame_id = "world";
-    global_path.waypoints.clear();
-    global_path_rviz.header.frame_id = "world";
-    global_path_rviz.poses.clear();
+    autoware_msgs::LanePtr path(new autoware_msgs::Lane);
+    nav_msgs::PathPtr path_rviz(new nav_msgs::Path);
+    path->header.frame_id = "world";
+    path_rviz->header.frame_id = "world";
 
-    waypoint_record_file.open(filename.c_str(),std::ios::in);
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
     ROS_INFO("open file [%s]",filename.c_str());
-    char linestr[500] = {0};
-    waypoint_record_file.getline(linestr, 500);
-    while (waypoint_record_file.getline(linestr, 500)){
-        line_num += 1;
-        if (line_num == 0){
-            continue;
-        }
-        std::stringstream ss(linestr);
-        std::string csvdata[8];
-        for (int i = 0; i < 8; i++) {
-            char tempdata[500] = {0};
-            ss.getline(tempdata, 500, ',');
-            csvdata[i] = std::string(tempdata);
-        }   
-        double x,y,heading,v_x,v_y,yaw_rate;
-
-        x = atof(csvdata[2].data());
-        y = atof(csvdata[3].data());
-        heading = atof(csvdata[4].data());
-        v_x = atof(csvdata[5].data());
-        v_y = atof(csvdata[6].data());
-        yaw_rate = atof(csvdata[7].data());
+    WaypointFile waypoint_file;
+    if (!waypoint_file.open(filename)){
+        ROS_ERROR("Failed to load path file %s", waypoint_file.getError().c_str());
+        return;
+    }
+
+    const WaypointRecord *records = waypoint_file.data();
+    size_t record_num = waypoint_file.size();
+    path->waypoints.reserve(record_num);
+    path_rviz->poses.reserve(record_num);
+    ros::Time stamp = ros::Time::now();
+    // the first recorded row is skipped, as the csv loader always did
+    for (size_t i = 1; i < record_num; i++){
+        const WaypointRecord &r = records[i];
 
         autoware_msgs::Waypoint point;
-        point.pose.pose.position.x = x;
-        point.pose.pose.position.y = y;
+        point.pose.pose.position.x = r.x;
+        point.pose.pose.position.y = r.y;
         point.pose.pose.position.z = 0;
 
-        point.pose.pose.orientation = tf::createQuaternionMsgFromYaw(heading);
+        point.pose.pose.orientation = tf::createQuaternionMsgFromYaw(r.heading);
         
-        point.twist.twist.linear.x = v_x;
-        point.twist.twist.linear.y = v_y;
-        point.twist.twist.angular.z = yaw_rate;
+        point.twist.twist.linear.x = r.v_x;
+        point.twist.twist.linear.y = r.v_y;
+        point.twist.twist.angular.z = r.yaw_rate;
 
-        global_path.waypoints.push_back(point);
+        path->waypoints.push_back(point);
 
         // visualization : convert to Path msgs
         geometry_msgs::PoseStamped pose;
 
-        pose.header.stamp = ros::Time::now();
+        pose.header.stamp = stamp;
         pose.pose = point.pose.pose;
 
-        global_path_rviz.poses.push_back(pose);  
+        path_rviz->poses.push_back(pose);  
+    }
+
+    std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+    double time_round = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1).count();
+    double megabytes = waypoint_file.fileBytes() / 1e6;
+    ROS_INFO("Loaded %s path file: %lu waypoints, %.2f MB in %.3f ms (%.1f MB/s, %.0f waypoints/s).",
+             waypoint_file.isBinary() ? "binary" : "csv", record_num, megabytes, time_round * 1e3,
+             time_round > 0 ? megabytes / time_round : 0.0, time_round > 0 ? record_num / time_round : 0.0);
+
+    // Bump the version so that the handle republishes. The increment subscribers see is unique
+    // to this load: a restarted loader starts at version 1 again and must not repeat its predecessor
+    path_version += 1;
+    uint64_t load_key = ros::WallTime::now().toNSec() ^ (static_cast<uint64_t>(path_version) * 0x9E3779B97F4A7C15ull);
+    path->increment = static_cast<int32_t>(load_key ^ (load_key >> 32));
+    if (path->increment == 0){
+        path->increment = 1;    // 0 means unversioned
     }
-    waypoint_record_file.close();
+    path->header.stamp = stamp;
+    global_path = path;
+    global_path_rviz = path_rviz;
+    ROS_INFO("global path length is: %lu, version: %d, increment: %d", global_path->waypoints.size(), path_version, path->increment);
 
 }
 
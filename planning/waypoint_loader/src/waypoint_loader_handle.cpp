@@ -29,6 +29,7 @@ Waypoint_loaderHandle::Waypoint_loaderHandle(ros::NodeHandle &nodeHandle) :
     nodeHandle_(nodeHandle),
     waypoint_loader_(nodeHandle) {
   ROS_INFO("Constructing Handle");
+  published_path_version_ = 0;
   loadParameters();
 
   waypoint_loader_.loadWaypointFile(waypoint_filename_);
@@ -73,8 +74,9 @@ void Waypoint_loaderHandle::subscribeToTopics() {
 
 void Waypoint_loaderHandle::publishToTopics() {
   ROS_INFO("publish to topics");
-  waypoint_loaderStatePublisher_ = nodeHandle_.advertise<autoware_msgs::Lane>(waypoint_loader_state_topic_name_, 1);
-  waypoint_loaderVisualPublisher_ = nodeHandle_.advertise<nav_msgs::Path>(waypoint_loader_visual_topic_name_,1);
+  // Latched, late subscribers still get the last path
+  waypoint_loaderStatePublisher_ = nodeHandle_.advertise<autoware_msgs::Lane>(waypoint_loader_state_topic_name_, 1, true);
+  waypoint_loaderVisualPublisher_ = nodeHandle_.advertise<nav_msgs::Path>(waypoint_loader_visual_topic_name_, 1, true);
 }
 
 void Waypoint_loaderHandle::run() {
@@ -91,7 +93,13 @@ void Waypoint_loaderHandle::run() {
 }
 
 void Waypoint_loaderHandle::sendMsg() {
+  // Publish only when the path was (re)loaded
+  if (waypoint_loader_.getPathVersion() == published_path_version_){
+    return;
+  }
   waypoint_loaderStatePublisher_.publish(waypoint_loader_.getGlobalPath());
   waypoint_loaderVisualPublisher_.publish(waypoint_loader_.getGlobalPathVisual());
+  published_path_version_ = waypoint_loader_.getPathVersion();
+  ROS_INFO("Published global path version %d.", published_path_version_);
 }
 }
\ No newline at end of file
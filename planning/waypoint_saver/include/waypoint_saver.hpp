@@ -24,6 +24,7 @@
 #include "nav_msgs/Odometry.h"
 #include "nav_msgs/Odometry.h"
 #include "tf/transform_datatypes.h"
+#include "async_logger/async_writer.h"
 #include <sstream>
 #include <string>
 #include <fstream>
@@ -62,7 +63,7 @@ class Wp_saver {
 
   Para para;
   
-  std::fstream record_file;
+  async_logger::AsyncWriter record_file;
   int frame;
 
   bool open_file_flag;
@@ -7,12 +7,14 @@ namespace ns_waypoint_saver {
 Wp_saver::Wp_saver(ros::NodeHandle &nh) : nh_(nh) {
   cur_pose.pose.pose.position.x = 0.0;
   recorded_pose.pose.pose.position.x = 0.0;
+  open_file_flag = false;
   // record_file.close();
 };
 
 Wp_saver::~Wp_saver(){
   record_file.close();
-  ROS_INFO("Record file closed.");
+  ROS_INFO("Record file closed, rows written: %lu, dropped: %lu.",
+           (unsigned long)record_file.getWrittenRows(), (unsigned long)record_file.getDroppedRows());
 }
 
 // Getters
@@ -26,7 +28,6 @@ void Wp_saver::setParameters(Para msg){
 }
 
 void Wp_saver::openRecordFile(){
-  record_file.open(para.waypoint_filename, std::ios::out);
   std::string header;
   if(para.record_mode == 0){
     // record for path tracking
@@ -35,7 +36,9 @@ void Wp_saver::openRecordFile(){
   else{
     header = "frame,time,x,y,heading,v_x,v_y,yaw_rate,a_x,distance,pedal_acc,pedal_brake";
   }
-  record_file << header << std::endl;
+  if (!record_file.open(para.waypoint_filename, header)){
+    ROS_WARN("[Waypoint Saver] Failed to create record file %s.", para.waypoint_filename.c_str());
+  }
   frame = 0;
   ROS_INFO("[Waypoint Saver] Record file created.");
   open_file_flag = true;
@@ -73,31 +76,25 @@ inline double Wp_saver::distance_compute(nav_msgs::Odometry msg1, nav_msgs::Odom
 }
 
 void Wp_saver::write2File(nav_msgs::Odometry msg) {
-  using namespace std;  
-
-  string frame_s = to_string(frame);
-  ros::Time timestamp = msg.header.stamp;
-  string time = to_string(timestamp.toSec());
-  string x = to_string(msg.pose.pose.position.x);
-  string y = to_string(msg.pose.pose.position.y);
-  
   tf::Quaternion quat;
   tf::quaternionMsgToTF(msg.pose.pose.orientation, quat);
   double roll, pitch, yaw;
   tf::Matrix3x3(quat).getRPY(roll, pitch, yaw);
 
-  string heading = to_string(yaw);
-  string v_x = to_string(msg.twist.twist.linear.x);
-  string v_y = to_string(msg.twist.twist.linear.y);
-  string yaw_rate = to_string(msg.twist.twist.angular.z);
-  
-  if (para.record_mode == 0){// record for path tracking 
-    record_file << frame_s + "," + time + "," + x + "," + y + "," 
-          + heading + "," + v_x  + "," + v_y  + "," + yaw_rate << endl;
-  }
-  else{ // record for virtual platoon test
-    record_file << frame + "," + time + "," + x + "," + y + "," 
-      + heading + "," + v_x  + "," + v_y  + "," + yaw_rate << endl;
+  // frame,time,x,y,heading,v_x,v_y,yaw_rate, the same columns for both record modes
+  async_logger::LogRow row;
+  row.frame = frame;
+  row.size = 0;
+  row.values[row.size++] = msg.header.stamp.toSec();
+  row.values[row.size++] = msg.pose.pose.position.x;
+  row.values[row.size++] = msg.pose.pose.position.y;
+  row.values[row.size++] = yaw;
+  row.values[row.size++] = msg.twist.twist.linear.x;
+  row.values[row.size++] = msg.twist.twist.linear.y;
+  row.values[row.size++] = msg.twist.twist.angular.z;
+  if (!record_file.push(row)){
+    ROS_WARN_THROTTLE(1.0, "[Waypoint Saver] Record queue full, %lu rows dropped.",
+                      (unsigned long)record_file.getDroppedRows());
   }
   frame += 1;
   }